@@ -0,0 +1,79 @@
+/*
+ * Reader of the results published by `ensen --publish NAME`:
+ *
+ *   run_publish_reader /ensen
+ *
+ * Prints every record with its latency (time from the publication to the
+ * copy by this process) and the temperatures of the sensors. The reader
+ * stops when nothing is published for READER_IDLE_SEC seconds.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "ensen_private.h"
+#include "io/ensen_io_publish.h"
+
+#define READER_POLL_NSEC 100000
+#define READER_IDLE_SEC  2
+
+int main(int argc, char *argv[])
+{
+    if (argc != 2)
+    {
+        fprintf(stderr, "usage: %s NAME\n", argv[0]);
+        return 1;
+    }
+
+    /* the writer may start later */
+    Publish_Reader *r = NULL;
+    const struct timespec poll = { 0, READER_POLL_NSEC };
+    for (int i = 0; (r == NULL) && (i < READER_IDLE_SEC * 1000000000L / READER_POLL_NSEC); i++)
+    {
+        if ((r = publish_reader_open(argv[1])) == NULL) nanosleep(&poll, NULL);
+    }
+    if (r == NULL)
+    {
+        fprintf(stderr, "no results published to %s\n", argv[1]);
+        return 1;
+    }
+
+    const index_t n_sensors = publish_reader_sensors(r);
+    Publish_Reading *reading = malloc(sizeof(Publish_Reading) * n_sensors);
+    Publish_Record record;
+    uint64_t next = publish_reader_head(r), n_read = 0, n_lost = 0;
+    int64_t latency_max = 0, idle_since = publish_now();
+
+    while (publish_now() - idle_since < READER_IDLE_SEC * 1000000000LL)
+    {
+        const uint64_t head = publish_reader_head(r);
+        if (next == head)
+        {
+            nanosleep(&poll, NULL);
+            continue;
+        }
+        for (; next < head; next++)
+        {
+            if (publish_read(r, next, &record, reading) != 0)
+            {
+                n_lost++;
+                continue;
+            }
+            const int64_t latency = publish_now() - record.timestamp;
+            if (latency > latency_max) latency_max = latency;
+            n_read++;
+
+            printf("frame %6lu  latency %8.1f us ", (unsigned long)record.frame, latency * 1e-3);
+            for (index_t s = 0; s < n_sensors; s++) printf(" %10.4f", reading[s].temperature);
+            printf("\n");
+        }
+        idle_since = publish_now();
+    }
+
+    printf("records: %lu read, %lu lost, maximal latency %.1f us\n",
+           (unsigned long)n_read, (unsigned long)n_lost, latency_max * 1e-3);
+
+    free(reading);
+    publish_reader_close(r);
+    return 0;
+}
@@ -9,6 +9,22 @@
   }                                       \
   gnuplot_plot_points(win, &data_points, to, title); \
 
-int test_signal(const char * conf_name);
+/* Command line options */
+typedef struct {
+  const char *config;    /* config file name */
+  bool        bench;     /* headless run as fast as possible */
+  bool        realtime;  /* real-time profile (overrides config) */
+  uint32_t    n_frames;  /* frames of benchmark (0 - number of generations from config) */
+  const char *record;    /* capture of generated frames (NULL - no recording) */
+  const char *publish;   /* shared memory ring of sensor results (NULL - no publishing) */
+  const char *metrics;   /* latency histograms dumped on exit and on SIGUSR1 (NULL - stdout, *.json - JSON) */
+  const char *replay;    /* capture processed instead of generated frames (NULL - generator) */
+  index_t     jobs;      /* workers of replay, sweep and channels (1 - serial, 0 - all processors) */
+  bool        sweep;     /* parameter sweep of [Sweep] section instead of the interrogator */
+  bool        channels;  /* all fibers of [Channels] section, headless */
+  bool        profile;   /* hardware counters of profiling regions, printed on exit */
+} Ensen_Options;
+
+int test_signal(const Ensen_Options *opt);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,182 @@
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#if HAVE_GETTEXT
+  #include <libintl.h>
+  #define _(string) gettext (string)
+#else
+  #define _(string) (string)
+#endif
+
+#include <math.h>
+
+#include "ensen_bench.h"
+#include "ensen_conf.h"
+#include "ensen_data.h"
+#include "ensen_exp.h"
+#include "ensen_metrics.h"
+#include "ensen_search.h"
+
+#include "thread/ensen_thread_rt.h"
+#include "io/ensen_io_capture.h"
+
+#include "mem/ensen_mem_guarded.h"
+
+int
+bench_signal(const Ensen_Options *opt)
+{
+  const char *conf_name = opt->config;
+  uint32_t n_frames = opt->n_frames;
+  dictionary *ini = config_load(conf_name);
+  if (ini == NULL)
+  {
+    fprintf(stderr, _("cannot parse file: %s\n"), conf_name);
+    return -1;
+  }
+
+  Signal_Parameters conf;
+  Points data, data_temp;
+  Sensor_Bank sensors;
+  Searcher searcher;
+  Peaks peaks;
+
+  config_parameters_set(&conf, ini);
+  if (opt->realtime) conf.rt.apply = 1;
+  if (n_frames == 0) n_frames = conf.generation_max + 1;
+
+  PointsArrays data_arrays = { &data, &data_temp };
+  data_arrays_set(conf, data_arrays);
+  if (sensor_bank_init(&sensors, conf.search.peaks_real_number, conf.history, conf.temp.room) != 0)
+  {
+    fprintf(stderr, _("wrong number of sensors: %d\n"), conf.search.peaks_real_number);
+    MEM_freeN(data_temp.y);
+    MEM_freeN(data_temp.x);
+    MEM_freeN(data.y);
+    MEM_freeN(data.x);
+    MEM_freeN(conf.peak);
+    config_freedict(ini);
+    return -1;
+  }
+  Calibration *calibration = NULL;
+  if (config_calibration_load(ini, &conf, &calibration) != 0)
+  {
+    sensor_bank_free(&sensors);
+    MEM_freeN(data_temp.y);
+    MEM_freeN(data_temp.x);
+    MEM_freeN(data.y);
+    MEM_freeN(data.x);
+    MEM_freeN(conf.peak);
+    config_freedict(ini);
+    return -1;
+  }
+  sensor_bank_calibrate(&sensors, calibration);
+  searcher_init(&searcher, &conf, &data.grid);
+  peaks.peak = MEM_malloc_arrayN(conf.search.peaks_array_number, sizeof(Peak), "bench_signal: peaks.peak array");
+  peaks.total_number = 0;
+
+  /* latency histograms of the stages (no memory per frame) */
+  Metrics metrics;
+  metrics_init(&metrics, opt->metrics);
+
+  const data_t delta_temp = (conf.temp.apply) ? (conf.temp.max - conf.temp.room)/(conf.generation_max/conf.temp.tick) : 0.f;
+  data_t temp_gen = conf.temp.room;
+
+  /* the temperature ramp of config is repeated, so peaks stay inside the frame for any number of frames */
+  const uint32_t ramp = conf.generation_max + 1;
+  data_t *position_room = MEM_malloc_arrayN(conf.n_peaks, sizeof(data_t), "bench_signal: position_room");
+  for (index_t i = 0; i < conf.n_peaks; i++) position_room[i] = conf.peak[i].position;
+
+  init_rnd();
+  Exp_Generator *generator = exp_generator_new(conf.n_points);
+  generator->broaden = &metrics.stage[METRIC_BROADEN];
+  Capture_Writer *record = NULL;
+  if ((opt->record != NULL) && ((record = capture_writer_open(opt->record, &data.grid, CAPTURE_FLOAT64)) == NULL))
+  {
+    fprintf(stderr, _("cannot record frames to %s\n"), opt->record);
+  }
+  Publisher *publish = NULL;
+  if ((opt->publish != NULL) && ((publish = publisher_open(opt->publish, sensors.n_sensors, DATA_PUBLISH_RECORDS)) == NULL))
+  {
+    fprintf(stderr, _("cannot publish results to %s\n"), opt->publish);
+  }
+  realtime_enter(&conf.rt, true);
+
+  size_t allocations = 0;
+  const double start_time = get_run_time();
+  for (uint32_t i_gen = 0; i_gen < n_frames; i_gen++)
+  {
+    if (i_gen == 1) allocations = MEM_get_memory_allocations();
+
+    const double frame_start = get_run_time();
+    const data_t peak_position_ideal = conf.peak[0].position;
+    if ((i_gen % ramp == 0) && (i_gen > 0))
+    {
+      for (index_t i = 0; i < conf.n_peaks; i++) conf.peak[i].position = position_room[i];
+    }
+    if ((conf.temp.apply) & (fmod(i_gen % ramp, conf.temp.tick) <= 1.0e-14))
+    {
+      for (index_t i = 0; i < conf.n_peaks; i++) conf.peak[i].position += delta_temp * conf.temp.coefficient;
+    }
+    data_clear(data.y, conf.n_points);
+    signal_generate_exp(generator, &data, conf.n_peaks, conf.peak, conf.noise, conf.n_points);
+    if ((record != NULL) && (capture_writer_append(record, data.y) != 0)) /* timed as generation */
+    {
+      fprintf(stderr, _("cannot record frame %u, recording is stopped\n"), i_gen);
+      capture_writer_close(record);
+      record = NULL;
+    }
+
+    double t = metrics_stage(&metrics, METRIC_GENERATE, frame_start);
+    searcher_smooth(&searcher, &conf, data.y, data.y, i_gen);
+    t = metrics_stage(&metrics, METRIC_SMOOTH, t);
+    searcher_find(&searcher, &conf, data.y, i_gen, &peaks);
+    t = metrics_stage(&metrics, METRIC_SEARCH, t);
+
+    sensor_bank_update(&sensors, &peaks, &data.grid, conf.temp.coefficient);
+    if (publish != NULL) data_publish(publish, i_gen, &sensors, &peaks, data.y, conf.n_points); /* timed as temperature */
+    if (i_gen > 0)
+    {
+      temp_gen += (conf.peak[0].position - peak_position_ideal)/conf.temp.coefficient;
+      sensor_bank_deviation(&sensors, temp_gen);
+    }
+    metrics_stage(&metrics, METRIC_TEMPERATURE, t);
+    metrics_stage(&metrics, METRIC_FRAME, frame_start);
+    metrics_poll(&metrics);
+  }
+  const double total_time = get_run_time() - start_time;
+  allocations = (n_frames > 1) ? MEM_get_memory_allocations() - allocations : 0;
+  realtime_leave(&conf.rt);
+
+  /* Report */
+  printf(_("BENCHMARK: %u frames in %f sec: %.1f frames/s\n"), n_frames, total_time, n_frames / total_time);
+  metrics_dump(&metrics);
+  printf(_("BENCHMARK: heap allocations after the first frame: %zu\n"), allocations);
+  if ((searcher.adaptive != NULL) && (searcher.adaptive->frames > 0))
+  {
+    const Smooth_Adaptive *a = searcher.adaptive;
+    printf(_("BENCHMARK: adaptive smoothing: %.2f passes per frame (config: %d), last frame: noise %f, width %d, level %d\n"),
+           (double)a->passes / a->frames, conf.smooth.level, a->noise, a->last->width, a->last->level);
+  }
+  if (sensors.dev_count > 0)
+  {
+    printf(_("BENCHMARK: temperature deviation of sensor 1: %f +- %f\n"), sensors.dev_mean[0], sqrt(sensor_bank_deviation_variance(&sensors, 0)));
+  }
+
+  MEM_freeN(position_room);
+  MEM_freeN(peaks.peak);
+  exp_generator_free(generator);
+  capture_writer_close(record);
+  publisher_close(publish, true);
+  searcher_free(&searcher);
+  sensor_bank_free(&sensors);
+  calibration_free(calibration);
+  MEM_freeN(conf.peak);
+  MEM_freeN(data.x);
+  MEM_freeN(data.y);
+  MEM_freeN(data_temp.x);
+  MEM_freeN(data_temp.y);
+  config_freedict(ini);
+
+  return 0;
+}
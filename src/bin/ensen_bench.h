@@ -0,0 +1,9 @@
+#ifndef ENSEN_BENCH_H
+#define ENSEN_BENCH_H
+
+#include "ensen_private.h"
+#include "ensen.h"
+
+int bench_signal(const Ensen_Options *opt);
+
+#endif
@@ -0,0 +1,301 @@
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#if HAVE_GETTEXT
+  #include <libintl.h>
+  #define _(string) gettext (string)
+#else
+  #define _(string) (string)
+#endif
+
+#include <math.h>
+#include <string.h>
+#include <sys/time.h>
+
+#include "ensen_channel.h"
+#include "ensen_data.h"
+
+#include "signal/ensen_benchmark.h"
+#include "thread/ensen_thread_pool.h"
+#include "thread/ensen_thread_schedule.h"
+#include "mem/ensen_mem_guarded.h"
+
+/* Steps of a tick done by the tasks (one task per channel) */
+#define CHANNEL_GENERATE 1
+#define CHANNEL_SMOOTH   2
+#define CHANNEL_SEARCH   4
+
+typedef struct {
+  Channel  *channel;
+  uint32_t  frame;
+  index_t   steps;   /* CHANNEL_* */
+} Channels_Tick;
+
+int
+channel_init(Channel *ch, const char *config, uint64_t seed, uint64_t stream)
+{
+  memset(ch, 0, sizeof(Channel));
+  if ((ch->ini = config_load(config)) == NULL) return -1;
+
+  Signal_Parameters *conf = &ch->conf;
+  config_parameters_set(conf, ch->ini);
+  if (sensor_bank_init(&ch->sensors, conf->search.peaks_real_number, conf->history, conf->temp.room) != 0)
+  {
+    MEM_freeN(conf->peak);
+    config_freedict(ch->ini);
+    return -1;
+  }
+  if (config_calibration_load(ch->ini, conf, &ch->calibration) != 0)
+  {
+    sensor_bank_free(&ch->sensors);
+    MEM_freeN(conf->peak);
+    config_freedict(ch->ini);
+    return -1;
+  }
+  sensor_bank_calibrate(&ch->sensors, ch->calibration);
+
+  ch->data.x = MEM_malloc_arrayN(conf->n_points + 1, sizeof(data_t), "channel_init: data.x");
+  ch->data.y = MEM_malloc_arrayN(conf->n_points + 1, sizeof(data_t), "channel_init: data.y");
+  grid_uniform_set(&ch->data.grid, conf->plot.x_min, conf->plot.x_max, conf->n_points);
+  grid_fill(&ch->data.grid, ch->data.x);
+
+  ch->generator = exp_generator_new(conf->n_points);
+  exp_generator_seed(ch->generator, seed, stream);
+  searcher_init(&ch->searcher, conf, &ch->data.grid);
+  ch->peaks.peak = MEM_malloc_arrayN(conf->search.peaks_array_number, sizeof(Peak), "channel_init: peaks.peak");
+  ch->peaks.total_number = 0;
+
+  ch->position_room = MEM_malloc_arrayN(conf->n_peaks, sizeof(data_t), "channel_init: position_room");
+  for (index_t i = 0; i < conf->n_peaks; i++) ch->position_room[i] = conf->peak[i].position;
+  ch->delta_temp = (conf->temp.apply && (conf->temp.tick > 0))
+                   ? (conf->temp.max - conf->temp.room)/(conf->generation_max/conf->temp.tick) : 0.f;
+  ch->temp_gen = conf->temp.room;
+
+  return 0;
+}
+
+void
+channel_free(Channel *ch)
+{
+  MEM_freeN(ch->position_room);
+  MEM_freeN(ch->peaks.peak);
+  searcher_free(&ch->searcher);
+  exp_generator_free(ch->generator);
+  sensor_bank_free(&ch->sensors);
+  calibration_free(ch->calibration);
+  MEM_freeN(ch->data.x);
+  MEM_freeN(ch->data.y);
+  MEM_freeN(ch->conf.peak);
+  config_freedict(ch->ini);
+}
+
+void
+channel_generate(Channel *ch, uint32_t frame)
+{
+  Signal_Parameters *conf = &ch->conf;
+  const uint32_t ramp = conf->generation_max + 1;
+  const data_t peak_position_ideal = conf->peak[0].position;
+
+  if ((frame % ramp == 0) && (frame > 0))
+  {
+    for (index_t i = 0; i < conf->n_peaks; i++) conf->peak[i].position = ch->position_room[i];
+  }
+  if (conf->temp.apply && (conf->temp.tick > 0) && ((frame % ramp) % conf->temp.tick == 0))
+  {
+    for (index_t i = 0; i < conf->n_peaks; i++) conf->peak[i].position += ch->delta_temp * conf->temp.coefficient;
+  }
+  if (frame > 0) ch->temp_gen += (conf->peak[0].position - peak_position_ideal)/conf->temp.coefficient;
+
+  data_clear(ch->data.y, conf->n_points);
+  signal_generate_exp(ch->generator, &ch->data, conf->n_peaks, conf->peak, conf->noise, conf->n_points);
+}
+
+void
+channel_search(Channel *ch, uint32_t frame, bool smooth)
+{
+  const Signal_Parameters *conf = &ch->conf;
+  const data_t *y = (smooth) ? searcher_smooth(&ch->searcher, conf, ch->data.y, ch->data.y, frame) : ch->data.y;
+
+  searcher_find(&ch->searcher, conf, y, frame, &ch->peaks);
+  if (ch->peaks.total_number < conf->search.peaks_real_number) ch->n_lost++;
+
+  sensor_bank_update(&ch->sensors, &ch->peaks, &ch->data.grid, conf->temp.coefficient);
+  if (frame > 0) sensor_bank_deviation(&ch->sensors, ch->temp_gen);
+}
+
+static void
+_channels_task(void *data, uint32_t task, index_t worker __UNUSED__)
+{
+  const Channels_Tick *tick = data;
+  Channel *ch = &tick->channel[task];
+
+  if (tick->steps & CHANNEL_GENERATE) channel_generate(ch, tick->frame);
+  if (tick->steps & CHANNEL_SEARCH) channel_search(ch, tick->frame, tick->steps & CHANNEL_SMOOTH);
+}
+
+/* Frames of all channels are smoothed at once as lanes of one interleaved signal */
+static void
+_channels_smooth_lanes(Channel *channel, index_t n_channels, data_t *lanes[2])
+{
+  const Signal_Parameters *conf = &channel[0].conf;
+  const index_t n = conf->n_points;
+  index_t k = 0;
+
+  for (index_t i = 0; i < n; i++)
+  {
+    for (index_t c = 0; c < n_channels; c++) lanes[0][(size_t)i * n_channels + c] = channel[c].data.y[i];
+  }
+  for (index_t pass = 0; pass < conf->smooth.level; pass++)
+  {
+    smooth_lanes(lanes[k ^ 1], lanes[k], n, n_channels, conf->smooth.width);
+    k ^= 1;
+  }
+  for (index_t i = 0; i < n; i++)
+  {
+    for (index_t c = 0; c < n_channels; c++) channel[c].data.y[i] = lanes[k][(size_t)i * n_channels + c];
+  }
+}
+
+/* Lanes need frames of the same length and fixed smoothing, and the derivative detector (the others do not smooth) */
+static bool
+_channels_lanes_apply(const Channel *channel, index_t n_channels)
+{
+  const Signal_Parameters *c0 = &channel[0].conf;
+  for (index_t c = 0; c < n_channels; c++)
+  {
+    const Signal_Parameters *conf = &channel[c].conf;
+    const Searcher *s = &channel[c].searcher;
+    if ((conf->n_points != c0->n_points) || (conf->smooth.width != c0->smooth.width) || (conf->smooth.level != c0->smooth.level)) return false;
+    if ((s->stream != NULL) || (s->cwt != NULL) || (s->xcorr != NULL) || (s->adaptive != NULL)) return false;
+  }
+  return true;
+}
+
+int
+channels_signal(const Ensen_Options *opt)
+{
+  dictionary *ini = config_load(opt->config);
+  if (ini == NULL)
+  {
+    fprintf(stderr, _("cannot parse file: %s\n"), opt->config);
+    return -1;
+  }
+
+  /* Config of every channel: list of files separated by spaces, or copies of this config */
+  char name[CHANNELS_MAX][256];
+  index_t n_channels = 0;
+  const char *list = config_getstring(ini, "channels:config", "");
+  while (n_channels < CHANNELS_MAX)
+  {
+    list += strspn(list, " \t");
+    const size_t length = strcspn(list, " \t");
+    if ((length == 0) || (length >= sizeof(name[0]))) break;
+    memcpy(name[n_channels], list, length);
+    name[n_channels++][length] = '\0';
+    list += length;
+  }
+  if (n_channels == 0)
+  {
+    const int number = config_getint(ini, "channels:number", 1);
+    for (; (n_channels < number) && (n_channels < CHANNELS_MAX); n_channels++) snprintf(name[n_channels], sizeof(name[0]), "%s", opt->config);
+  }
+  if (n_channels == 0)
+  {
+    fprintf(stderr, _("no channels in %s\n"), opt->config);
+    config_freedict(ini);
+    return -1;
+  }
+  const bool lanes_requested = config_getint(ini, "channels:lanes", 0);
+  const index_t frequency = config_getint(ini, "generation:frequency", 0);
+  const uint32_t n_frames = (opt->n_frames > 0) ? opt->n_frames : (uint32_t)(config_getint(ini, "generation:number", 0) + 1);
+  config_freedict(ini);
+
+  /* every channel draws noise from its own stream */
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  const uint64_t seed = ((uint64_t)tv.tv_sec << 20) ^ tv.tv_usec;
+
+  Channel *channel = MEM_calloc_arrayN(n_channels, sizeof(Channel), "channels_signal: channel");
+  for (index_t c = 0; c < n_channels; c++)
+  {
+    if (channel_init(&channel[c], name[c], seed, c) != 0)
+    {
+      fprintf(stderr, _("wrong config of channel %d: %s\n"), c + 1, name[c]);
+      for (index_t k = 0; k < c; k++) channel_free(&channel[k]);
+      MEM_freeN(channel);
+      return -1;
+    }
+  }
+
+  Thread_Pool *pool = thread_pool_new(opt->jobs);
+  if (pool == NULL)
+  {
+    fprintf(stderr, _("cannot start worker threads\n"));
+    for (index_t c = 0; c < n_channels; c++) channel_free(&channel[c]);
+    MEM_freeN(channel);
+    return -1;
+  }
+
+  const bool lanes_apply = lanes_requested && _channels_lanes_apply(channel, n_channels);
+  if (lanes_requested && !lanes_apply)
+  {
+    fprintf(stderr, _("channels differ in frame or smoothing, or do not use the derivative detector: lanes are off\n"));
+  }
+  data_t *lanes[2] = { NULL, NULL };
+  if (lanes_apply)
+  {
+    const size_t size = (size_t)channel[0].conf.n_points * n_channels;
+    lanes[0] = MEM_malloc_arrayN(2 * size, sizeof(data_t), "channels_signal: lanes");
+    lanes[1] = lanes[0] + size;
+  }
+
+  /* all channels of a tick are processed together, ticks are paced by the frequency of config (--bench: as fast as possible) */
+  Schedule schedule;
+  const bool paced = !opt->bench && (frequency > 0);
+  if (paced) schedule_init(&schedule, frequency);
+
+  Channels_Tick tick = { channel, 0, 0 };
+  const double start_time = get_run_time();
+  for (tick.frame = 0; tick.frame < n_frames; tick.frame++)
+  {
+    if (lanes_apply)
+    {
+      tick.steps = CHANNEL_GENERATE;
+      thread_pool_run(pool, n_channels, _channels_task, &tick);
+      _channels_smooth_lanes(channel, n_channels, lanes);
+      tick.steps = CHANNEL_SEARCH;
+      thread_pool_run(pool, n_channels, _channels_task, &tick);
+    }
+    else
+    {
+      tick.steps = CHANNEL_GENERATE | CHANNEL_SMOOTH | CHANNEL_SEARCH;
+      thread_pool_run(pool, n_channels, _channels_task, &tick);
+    }
+    if (paced) schedule_wait(&schedule);
+  }
+  const double total_time = get_run_time() - start_time;
+
+  /* Report */
+  printf(_("CHANNELS: %d channel(s) x %u frame(s) in %f sec: %.1f channel frames/s (%d worker(s), lanes %s)\n"),
+         n_channels, n_frames, total_time, n_channels * n_frames / total_time, thread_pool_size(pool),
+         lanes_apply ? _("on") : _("off"));
+  if (paced) printf(_("CHANNELS: missed deadlines: %u of %u ticks\n"), schedule.missed, n_frames);
+  for (index_t c = 0; c < n_channels; c++)
+  {
+    const Sensor_Bank *sensors = &channel[c].sensors;
+    printf(_("CHANNELS: channel %d (%s): frames with lost peaks: %u\n"), c + 1, name[c], channel[c].n_lost);
+    for (index_t s = 0; (s < sensors->n_sensors) && (sensors->dev_count > 0); s++)
+    {
+      printf(_("CHANNELS:   sensor %d: temperature %f, deviation %f +- %f\n"), s + 1, sensors->temperature[s],
+             sensors->dev_mean[s], sqrt(sensor_bank_deviation_variance(sensors, s)));
+    }
+  }
+
+  if (lanes[0] != NULL) MEM_freeN(lanes[0]);
+  thread_pool_free(pool);
+  for (index_t c = 0; c < n_channels; c++) channel_free(&channel[c]);
+  MEM_freeN(channel);
+
+  return 0;
+}
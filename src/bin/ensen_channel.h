@@ -0,0 +1,38 @@
+#ifndef ENSEN_CHANNEL_H
+#define ENSEN_CHANNEL_H
+
+#include "ensen_conf.h"
+#include "ensen.h"
+#include "ensen_exp.h"
+#include "ensen_search.h"
+
+/* Maximal number of fibers of the interrogator */
+#define CHANNELS_MAX 64
+
+/* One fiber: its own config, frame, generator (noise stream), detector and sensors */
+typedef struct {
+  dictionary        *ini;
+  Signal_Parameters  conf;
+  Points             data;
+  Exp_Generator     *generator;
+  Searcher           searcher;
+  Sensor_Bank        sensors;
+  Calibration       *calibration;    /* of sensors (NULL - linear) */
+  Peaks              peaks;
+  data_t            *position_room;  /* peak positions at room temperature (the ramp of config is repeated) */
+  data_t             delta_temp;     /* temperature step of a tick of config */
+  data_t             temp_gen;       /* generated temperature */
+  uint32_t           n_lost;         /* frames with less peaks than sensors */
+} Channel;
+
+/* Channel of config file, noise is the stream of seed (returns 0, -1 if config is wrong) */
+int channel_init(Channel *ch, const char *config, uint64_t seed, uint64_t stream);
+void channel_free(Channel *ch);
+/* Frame of the temperature ramp of config */
+void channel_generate(Channel *ch, uint32_t frame);
+/* Peak search (smooth - frame is not smoothed yet) and sensor temperatures */
+void channel_search(Channel *ch, uint32_t frame, bool smooth);
+
+int channels_signal(const Ensen_Options *opt);
+
+#endif
@@ -1,7 +1,27 @@
+#include <ctype.h>
+
 #include "mem/ensen_mem_guarded.h"
 
 #include "ensen_conf.h"
 
+/* Numbers separated by spaces, returns their count, -1 if there is anything else or more than max */
+static int
+_config_list(const char *s, data_t *value, index_t max)
+{
+  int n = 0;
+  char *end = NULL;
+  for (;;)
+  {
+    while (isspace((unsigned char)*s)) s++;
+    if (*s == '\0') return n;
+
+    const data_t v = strtod(s, &end);
+    if ((end == s) || ((*end != '\0') && !isspace((unsigned char)*end)) || (n == max)) return -1;
+    value[n++] = v;
+    s = end;
+  }
+}
+
 int
 config_parameters_set(Signal_Parameters * param, const dictionary *ini)
 {
@@ -13,24 +33,19 @@ config_parameters_set(Signal_Parameters * param, const dictionary *ini)
   (*param).n_points             = config_getint(ini, "points:number", -1);
   (*param).n_peaks              = config_getint(ini, "peaks:number", -1);
 
-  (*param).peak = MEM_malloc_arrayN(4, sizeof(Peak), "config_parameters_set: peak[4]");
+  (*param).peak = MEM_malloc_arrayN((*param).n_peaks, sizeof(Peak), "config_parameters_set: peak");
   (*param).peak->timeshift      = config_getint(ini, "peaks:timeshift", -1);
 
-  (*param).peak[0].amplitude    = config_getdouble(ini, "peaks:[0].amplitude", -1.0);
-  (*param).peak[0].position     = config_getdouble(ini, "peaks:[0].position", -1.0);
-  (*param).peak[0].width        = config_getdouble(ini, "peaks:[0].width", -1.0);
-
-  (*param).peak[1].amplitude    = config_getdouble(ini, "peaks:[1].amplitude", -1.0);
-  (*param).peak[1].position     = config_getdouble(ini, "peaks:[1].position", -1.0);
-  (*param).peak[1].width        = config_getdouble(ini, "peaks:[1].width", -1.0);
-
-  (*param).peak[2].amplitude    = config_getdouble(ini, "peaks:[2].amplitude", -1.0);
-  (*param).peak[2].position     = config_getdouble(ini, "peaks:[2].position", -1.0);
-  (*param).peak[2].width        = config_getdouble(ini, "peaks:[2].width", -1.0);
-
-  (*param).peak[3].amplitude    = config_getdouble(ini, "peaks:[3].amplitude", -1.0);
-  (*param).peak[3].position     = config_getdouble(ini, "peaks:[3].position", -1.0);
-  (*param).peak[3].width        = config_getdouble(ini, "peaks:[3].width", -1.0);
+  for (index_t i = 0; i < (*param).n_peaks; i++)
+  {
+    char key[48];
+    snprintf(key, sizeof(key), "peaks:[%d].amplitude", i);
+    (*param).peak[i].amplitude  = config_getdouble(ini, key, -1.0);
+    snprintf(key, sizeof(key), "peaks:[%d].position", i);
+    (*param).peak[i].position   = config_getdouble(ini, key, -1.0);
+    snprintf(key, sizeof(key), "peaks:[%d].width", i);
+    (*param).peak[i].width      = config_getdouble(ini, key, -1.0);
+  }
 
   /* Noise setup */
   (*param).noise.amplitude      = config_getdouble(ini, "noise:amplitude", -1.0);
@@ -39,10 +54,14 @@ config_parameters_set(Signal_Parameters * param, const dictionary *ini)
   /* Smooth setup */
   (*param).smooth.width         = config_getint(ini, "smooth:width", -1);
   (*param).smooth.level         = config_getint(ini, "smooth:level", -1);
+  (*param).smooth.adaptive      = config_getint(ini, "smooth:adaptive", 0);
+  (*param).smooth.target        = config_getdouble(ini, "smooth:target", 0.01);
 
   /* Generation setup */
   (*param).generation_max       = config_getint(ini, "generation:number", -1.0);
   (*param).generation_frequency = config_getint(ini, "generation:frequency", -1.0); // Hz
+  (*param).history              = config_getint(ini, "generation:history", 1024);
+  (*param).pipeline             = config_getint(ini, "generation:pipeline", 0);
 
   /* Temperature setup */
   (*param).temp.apply           = config_getint(ini, "temperature:apply", -1.0);
@@ -57,6 +76,29 @@ config_parameters_set(Signal_Parameters * param, const dictionary *ini)
   (*param).search.peaks_real_number   = config_getint(ini, "search:peaks.num.real", -1.0);
   (*param).search.peaks_array_number  = config_getint(ini, "search:peaks.num.arr", -1.0);
   (*param).search.peak_search_number  = config_getint(ini, "search:peaks.num", -1.0);
+  (*param).search.stream_chunk        = config_getint(ini, "search:stream.chunk", 0);
+  (*param).search.detector            = config_getint(ini, "search:detector", PEAK_DETECTOR_DERIV);
+  (*param).search.cwt_snr             = config_getdouble(ini, "search:cwt.snr", 3.0);
+  (*param).search.xcorr_window        = config_getint(ini, "search:xcorr.window", 512);
+  (*param).search.xcorr_range         = config_getint(ini, "search:xcorr.range", 896);
+
+  /* Wavelet scales: list of numbers separated by spaces */
+  const char *scales = config_getstring(ini, "search:cwt.scales", "16 24 32 48 64 96");
+  const int n_scales = _config_list(scales, (*param).search.cwt_scales, CWT_SCALES_MAX);
+  if (n_scales < 0) fprintf(stderr, "config: wrong search:cwt.scales %s\n", scales);
+  (*param).search.cwt_scales_number = (n_scales > 0) ? n_scales : 0;
+
+  /* Tracker setup */
+  (*param).track.apply             = config_getint(ini, "tracker:apply", 0);
+  (*param).track.process_noise     = config_getdouble(ini, "tracker:process_noise", 0.01);
+  (*param).track.measurement_noise = config_getdouble(ini, "tracker:measurement_noise", 4.0);
+  (*param).track.gate              = config_getdouble(ini, "tracker:gate", 5.0);
+  (*param).track.refine            = config_getint(ini, "tracker:refine", 0);
+
+  /* Real-time setup */
+  (*param).rt.apply                = config_getint(ini, "realtime:apply", 0);
+  (*param).rt.priority             = config_getint(ini, "realtime:priority", 0);
+  (*param).rt.cpu                  = config_getint(ini, "realtime:cpu", -1);
 
   /* Plot setup */
   (*param).plot.x_min             = config_getdouble(ini, "plot:x.min", -1.0);
@@ -74,6 +116,63 @@ config_parameters_set(Signal_Parameters * param, const dictionary *ini)
   return 0;
 }
 
+int
+config_calibration_load(const dictionary *ini, const Signal_Parameters *param, Calibration **calibration)
+{
+  *calibration = NULL;
+  const char *file = config_getstring(ini, "temperature:calibration", "");
+  if (file[0] == '\0') return 0;
+
+  dictionary *cal = config_load(file);
+  if (cal == NULL)
+  {
+    fprintf(stderr, "config: cannot read calibration %s\n", file);
+    return -1;
+  }
+
+  /* sensors which are not in file are linear */
+  const index_t n_sensors = (*param).search.peaks_real_number;
+  Calibration *c = calibration_new(n_sensors, (*param).temp.room, (*param).temp.coefficient);
+  int status = (c != NULL) ? 0 : -1;
+
+  for (index_t s = 0; (status == 0) && (s < n_sensors); s++)
+  {
+    data_t shift[CONFIG_CALIBRATION_KNOTS], temperature[CONFIG_CALIBRATION_KNOTS];
+    char key[48];
+
+    snprintf(key, sizeof(key), "calibration:[%d].polynomial", s);
+    const char *polynomial = config_getstring(cal, key, NULL);
+    snprintf(key, sizeof(key), "calibration:[%d].shift", s);
+    const char *knots = config_getstring(cal, key, NULL);
+    snprintf(key, sizeof(key), "calibration:[%d].temperature", s);
+    const char *values = config_getstring(cal, key, NULL);
+
+    if (polynomial != NULL)
+    {
+      const int n = _config_list(polynomial, temperature, CALIB_ORDER_MAX + 1);
+      status = (n > 0) ? calibration_set_polynomial(c, s, temperature, n) : -1;
+    }
+    else if ((knots != NULL) && (values != NULL))
+    {
+      const int n = _config_list(knots, shift, CONFIG_CALIBRATION_KNOTS);
+      status = ((n > 0) && (_config_list(values, temperature, CONFIG_CALIBRATION_KNOTS) == n)) ? calibration_set_table(c, s, shift, temperature, n) : -1;
+    }
+    else if ((knots != NULL) || (values != NULL)) status = -1;
+
+    if (status != 0) fprintf(stderr, "config: wrong calibration of sensor %d in %s\n", s, file);
+  }
+
+  config_freedict(cal);
+  if (status != 0)
+  {
+    calibration_free(c);
+    return -1;
+  }
+
+  *calibration = c;
+  return 0;
+}
+
 void
 config_parameters_set_default(void)
 {
@@ -114,6 +213,8 @@ config_parameters_set_default(void)
     "[Smooth]\n"
     "width           = 100;          // smooth width (points)\n"
     "level           = 3;            // number of smooth operations to apply\n"
+    "adaptive        = 0;            // 1 - the cheapest width and level (up to the above) that meet target at the noise of every frame\n"
+    "target          = 0.01;         // adaptive: peak position error (nm)\n"
     "\n"
     "[Search]\n"
     "peaks.num       = 1;            // peak of interest (sensor) number to show on graph\n"
@@ -121,10 +222,18 @@ config_parameters_set_default(void)
     "threshold_amp   = 0.35;         // signal's peak amplitude threshold\n"
     "peaks.num.real  = 4;            // number of perak to search for\n"
     "peaks.num.arr   = 10;           // maximal array size for peak searching\n"
+    "stream.chunk    = 0;            // online search by chunks of points (0 - search in the whole frame)\n"
+    "detector        = 0;            // 0 - derivative of smoothed signal; 1 - continuous wavelet transform; 2 - cross-correlation tracker\n"
+    "cwt.scales      = 16 24 32 48 64 96; // wavelet scales (points)\n"
+    "cwt.snr         = 3.0;          // minimal wavelet coefficient to noise ratio\n"
+    "xcorr.window    = 512;          // cross-correlation window around peak (points)\n"
+    "xcorr.range     = 896;          // maximal peak shift between measurements, less than distance between peaks (points)\n"
     "\n"
     "[Generation]\n"
     "number          = 100;          // number of signal generations (mesurements in experiment)\n"
     "frequency       = 5;            // frequency of mesurements\n"
+    "history         = 1024;         // number of last mesurements kept for plots\n"
+    "pipeline        = 0;            // 1 - generator, peak search and output run on their own threads\n"
     "\n"
     "[Temperature]\n"
     "apply           = 1;            // calculate temperature drift\n"
@@ -132,6 +241,35 @@ config_parameters_set_default(void)
     "room            = 20;           // room temperature\n"
     "max             = 1350;         // maxumum temperature in experiment\n"
     "coefficient     = 0.02;         // coefficient [nm/C]\n"
+    "calibration     = ;             // calibration file of sensors (empty - linear coefficient)\n"
+    "\n"
+    "[Tracker]\n"
+    "apply           = 0;            // filter peak positions (constant-velocity Kalman filter)\n"
+    "process_noise   = 0.01;         // variance of drift change per mesurement (points^2)\n"
+    "measurement_noise = 4.0;        // variance of found peak position (points^2)\n"
+    "gate            = 5.0;          // search window and outlier rejection (sigmas)\n"
+    "refine          = 0;            // half width of sub-sample peak refinement (points, 0 - off)\n"
+    "\n"
+    "[Realtime]\n"
+    "apply           = 0;            // lock memory, check that frames do not allocate memory\n"
+    "priority        = 0;            // SCHED_FIFO priority of processing (1..99, 0 - default scheduler)\n"
+    "cpu             = -1;           // core of peak search thread (-1 - any)\n"
+    "\n"
+    "[Channels]\n"
+    "number          = 1;            // fibers processed together (copies of this config)\n"
+    "config          = ;             // or config files of fibers separated by spaces\n"
+    "lanes           = 0;            // smooth frames of all fibers at once as SIMD lanes\n"
+    "\n"
+    "[Sweep]\n"
+    "noise.amplitude = 0.0 0.05 0.1 0.15; // every combination of the lists is a point (no list - value of config)\n"
+    "noise.color     = 0 1 2 3;      // 0-random; 1-white; 2-brown; 3-violet\n"
+    "smooth.width    = 50 100;       // smooth width (in points)\n"
+    "smooth.level    = 1 3;          // number of smooth operations\n"
+    "detector        = 0;            // peak detectors (0 - derivative, 1 - wavelet, 2 - cross-correlation)\n"
+    "trials          = 16;           // Monte Carlo trials of every point\n"
+    "frames          = 20;           // frames of a trial (temperature ramp from room to max)\n"
+    "seed            = 1;            // the same seed repeats the table for any number of workers\n"
+    "output          = sweep.dat;    // table of temperature errors\n"
     "\n"
     "[Plot]\n"
     "x.min           = 1500;         // x window limit (left)\n"
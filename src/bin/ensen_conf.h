@@ -5,7 +5,12 @@
 #include "config/ensen_config.h"
 #include "config/ensen_config_dictionary.h"
 
+/* Knots of a calibration table read from file */
+#define CONFIG_CALIBRATION_KNOTS 256
+
 int config_parameters_set(Signal_Parameters * param, const dictionary *ini);
+/* Calibration file of temperature:calibration: NULL without it, -1 if it cannot be read */
+int config_calibration_load(const dictionary *ini, const Signal_Parameters *param, Calibration **calibration);
 void config_parameters_set_default(void);
 
 #endif
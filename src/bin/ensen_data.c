@@ -14,10 +14,9 @@ data_clear(data_t * x, const index_t size)
 void
 data_convert_to_lambda(data_t * lambda, const data_t lambda_begin, const data_t lambda_end, const index_t size)
 {
-  for (index_t i = 0; i < size; i++)
-  {
-    lambda[i] = lambda_begin + ( i * ((lambda_end - lambda_begin)/size));
-  }
+  Grid grid;
+  grid_uniform_set(&grid, lambda_begin, lambda_end, size);
+  grid_fill(&grid, lambda);
 }
 
 void
@@ -26,27 +25,25 @@ data_arrays_set(const Signal_Parameters conf, PointsArrays points)
   points.data->x = points.data->y = NULL;
   points.data->x = MEM_malloc_arrayN(conf.n_points + 1, sizeof(data_t), "data_arrays_set: data.x");
   points.data->y = MEM_malloc_arrayN(conf.n_points + 1, sizeof(data_t), "data_arrays_set: data.y");
-  data_convert_to_lambda(points.data->x, conf.plot.x_min, conf.plot.x_max, conf.n_points);
+  grid_uniform_set(&points.data->grid, conf.plot.x_min, conf.plot.x_max, conf.n_points);
+  grid_fill(&points.data->grid, points.data->x);
 
+  /* buffers for plots of history (ring buffers are unrolled here) */
   points.data_temp->x = points.data_temp->y = NULL;
-  points.data_temp->x = MEM_malloc_arrayN(conf.generation_max + 1, sizeof(data_t), "data_arrays_set: data_temp.x");
-  points.data_temp->y = MEM_malloc_arrayN(conf.generation_max + 1, sizeof(data_t), "data_arrays_set: data_temp.y");
-
-  points.temp_gen->y = NULL;
-  points.temp_gen->y = MEM_malloc_arrayN(conf.generation_max + 1, sizeof(data_t), "data_arrays_set: temp_gen.y");
-
-  points.temp_sens_1->x = points.temp_sens_2->x = points.temp_sens_3->x = points.temp_sens_4->x = NULL;
-  points.temp_sens_1->y = points.temp_sens_2->y = points.temp_sens_3->y = points.temp_sens_4->y = NULL;
-  points.temp_sens_1->y = MEM_malloc_arrayN(conf.generation_max + 1, sizeof(data_t), "data_arrays_set: temp_sens_1.y");
-  points.temp_sens_2->y = MEM_malloc_arrayN(conf.generation_max + 1, sizeof(data_t), "data_arrays_set: temp_sens_2.y");
-  points.temp_sens_3->y = MEM_malloc_arrayN(conf.generation_max + 1, sizeof(data_t), "data_arrays_set: temp_sens_3.y");
-  points.temp_sens_4->y = MEM_malloc_arrayN(conf.generation_max + 1, sizeof(data_t), "data_arrays_set: temp_sens_4.y");
-  
-  points.temp_gen->y[0] = points.temp_sens_1->y[0] 
-                        = points.temp_sens_2->y[0] 
-                        = points.temp_sens_3->y[0] 
-                        = points.temp_sens_4->y[0] 
-                        = conf.temp.room;
+  points.data_temp->x = MEM_malloc_arrayN(conf.history, sizeof(data_t), "data_arrays_set: data_temp.x");
+  points.data_temp->y = MEM_malloc_arrayN(conf.history, sizeof(data_t), "data_arrays_set: data_temp.y");
 }
 
-
+void
+data_publish(Publisher *pub, uint32_t frame, const Sensor_Bank *sensors, const Peaks *peaks, const data_t *y, index_t n_points)
+{
+  Publish_Reading *r = publisher_begin(pub);
+  for (index_t s = 0; s < sensors->n_sensors; s++)
+  {
+    const bool found = (s < peaks->total_number) && (peaks->peak[s].position >= 0) && (peaks->peak[s].position + 0.5 < n_points);
+    r[s].position    = sensors->position[s];
+    r[s].temperature = sensors->temperature[s];
+    r[s].quality     = found ? y[(index_t)(peaks->peak[s].position + 0.5)] : 0;
+  }
+  publisher_commit(pub, frame);
+}
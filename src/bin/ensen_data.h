@@ -2,9 +2,17 @@
 #define ENSEN_DATA_H
 
 #include "ensen_private.h"
+#include "signal/ensen_signal_grid.h"
+#include "signal/ensen_signal_sensor.h"
+#include "io/ensen_io_publish.h"
+
+/* Records kept in the shared memory ring of --publish */
+#define DATA_PUBLISH_RECORDS 1024
 
 void data_clear(data_t * x, const index_t size);
 void data_convert_to_lambda(data_t * lambda, const data_t lambda_begin, const data_t lambda_end, const index_t size);
 void data_arrays_set(const Signal_Parameters conf, PointsArrays points);
+/* Publish position, temperature and signal at the peak (y) of every sensor */
+void data_publish(Publisher *pub, uint32_t frame, const Sensor_Bank *sensors, const Peaks *peaks, const data_t *y, index_t n_points);
 
 #endif
\ No newline at end of file
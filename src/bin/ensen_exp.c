@@ -1,70 +1,111 @@
+#include <sys/time.h>
+#include <unistd.h>
+
 #include "ensen_exp.h"
-#include <fftw3.h>
+
+#include "mem/ensen_mem_guarded.h"
+
+Exp_Generator *
+exp_generator_new(index_t size)
+{
+  const size_t n = (size_t)size * 2;
+  Exp_Generator *gen = MEM_callocN(sizeof(Exp_Generator), "exp_generator_new: generator");
+
+  gen->size     = size;
+  gen->peak     = MEM_malloc_arrayN(size, sizeof(data_t), "exp_generator_new: peak");
+  gen->gaussian = MEM_malloc_arrayN(size, sizeof(data_t), "exp_generator_new: gaussian");
+  gen->in       = fftw_malloc(sizeof(fftw_complex) * n);
+  gen->out      = fftw_malloc(sizeof(fftw_complex) * n);
+  gen->kernel   = fftw_malloc(sizeof(fftw_complex) * n);
+  gen->forward  = fftw_plan_dft_1d(n, gen->in, gen->out, FFTW_FORWARD, FFTW_ESTIMATE);
+
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  exp_generator_seed(gen, ((uint64_t)tv.tv_sec << 20) ^ tv.tv_usec, getpid());
+
+  return gen;
+}
+
+void
+exp_generator_free(Exp_Generator *gen)
+{
+  if (gen == NULL) return;
+
+  fftw_destroy_plan(gen->forward);
+  fftw_free(gen->in);
+  fftw_free(gen->out);
+  fftw_free(gen->kernel);
+  MEM_freeN(gen->peak);
+  MEM_freeN(gen->gaussian);
+  MEM_freeN(gen);
+}
+
+void
+exp_generator_seed(Exp_Generator *gen, uint64_t seed, uint64_t stream)
+{
+  random_stream_init(&gen->rng, seed, stream);
+}
 
 double
-exp_broaden(const index_t size, double * in, double * out, const double t) 
+exp_broaden(Exp_Generator *gen, const double * in, double * out, const double t)
 {
-  double start_time = get_run_time();
+  Profile_Mark mark;
+  profile_begin(&mark);
 
+  const index_t size = gen->size;
   const index_t n = size * 2;
-  fftw_complex in1[n], out1[n], in2[n], out2[n], in3[n], out3[n];
-  double real = 0.f, imag = 0.f;
+  fftw_complex *buf = gen->in, *spectrum = gen->out;
   index_t i = 0;
 
-  // Plan 1:  rearange input signal (double)
-  fftw_plan p1 = fftw_plan_dft_1d(n, in1, out1, FFTW_FORWARD, FFTW_ESTIMATE);
-  index_t hfl = round(size/2);
-  for (i = 0; i < n; ++i) {
-    real = ((i < hfl) || (i > (n - hfl - 1))) ? in[0] * 1.0 : in[i - hfl]; // assume symmetrical tails of signal
-    imag = 0.f;
-    in1[i] = real + I * imag;
+  // Spectrum of exponential signal (the same for all frames)
+  if ((gen->kernel_t < t) || (gen->kernel_t > t))
+  {
+    double sum = 0;
+    for (i = 0; i < n; ++i) {
+        buf[i] = exp(-(i+1)/t);
+        sum += creal(buf[i]);
+    }
+    fftw_execute(gen->forward);
+    for (i = 0; i < n; ++i) gen->kernel[i] = spectrum[i];
+    gen->kernel_sum = sum;
+    gen->kernel_t = t;
   }
 
-  fftw_execute(p1);
-  fftw_destroy_plan(p1);
-
-  // Plan 2: create exponential signal
-  fftw_plan p2 = fftw_plan_dft_1d(n, in2, out2, FFTW_FORWARD, FFTW_ESTIMATE);
-  double sum = 0;
+  // Rearange input signal
+  index_t hfl = round(size/2);
   for (i = 0; i < n; ++i) {
-      real = exp(-(i+1)/t);
-      imag = 0.f;
-      in2[i] = real + I * imag;
-      sum += real;
+    buf[i] = ((i < hfl) || (i > (n - hfl - 1))) ? in[0] * 1.0 : in[i - hfl]; // assume symmetrical tails of signal
   }
-  fftw_execute(p2);
-  fftw_destroy_plan(p2);
+  fftw_execute(gen->forward);
 
-  // Plan 3: Multiply to FFT signals and find inverse
-  fftw_plan p3 = fftw_plan_dft_1d(n, in3, out3, FFTW_FORWARD, FFTW_ESTIMATE);
+  // Multiply to FFT signals and find inverse (forward transform, read backwards)
   for (i = 0; i < n; i++)
   {
-    in3[i] = out1[i] * out2[i];
+    buf[i] = spectrum[i] * gen->kernel[i];
   }
-  fftw_execute(p3);
-  fftw_destroy_plan(p3);
+  fftw_execute(gen->forward);
 
   // Compress
   index_t ii = 0;
   for (index_t p = (n-(size/2)+1); p >= (size/2+2); p--)
   {
-    out[ii] = (creal(out3[p])/sum)/n;
+    out[ii] = (creal(spectrum[p])/gen->kernel_sum)/n;
     ii = ii + 1;
   }
 
-  double end_time = get_run_time();
-  return end_time - start_time;
+  return profile_end(&mark, "exp_broaden");
 }
 
 double
-exp_gaussian(const index_t size, double * in, double * out, double pos, double wid, double timeconstant)
+exp_gaussian(Exp_Generator *gen, const double * in, double * out, double pos, double wid, double timeconstant)
 {
 #ifdef LOG_TIME
   double start_time = get_run_time();
 #endif
   // Exponentially-convoluted gaussian(x,pos,wid) = gaussian peak centered on pos, half-width=wid
   // x may be scalar, vector, or matrix, pos and wid both scalar
-  data_t yy[size];
+  const index_t size = gen->size;
+  data_t *yy = gen->gaussian;
   data_t arg = 0.0;
   for (index_t i = 0; i < size; i++)
   {
@@ -73,44 +114,46 @@ exp_gaussian(const index_t size, double * in, double * out, double pos, double w
   }
 
 #ifdef LOG_TIME
-  double t_broden = exp_broaden(size, yy, out, timeconstant);
+  double t_broden = exp_broaden(gen, yy, out, timeconstant);
   printf("Time exp broadening:\t%f\n", t_broden);
   double end_time = get_run_time();
   return (end_time - start_time) - t_broden;
 #else
-  exp_broaden(size, yy, out, timeconstant);
+  const double t_broaden = exp_broaden(gen, yy, out, timeconstant);
+  if (gen->broaden != NULL) latency_record_sec(gen->broaden, t_broaden);
   return 0.f;
 #endif
 }
 
 double
-signal_generate_exp(Points *points, index_t n_peaks, Peak peaks[], Noise noise, index_t n_points)
+signal_generate_exp(Exp_Generator *gen, Points *points, index_t n_peaks, Peak peaks[], Noise noise, index_t n_points)
 {
     index_t i = 0, j = 0;
-    data_t y[n_points];
+    data_t *y = gen->peak;
     data_t ampl_coeff = 0.f;
+    data_t noise_state = random_stream_noise_start(&gen->rng, noise.color);
 #ifdef LOG_TIME
     double time_exp = 0.f;
 #endif
-    double start_time = get_run_time();
+    Profile_Mark mark;
+    profile_begin(&mark);
 
     for (j = 0; j < n_peaks; j++)
     {
       for (index_t n = 0; n < n_points; n++) y[n] = 0.0;
 #ifdef LOG_TIME
-      time_exp = exp_gaussian(n_points, (*points).x, y, peaks[j].position, peaks[j].width, peaks->timeshift);
+      time_exp = exp_gaussian(gen, (*points).x, y, peaks[j].position, peaks[j].width, peaks->timeshift);
       printf("Time exp for peak %d:\t%f\n",   j, time_exp);
       printf("Amplitude of peak %d:\t%f\n",   j, peaks[j].amplitude);
 #else
-      exp_gaussian(n_points, (*points).x, y, peaks[j].position, peaks[j].width, peaks->timeshift);
+      exp_gaussian(gen, (*points).x, y, peaks[j].position, peaks[j].width, peaks->timeshift);
 #endif
       ampl_coeff = peaks[0].amplitude / max(y, n_points);
       for (i = 0; i < n_points; i++)
       {
         (*points).y[i] += peaks[j].amplitude * ampl_coeff * y[i];
-        if (noise.amplitude > 0) (*points).y[i] += noise.amplitude * random_range_pm_one();
+        if (noise.amplitude > 0) (*points).y[i] += noise.amplitude * random_stream_noise(&gen->rng, noise.color, &noise_state);
       }
     }
-    double end_time = get_run_time();
-    return end_time - start_time;
+    return profile_end(&mark, "signal_generate_exp");
 }
@@ -4,22 +4,44 @@
 #include "math/ensen_math.h"
 #include "signal/ensen_benchmark.h"
 #include "signal/ensen_signal.h"
+#include "signal/ensen_signal_latency.h"
 
-double exp_broaden(const index_t size, double * in, double * out, const double t);
-double exp_gaussian(const index_t size, double * in, double * out, double pos, double wid, double timeconstant);
+#include <fftw3.h>
 
-// double exp_gaussian(const index_t size, double * in, double * out, double pos, double wid, double timeconstant);
+/* Buffers and FFT plan of the generator, allocated once for all frames */
+typedef struct {
+  index_t       size;       /* number of points in frame */
+  data_t       *peak;       /* one broadened peak */
+  data_t       *gaussian;   /* one peak before broadening */
+  fftw_complex *in;         /* zero padded signal (2 x size) */
+  fftw_complex *out;        /* its spectrum */
+  fftw_complex *kernel;     /* spectrum of exponential decay */
+  double        kernel_t;   /* time constant of kernel (0 - not computed) */
+  double        kernel_sum;
+  fftw_plan     forward;    /* in -> out */
+  Random_Stream rng;        /* noise of this generator only (generators of threads are independent) */
+  Latency_Histogram *broaden; /* latency of every broadening (NULL - not recorded) */
+} Exp_Generator;
+
+/// @brief Allocate generator
+/// @param size Number of points in frame
+/// @return Generator (free with exp_generator_free()), noise is seeded by time
+Exp_Generator *exp_generator_new(index_t size);
+void exp_generator_free(Exp_Generator *gen);
+/* Reproducible noise: stream of seed (trials of a sweep are the streams) */
+void exp_generator_seed(Exp_Generator *gen, uint64_t seed, uint64_t stream);
 
 /// @brief Zero pads input and convolutes result by an exponential decay
 /// of time constant "t" by multiplying Fourier transforms and inverse
 /// transforming the result.
-/// @param size Size of input
-/// @param input Input data array 
+/// @param gen Generator (size of input, buffers and plan)
+/// @param input Input data array
 /// @param output Output data array
 /// @param t Time constant
 /// @return Time of exacution (in sec.)
-// double exp_broaden(const index_t size, double * input, double * output, const double t);
+double exp_broaden(Exp_Generator *gen, const double * in, double * out, const double t);
+double exp_gaussian(Exp_Generator *gen, const double * in, double * out, double pos, double wid, double timeconstant);
 
-double signal_generate_exp(Points *points, index_t n_peaks, Peak peaks[], Noise noise, index_t n_points);
+double signal_generate_exp(Exp_Generator *gen, Points *points, index_t n_peaks, Peak peaks[], Noise noise, index_t n_points);
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,121 @@
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#if HAVE_GETTEXT
+  #include <libintl.h>
+  #define _(string) gettext (string)
+#else
+  #define _(string) (string)
+#endif
+
+#include <signal.h>
+#include <string.h>
+
+#include "ensen_metrics.h"
+#include "mem/atomic_ops.h"
+
+static const char *metrics_name[METRICS] = { "generate", "broaden", "smooth", "derivative", "search", "temperature", "plot", "frame" };
+
+static uint32_t metrics_requests = 0;   /* atomic, SIGUSR1 received */
+
+static void
+_metrics_signal(int signum __UNUSED__)
+{
+  atomic_add_and_fetch_uint32(&metrics_requests, 1);
+}
+
+void
+metrics_init(Metrics *m, const char *file)
+{
+  /* requests before now are served */
+  m->dumped = atomic_load_uint32(&metrics_requests);
+  for (index_t s = 0; s < METRICS; s++)
+  {
+    latency_reset(&m->stage[s]);
+    m->taken[s] = m->dumped;
+  }
+  m->file = file;
+
+  struct sigaction sa;
+  memset(&sa, 0, sizeof(sa));
+  sa.sa_handler = _metrics_signal;
+  sigemptyset(&sa.sa_mask);
+  sa.sa_flags = SA_RESTART;
+  sigaction(SIGUSR1, &sa, NULL);
+}
+
+static int
+_metrics_write(const Metrics *m, const Latency_Histogram *stage)
+{
+  if (m->file == NULL)
+  {
+    latency_print(stdout, metrics_name, stage, METRICS, false);
+    return 0;
+  }
+
+  const size_t length = strlen(m->file);
+  const bool json = (length >= 5) && (strcmp(m->file + length - 5, ".json") == 0);
+  FILE *f = fopen(m->file, "w");
+  if (f == NULL)
+  {
+    fprintf(stderr, _("cannot write metrics to %s\n"), m->file);
+    return -1;
+  }
+  latency_print(f, metrics_name, stage, METRICS, json);
+  fclose(f);
+  return 0;
+}
+
+int
+metrics_dump(const Metrics *m)
+{
+  return _metrics_write(m, m->stage);
+}
+
+void
+metrics_poll(Metrics *m)
+{
+  const uint32_t requests = atomic_load_uint32(&metrics_requests);
+  if (requests == m->dumped) return;
+
+  m->dumped = requests;
+  metrics_dump(m);
+}
+
+void
+metrics_snapshot(Metrics *m, unsigned stages)
+{
+  const uint32_t requests = atomic_load_uint32(&metrics_requests);
+  const uint32_t dumped = atomic_load_uint32(&m->dumped);
+
+  for (index_t s = 0; s < METRICS; s++)
+  {
+    if (!(stages & METRIC_MASK(s))) continue;
+
+    /* up to date, or the previous copy is not dumped yet */
+    const uint32_t taken = atomic_load_uint32(&m->taken[s]);
+    if ((taken == requests) || (taken > dumped)) continue;
+
+    m->snapshot[s] = m->stage[s];
+    atomic_store_uint32(&m->taken[s], requests);
+  }
+}
+
+void
+metrics_poll_snapshot(Metrics *m)
+{
+  const uint32_t dumped = atomic_load_uint32(&m->dumped);
+  uint32_t least = UINT32_MAX;
+
+  for (index_t s = 0; s < METRICS; s++)
+  {
+    const uint32_t taken = atomic_load_uint32(&m->taken[s]);
+    if (taken <= dumped) return;
+    if (taken < least) least = taken;
+  }
+
+  /* the stages copied since the previous dump wait for this one */
+  _metrics_write(m, m->snapshot);
+  atomic_store_uint32(&m->dumped, least);
+}
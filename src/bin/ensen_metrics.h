@@ -0,0 +1,57 @@
+#ifndef ENSEN_METRICS_H
+#define ENSEN_METRICS_H
+
+#include "ensen_private.h"
+#include "signal/ensen_benchmark.h"
+#include "signal/ensen_signal_latency.h"
+
+/* Stages of a frame with latency histograms */
+typedef enum {
+  METRIC_GENERATE = 0,
+  METRIC_BROADEN,      /* every peak of a frame (part of generation) */
+  METRIC_SMOOTH,
+  METRIC_DERIVATIVE,   /* plotted derivative (the detector tests slopes inside the search) */
+  METRIC_SEARCH,
+  METRIC_TEMPERATURE,
+  METRIC_PLOT,         /* output: print and plots */
+  METRIC_FRAME,        /* start of generation to the end of output */
+  METRICS
+} Metric_Stage;
+
+#define METRIC_MASK(stage) (1u << (stage))
+
+/* Histograms of all stages, every stage is recorded by one thread */
+typedef struct {
+  Latency_Histogram  stage[METRICS];
+  Latency_Histogram  snapshot[METRICS];  /* copy of every stage made by its thread for a dump (pipeline) */
+  uint32_t           taken[METRICS];     /* atomic, requests when the snapshot of stage was made */
+  uint32_t           dumped;             /* atomic, requests served */
+  const char        *file;               /* dump (NULL - stdout), JSON if the name ends with .json */
+} Metrics;
+
+/* Empty histograms, SIGUSR1 requests a dump from now on (see metrics_poll()) */
+void metrics_init(Metrics *m, const char *file);
+/* Dump to the file of metrics or to stdout (returns 0, -1 if the file cannot be written) */
+int metrics_dump(const Metrics *m);
+/* Dump if SIGUSR1 came after the previous dump (only by the thread that records all stages) */
+void metrics_poll(Metrics *m);
+
+/*
+ * Stages on their own threads: every thread copies its stages (mask of
+ * METRIC_MASK()) to the snapshot when a dump is requested, the one that
+ * dumps polls the snapshot, which is written when all stages are copied
+ * (stages of a dump may be a few frames apart).
+ */
+void metrics_snapshot(Metrics *m, unsigned stages);
+void metrics_poll_snapshot(Metrics *m);
+
+/* Record stage started at start (get_run_time()), returns the time of its end */
+static inline double
+metrics_stage(Metrics *m, Metric_Stage stage, double start)
+{
+  const double end = get_run_time();
+  latency_record_sec(&m->stage[stage], end - start);
+  return end;
+}
+
+#endif
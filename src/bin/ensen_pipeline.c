@@ -0,0 +1,215 @@
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#if HAVE_GETTEXT
+  #include <libintl.h>
+  #define _(string) gettext (string)
+#else
+  #define _(string) (string)
+#endif
+
+#include <math.h>
+
+#include "ensen_pipeline.h"
+#include "ensen_data.h"
+#include "ensen_exp.h"
+#include "ensen_plot.h"
+#include "ensen_show.h"
+
+#include "thread/ensen_thread_pipeline.h"
+#include "thread/ensen_thread_rt.h"
+#include "mem/ensen_mem_guarded.h"
+
+typedef struct {
+  data_t   *y;                 /* signal (smoothed by peak search) */
+  Peaks     peaks;
+  double    start;             /* start of generation (get_run_time()) */
+  data_t    generation_time;
+  data_t    peak_search_time;
+  data_t    temp_gen;          /* temperature set by generator */
+  bool      temp_changed;      /* generator changed peak positions */
+  Peak     *peak;              /* generated peaks (the generator keeps changing those of conf) */
+  uint32_t  n_step;            /* number of the temperature step */
+} Frame;
+
+typedef struct {
+  Signal_Run     *run;
+  data_t          temp_gen;
+  uint32_t        n_step;
+  Capture_Writer *record;      /* NULL after a failed write */
+} Generator_Stage;
+
+/* Acquisition: generate frame, the generator sets the frame rate */
+static int
+_pipeline_generate(void *frame, uint32_t number, void *data)
+{
+  Frame *f = frame;
+  Generator_Stage *g = data;
+  Signal_Parameters *conf = g->run->conf;
+  const data_t peak_position_ideal = conf->peak[0].position;
+
+  f->start = get_run_time();
+  data_clear(f->y, conf->n_points);
+
+  /* Change peak positions according to the new temperature value */
+  f->temp_changed = false;
+  if ((conf->temp.apply) & (fmod(number, conf->temp.tick) <= 1.0e-14))
+  {
+    for (index_t i = 0; i < conf->n_peaks; i++)
+    {
+      conf->peak[i].position += g->run->stat->delta_temp * conf->temp.coefficient;
+    }
+    f->temp_changed = true;
+    f->n_step = g->n_step++;
+    for (index_t i = 0; i < conf->n_peaks; i++) f->peak[i] = conf->peak[i];
+  }
+  if (number > 0) g->temp_gen += (conf->peak[0].position - peak_position_ideal)/conf->temp.coefficient;
+  f->temp_gen = g->temp_gen;
+
+  /* fftw plans are made before the threads start, the stages only execute cached plans */
+  Points points = *g->run->data;
+  points.y = f->y;
+  f->generation_time = signal_generate_exp(g->run->generator, &points, conf->n_peaks, conf->peak, conf->noise, conf->n_points);
+  latency_record_sec(&g->run->metrics->stage[METRIC_GENERATE], f->generation_time);
+  metrics_snapshot(g->run->metrics, METRIC_MASK(METRIC_GENERATE) | METRIC_MASK(METRIC_BROADEN));
+  if ((g->record != NULL) && (capture_writer_append(g->record, f->y) != 0))
+  {
+    fprintf(stderr, _("cannot record frame %u, recording is stopped\n"), number);
+    g->record = NULL;
+  }
+
+  /* Simulate mesurements frequency */
+  if (conf->generation_max != 1)
+  {
+    schedule_wait(g->run->schedule);
+  }
+  return 0;
+}
+
+/* Processing: smooth frame and find peaks */
+static int
+_pipeline_search(void *frame, uint32_t number, void *data)
+{
+  Frame *f = frame;
+  Signal_Run *run = data;
+
+  /* the processing thread is pinned, the others may run on any core */
+  if ((number == 0) && run->conf->rt.apply && (realtime_pin_cpu(run->conf->rt.cpu) != 0))
+  {
+    fprintf(stderr, _("realtime: cannot pin peak search to CPU %d\n"), run->conf->rt.cpu);
+  }
+
+  const double t = get_run_time();
+  searcher_smooth(run->searcher, run->conf, f->y, f->y, number);
+  metrics_stage(run->metrics, METRIC_SMOOTH, t);
+  f->peak_search_time = searcher_find(run->searcher, run->conf, f->y, number, &f->peaks);
+  latency_record_sec(&run->metrics->stage[METRIC_SEARCH], f->peak_search_time);
+  metrics_snapshot(run->metrics, METRIC_MASK(METRIC_SMOOTH) | METRIC_MASK(METRIC_SEARCH));
+  return 0;
+}
+
+/* Output: integrate temperature, print and plot (on the calling thread) */
+static int
+_pipeline_output(void *frame, uint32_t number, void *data)
+{
+  Frame *f = frame;
+  Signal_Run *run = data;
+  const Signal_Parameters *conf = run->conf;
+  gnuplot_ctrl **win = run->win;
+  double t = get_run_time(), plot_time = 0;
+
+  run->stat->generation_time = f->generation_time;
+  run->stat->peak_search_time = f->peak_search_time;
+
+  if (f->temp_changed)
+  {
+    /* peaks of conf belong to the generator, which may be frames ahead */
+    Signal_Parameters generated = *conf;
+    generated.peak = f->peak;
+    show_generator_info(generated, *run->stat, f->n_step);
+  }
+
+  graphics_reset(win, *conf);
+  if ((number > 0) & (conf->plot.show_signal || conf->plot.show_smooth) & (win[0] != NULL))
+  {
+    gnuplot_plot_xy(win[0], run->data->x, f->y, conf->n_points, _("Signal (smooth)"));
+  }
+  if ((run->dy_dx != NULL) & (win[1] != NULL))
+  {
+    const double start = get_run_time();
+    plot_time += start - t;
+    deriv(conf->n_points, f->y, run->dy_dx);
+    t = metrics_stage(run->metrics, METRIC_DERIVATIVE, start);
+    gnuplot_plot_xy(win[1], run->data->x, run->dy_dx, conf->n_points, "dy/dLambda");
+  }
+  const double update = get_run_time();
+  plot_time += update - t;
+
+  sensor_bank_update(run->sensors, &f->peaks, &run->data->grid, conf->temp.coefficient);
+  if (run->publish != NULL) data_publish(run->publish, number, run->sensors, &f->peaks, f->y, conf->n_points);
+  if (number > 0)
+  {
+    ring_push(run->temp_gen, f->temp_gen);
+    sensor_bank_deviation(run->sensors, f->temp_gen);
+  }
+  t = metrics_stage(run->metrics, METRIC_TEMPERATURE, update);
+
+  if (number > 0)
+  {
+    printf(_(MAGENTA("PSEARCHER:")" Found %d peak(s) in %f sec at "), f->peaks.total_number, f->peak_search_time);
+    show_psearch_info(*conf, run->sensors, f->peaks.total_number);
+    graphics_markers(win, *conf, run->sensors);
+  }
+  graphics_temperature(win, *conf, run->data_temp, run->sensors, run->temp_gen);
+  latency_record_sec(&run->metrics->stage[METRIC_PLOT], plot_time + get_run_time() - t);
+  metrics_stage(run->metrics, METRIC_FRAME, f->start);
+  /* the other stages are still recording, their snapshots are dumped */
+  metrics_snapshot(run->metrics, METRIC_MASK(METRIC_DERIVATIVE) | METRIC_MASK(METRIC_TEMPERATURE) | METRIC_MASK(METRIC_PLOT) | METRIC_MASK(METRIC_FRAME));
+  metrics_poll_snapshot(run->metrics);
+
+  /* steady state starts with the second frame */
+  if (number == 0) run->allocations = MEM_get_memory_allocations();
+  else if (number == conf->generation_max) run->stat->n_allocations = MEM_get_memory_allocations() - run->allocations;
+
+  return 0;
+}
+
+uint32_t
+pipeline_signal(Signal_Run *run)
+{
+  const Signal_Parameters *conf = run->conf;
+  Frame frame[PIPELINE_FRAMES];
+  void *frame_ptr[PIPELINE_FRAMES];
+  uint32_t n_done = 0;
+
+  /* frame buffers are allocated once */
+  for (index_t i = 0; i < PIPELINE_FRAMES; i++)
+  {
+    frame[i].y = MEM_malloc_arrayN(conf->n_points + 1, sizeof(data_t), "pipeline_signal: frame.y");
+    frame[i].peaks.peak = MEM_malloc_arrayN(conf->search.peaks_array_number, sizeof(Peak), "pipeline_signal: frame.peaks");
+    frame[i].peaks.total_number = 0;
+    frame[i].peak = MEM_malloc_arrayN(conf->n_peaks, sizeof(Peak), "pipeline_signal: frame.peak");
+    frame_ptr[i] = &frame[i];
+  }
+
+  Generator_Stage generator = { run, ring_last(run->temp_gen), 0, run->record };
+  const Pipeline_Stage stage[3] = { _pipeline_generate, _pipeline_search, _pipeline_output };
+  void *const stage_data[3] = { &generator, run, run };
+
+  Pipeline *pl = pipeline_new(3, stage, stage_data, frame_ptr, PIPELINE_FRAMES);
+  if (pl != NULL)
+  {
+    n_done = pipeline_run(pl, conf->generation_max + 1);
+    pipeline_free(pl);
+  }
+
+  for (index_t i = 0; i < PIPELINE_FRAMES; i++)
+  {
+    MEM_freeN(frame[i].y);
+    MEM_freeN(frame[i].peaks.peak);
+    MEM_freeN(frame[i].peak);
+  }
+
+  return n_done;
+}
@@ -0,0 +1,40 @@
+#ifndef ENSEN_PIPELINE_H
+#define ENSEN_PIPELINE_H
+
+#include "signal/ensen_signal.h"
+#include "ui/ensen_ui.h"
+#include "thread/ensen_thread_schedule.h"
+#include "io/ensen_io_capture.h"
+#include "io/ensen_io_publish.h"
+
+#include "ensen_exp.h"
+#include "ensen_metrics.h"
+
+#include "ensen_search.h"
+
+/* Frames in flight between generator, peak search and output */
+#define PIPELINE_FRAMES 4
+
+/* State of the run shared by the stages (every field has one writer stage) */
+typedef struct {
+  Signal_Parameters *conf;       /* generator changes peak positions (the others use those of Frame) */
+  Signal_Statistics *stat;       /* output */
+  const Points      *data;       /* wavelength and grid of all frames */
+  Points            *data_temp;  /* output: plot buffers */
+  data_t            *dy_dx;      /* output: derivative plot buffer (NULL - no plot) */
+  Searcher          *searcher;   /* peak search */
+  Sensor_Bank       *sensors;    /* output */
+  Ring              *temp_gen;   /* output */
+  gnuplot_ctrl     **win;        /* output */
+  Schedule          *schedule;   /* generator: frame clock */
+  Exp_Generator     *generator;  /* generator: buffers of signal generation */
+  Capture_Writer    *record;     /* generator: recording of generated frames (NULL - off) */
+  Publisher         *publish;    /* output: shared memory ring of sensor results (NULL - off) */
+  Metrics           *metrics;    /* every stage records its own histograms */
+  size_t             allocations; /* output: allocator counter after the first frame */
+} Signal_Run;
+
+/* Run all frames, the calling thread is the output stage (returns number of frames done) */
+uint32_t pipeline_signal(Signal_Run *run);
+
+#endif
@@ -1,3 +1,14 @@
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#if HAVE_GETTEXT
+  #include <libintl.h>
+  #define _(string) gettext (string)
+#else
+  #define _(string) (string)
+#endif
+
 #include "ensen_plot.h"
 
 void
@@ -78,6 +89,43 @@ graphics_reset(gnuplot_ctrl *win[], const Signal_Parameters conf)
                                  & (win[4] != NULL)) gnuplot_resetplot(win[4]);
 }
 
+void
+graphics_markers(gnuplot_ctrl *win[], const Signal_Parameters conf, const Sensor_Bank *sensors)
+{
+  if (!((conf.plot.show_signal || conf.plot.show_smooth || conf.plot.show_derivative) & conf.plot.show_markers & (win[0] != NULL))) return;
+
+  for (index_t i_sens = 0; i_sens < sensors->n_sensors; i_sens++)
+  {
+    data_t marker_x[2] = { sensors->position[i_sens], sensors->position[i_sens] };
+    data_t marker_y[2] = { conf.plot.y_min, conf.plot.y_max };
+    gnuplot_plot_xy(win[0], marker_x, marker_y, 2, _("Peak marker"));
+  }
+}
+
+void
+graphics_temperature(gnuplot_ctrl *win[], const Signal_Parameters conf, Points *buffer, const Sensor_Bank *sensors, const Ring *temp_gen)
+{
+  if (!(conf.temp.apply & conf.plot.show_temperature)) return;
+
+  gnuplot_cmd(win[2], "set yrange [%d:%g]", 0, (conf.temp.max + 700));
+  /* the history slides when the run is longer than it */
+  const data_t first = temp_gen->count - ring_length(temp_gen);
+  if (conf.generation_max >= conf.history)
+  {
+    gnuplot_cmd(win[2], "set xrange [%g:%g]", first, first + conf.history - 1);
+  }
+  for (index_t i = 0; i < ring_length(temp_gen); i++) buffer->x[i] = first + i;
+
+  if ((conf.search.peak_search_number >= 1) && (conf.search.peak_search_number <= sensors->n_sensors))
+  {
+    char title[32];
+    Ring history = sensor_bank_history(sensors, conf.search.peak_search_number - 1);
+    snprintf(title, sizeof(title), _("T (sensor %d)"), conf.search.peak_search_number);
+    gnuplot_plot_xy(win[2], buffer->x, buffer->y, ring_copy(&history, buffer->y), title);
+  }
+  gnuplot_plot_xy(win[2], buffer->x, buffer->y, ring_copy(temp_gen, buffer->y), _("T (generator)"));
+}
+
 void
 free_gnuplot(Signal_Parameters conf, gnuplot_ctrl **win)
 {
@@ -4,8 +4,13 @@
 #include "signal/ensen_signal.h"
 #include "ui/ensen_ui.h"
 
+/* Windows: signal, derivative, temperature, temperature vs smooth, temperature vs noise */
+#define MAX_NUMBER_OF_PLOTS 5
+
 void graphics_set(gnuplot_ctrl *win[], const Signal_Parameters conf);
 void graphics_reset(gnuplot_ctrl *win[], const Signal_Parameters conf);
+void graphics_markers(gnuplot_ctrl *win[], const Signal_Parameters conf, const Sensor_Bank *sensors);
+void graphics_temperature(gnuplot_ctrl *win[], const Signal_Parameters conf, Points *buffer, const Sensor_Bank *sensors, const Ring *temp_gen);
 void free_gnuplot(Signal_Parameters conf, gnuplot_ctrl **win);
 
 #endif
\ No newline at end of file
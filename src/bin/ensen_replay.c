@@ -0,0 +1,191 @@
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#if HAVE_GETTEXT
+  #include <libintl.h>
+  #define _(string) gettext (string)
+#else
+  #define _(string) (string)
+#endif
+
+#include "ensen_replay.h"
+#include "ensen_conf.h"
+#include "ensen_search.h"
+
+#include "signal/ensen_benchmark.h"
+#include "io/ensen_io_capture.h"
+#include "thread/ensen_thread_pool.h"
+#include "mem/ensen_mem_guarded.h"
+
+/* Result of replay (frames are applied to sensors in order) */
+typedef struct {
+  const Signal_Parameters *conf;
+  const Grid              *grid;
+  Sensor_Bank             *sensors;
+  uint32_t                 n_lost;  /* frames with less peaks than sensors */
+} Replay;
+
+static void
+_replay_frame(Replay *r, const Peaks *peaks)
+{
+  if (peaks->total_number < r->conf->search.peaks_real_number) r->n_lost++;
+  sensor_bank_update(r->sensors, peaks, r->grid, r->conf->temp.coefficient);
+}
+
+/* Frame by frame through the detector selected by config (frames are not copied) */
+static void
+_replay_serial(Replay *r, const Capture *capture, uint64_t n_frames)
+{
+  const Signal_Parameters *conf = r->conf;
+  Searcher searcher;
+  Peaks peaks;
+
+  searcher_init(&searcher, conf, r->grid);
+  peaks.peak = MEM_malloc_arrayN(conf->search.peaks_array_number, sizeof(Peak), "replay_serial: peaks.peak");
+  peaks.total_number = 0;
+  data_t *y = MEM_malloc_arrayN(conf->n_points, sizeof(data_t), "replay_serial: y");
+  data_t *convert = (capture_header(capture)->data_type != CAPTURE_FLOAT64)
+                    ? MEM_malloc_arrayN(conf->n_points, sizeof(data_t), "replay_serial: convert") : NULL;
+
+  for (uint64_t i = 0; i < n_frames; i++)
+  {
+    const data_t *frame = capture_frame(capture, i, convert);
+    const data_t *search = searcher_smooth(&searcher, conf, frame, y, i);
+    searcher_find(&searcher, conf, search, i, &peaks);
+    _replay_frame(r, &peaks);
+  }
+
+  if (convert != NULL) MEM_freeN(convert);
+  MEM_freeN(y);
+  MEM_freeN(peaks.peak);
+  searcher_free(&searcher);
+}
+
+/* Batches of frames smoothed and searched by all workers (derivative detector only: frames are independent) */
+static void
+_replay_parallel(Replay *r, const Capture *capture, uint64_t n_frames, Thread_Pool *pool)
+{
+  const Signal_Parameters *conf = r->conf;
+  const size_t n = conf->n_points;
+  data_t *frame[REPLAY_BATCH_FRAMES];
+  const data_t *source[REPLAY_BATCH_FRAMES];
+  const Signal_Parameters *confs[REPLAY_BATCH_FRAMES];
+  Peaks peaks[REPLAY_BATCH_FRAMES];
+
+  data_t *smoothed = MEM_malloc_arrayN(REPLAY_BATCH_FRAMES * n, sizeof(data_t), "replay_parallel: smoothed");
+  Peak *peak = MEM_malloc_arrayN((size_t)REPLAY_BATCH_FRAMES * conf->search.peaks_array_number, sizeof(Peak), "replay_parallel: peak");
+  data_t *scratch = MEM_malloc_arrayN((size_t)thread_pool_size(pool) * n, sizeof(data_t), "replay_parallel: scratch");
+  data_t *convert = (capture_header(capture)->data_type != CAPTURE_FLOAT64)
+                    ? MEM_malloc_arrayN(REPLAY_BATCH_FRAMES * n, sizeof(data_t), "replay_parallel: convert") : NULL;
+
+  for (index_t f = 0; f < REPLAY_BATCH_FRAMES; f++)
+  {
+    frame[f] = smoothed + f * n;
+    confs[f] = conf;
+    peaks[f].peak = peak + (size_t)f * conf->search.peaks_array_number;
+    peaks[f].total_number = 0;
+  }
+
+  for (uint64_t start = 0; start < n_frames; start += REPLAY_BATCH_FRAMES)
+  {
+    const uint32_t m = (n_frames - start < REPLAY_BATCH_FRAMES) ? n_frames - start : REPLAY_BATCH_FRAMES;
+    for (uint32_t f = 0; f < m; f++)
+    {
+      source[f] = capture_frame(capture, start + f, (convert != NULL) ? convert + f * n : NULL);
+    }
+
+    Peak_Batch batch = { m, frame, confs, peaks, source, scratch };
+    findpeaks_batch(pool, &batch);
+
+    for (uint32_t f = 0; f < m; f++) _replay_frame(r, &peaks[f]);
+  }
+
+  if (convert != NULL) MEM_freeN(convert);
+  MEM_freeN(scratch);
+  MEM_freeN(peak);
+  MEM_freeN(smoothed);
+}
+
+int
+replay_signal(const Ensen_Options *opt)
+{
+  dictionary *ini = config_load(opt->config);
+  if (ini == NULL)
+  {
+    fprintf(stderr, _("cannot parse file: %s\n"), opt->config);
+    return -1;
+  }
+
+  Capture *capture = capture_open(opt->replay);
+  if (capture == NULL)
+  {
+    fprintf(stderr, _("cannot read capture: %s\n"), opt->replay);
+    config_freedict(ini);
+    return -1;
+  }
+
+  Signal_Parameters conf;
+  config_parameters_set(&conf, ini);
+
+  /* frames and their grid are set by capture */
+  Grid grid;
+  capture_grid(capture, &grid);
+  conf.n_points = grid.count;
+
+  uint64_t n_frames = capture_frames(capture);
+  if ((opt->n_frames > 0) && (opt->n_frames < n_frames)) n_frames = opt->n_frames;
+
+  Sensor_Bank sensors;
+  if (sensor_bank_init(&sensors, conf.search.peaks_real_number, conf.history, conf.temp.room) != 0)
+  {
+    fprintf(stderr, _("wrong number of sensors: %d\n"), conf.search.peaks_real_number);
+    capture_close(capture);
+    MEM_freeN(conf.peak);
+    config_freedict(ini);
+    return -1;
+  }
+  Calibration *calibration = NULL;
+  if (config_calibration_load(ini, &conf, &calibration) != 0)
+  {
+    sensor_bank_free(&sensors);
+    capture_close(capture);
+    MEM_freeN(conf.peak);
+    config_freedict(ini);
+    return -1;
+  }
+  sensor_bank_calibrate(&sensors, calibration);
+
+  /* frames are independent for the derivative detector only, the others (and adaptive smoothing) keep state between frames */
+  const bool independent = (conf.search.detector == PEAK_DETECTOR_DERIV) && !conf.search.stream_chunk && !conf.track.apply && !conf.smooth.adaptive;
+  Thread_Pool *pool = ((opt->jobs != 1) && independent) ? thread_pool_new(opt->jobs) : NULL;
+  if ((opt->jobs != 1) && !independent)
+  {
+    fprintf(stderr, _("frames depend on each other for the selected detector or adaptive smoothing, replay is serial\n"));
+  }
+
+  Replay r = { &conf, &grid, &sensors, 0 };
+  const double start_time = get_run_time();
+  if (pool != NULL) _replay_parallel(&r, capture, n_frames, pool);
+  else _replay_serial(&r, capture, n_frames);
+  const double total_time = get_run_time() - start_time;
+
+  /* Report */
+  printf(_("REPLAY: %llu frames of %s in %f sec: %.1f frames/s (%d worker(s))\n"),
+         (unsigned long long)n_frames, opt->replay, total_time, n_frames / total_time,
+         (pool != NULL) ? thread_pool_size(pool) : 1);
+  printf(_("REPLAY: frames with lost peaks: %u\n"), r.n_lost);
+  for (index_t s = 0; s < sensors.n_sensors; s++)
+  {
+    printf(_("REPLAY: sensor %d: temperature %f (position %f)\n"), s + 1, sensors.temperature[s], sensors.position[s]);
+  }
+
+  if (pool != NULL) thread_pool_free(pool);
+  sensor_bank_free(&sensors);
+  calibration_free(calibration);
+  capture_close(capture);
+  MEM_freeN(conf.peak);
+  config_freedict(ini);
+
+  return 0;
+}
@@ -0,0 +1,12 @@
+#ifndef ENSEN_REPLAY_H
+#define ENSEN_REPLAY_H
+
+#include "ensen_private.h"
+#include "ensen.h"
+
+/* Frames searched in parallel at once (their peaks are applied to sensors in order) */
+#define REPLAY_BATCH_FRAMES 64
+
+int replay_signal(const Ensen_Options *opt);
+
+#endif
@@ -0,0 +1,353 @@
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#if HAVE_GETTEXT
+  #include <libintl.h>
+  #define _(string) gettext (string)
+#else
+  #define _(string) (string)
+#endif
+
+#include <math.h>
+#include <string.h>
+
+#include "ensen_search.h"
+#include "signal/ensen_benchmark.h"
+
+#include "mem/ensen_mem_guarded.h"
+
+/* Moving average passes of frame into y (frame may be y), scratch is the other buffer */
+static void
+_smooth_passes(const data_t *frame, data_t *y, data_t *scratch, index_t n, index_t width, index_t level)
+{
+  /* passes alternate between y and the smoothing buffer, so the last one writes y (the first one must not write frame) */
+  data_t *buffer[2] = { y, scratch };
+  index_t k = ((level % 2 == 1) && (frame != y)) ? 0 : 1;
+  View in = view_array((data_t *)frame, n);
+  for (index_t i = 0; i < level; i++)
+  {
+    View out = view_array(buffer[k], n);
+    smooth_view(out, in, width);
+    in = out;
+    k ^= 1;
+  }
+  if (in.data != y) memcpy(y, in.data, sizeof(data_t) * n);
+}
+
+static Smooth_Adaptive *
+_smooth_adaptive_new(const Signal_Parameters *conf, const Grid *grid)
+{
+  Smooth_Adaptive *a = MEM_callocN(sizeof(Smooth_Adaptive), "smooth_adaptive_new: adaptive");
+  const index_t n_sensors = conf->search.peaks_real_number;
+
+  /* level 0 (no smoothing), then the halves of the width of config for every level */
+  a->choice = MEM_malloc_arrayN(1 + (size_t)conf->smooth.level * SMOOTH_ADAPTIVE_WIDTHS, sizeof(Smooth_Choice), "smooth_adaptive_new: choice");
+  for (index_t level = 0; level <= conf->smooth.level; level++)
+  {
+    for (index_t k = SMOOTH_ADAPTIVE_WIDTHS; k-- > 0;)
+    {
+      const index_t width = (level > 0) ? conf->smooth.width >> k : 0;
+      if ((level > 0) && ((width < 2) || ((a->n_choices > 0) && (a->choice[a->n_choices - 1].width == width)))) continue;
+
+      Smooth_Choice *c = &a->choice[a->n_choices++];
+      c->width = width;
+      c->level = level;
+      c->gain  = smooth_derivative_gain(width, level, &c->variance);
+
+      /* every level has the same widths, so the noise is estimated once per width */
+      const index_t block = (width > 1) ? width : 1;
+      for (c->scale = 0; (c->scale < a->n_scales) && (a->scale[c->scale] != block); c->scale++) {}
+      if (c->scale == a->n_scales) a->scale[a->n_scales++] = block;
+      if (level == 0) break;
+    }
+  }
+
+  a->n_sensors     = n_sensors;
+  a->amplitude     = MEM_calloc_arrayN(n_sensors, sizeof(data_t), "smooth_adaptive_new: amplitude");
+  a->peak_variance = MEM_calloc_arrayN(n_sensors, sizeof(data_t), "smooth_adaptive_new: peak_variance");
+  a->offset        = MEM_calloc_arrayN(n_sensors, sizeof(data_t), "smooth_adaptive_new: offset");
+  a->raw           = MEM_malloc_arrayN(conf->n_points, sizeof(data_t), "smooth_adaptive_new: raw");
+  a->reference.peak = MEM_malloc_arrayN(conf->search.peaks_array_number, sizeof(Peak), "smooth_adaptive_new: reference");
+  a->reference.total_number = 0;
+  a->target        = (grid->step > 0) ? conf->smooth.target / grid->step : 0;
+  return a;
+}
+
+static void
+_smooth_adaptive_free(Smooth_Adaptive *a)
+{
+  if (a == NULL) return;
+
+  MEM_freeN(a->choice);
+  MEM_freeN(a->amplitude);
+  MEM_freeN(a->peak_variance);
+  MEM_freeN(a->offset);
+  MEM_freeN(a->raw);
+  MEM_freeN(a->reference.peak);
+  MEM_freeN(a);
+}
+
+/*
+ * Position error of the zero crossing of the derivative (points): noise of
+ * the derivative over the curvature of the smoothed peak. Peaks are taken
+ * as Gaussians, smoothing adds the kernel variance to the peak variance.
+ * The worst sensor counts, a sensor of unknown shape needs the strongest smoothing.
+ */
+static data_t
+_smooth_adaptive_error(const Smooth_Adaptive *a, const Smooth_Choice *c, data_t noise)
+{
+  data_t error = 0;
+  for (index_t k = 0; k < a->n_sensors; k++)
+  {
+    if (a->peak_variance[k] <= 0) return INFINITY;
+
+    const data_t variance = a->peak_variance[k] + c->variance;
+    const data_t curvature = a->amplitude[k] * sqrt(a->peak_variance[k]) / (variance * sqrt(variance));
+    const data_t e = c->gain * noise / curvature;
+    if (e > error) error = e;
+  }
+  return error;
+}
+
+/*
+ * The cheapest smoothing which meets the target at the noise of frame. The
+ * noise is taken at the width of every choice (stats_noise()), so colored
+ * noise is weighted as the smoothing passes it; it is estimated at most
+ * once per width, when a choice of the width is first tried. Smoothing is lowered only
+ * if the cheaper one meets half of the target, so noise near the target
+ * does not switch it every frame.
+ */
+static const Smooth_Choice *
+_smooth_adaptive_choose(Smooth_Adaptive *a, const Signal_Parameters *conf, const data_t *frame, data_t *scratch)
+{
+  const Smooth_Choice *choice = &a->choice[a->n_choices - 1];
+
+  for (index_t k = 0; k < a->n_scales; k++) a->scale_noise[k] = -1;
+  for (index_t i = 0; i < a->n_choices; i++)
+  {
+    const Smooth_Choice *c = &a->choice[i];
+    data_t *noise_ptr = &a->scale_noise[c->scale];
+    if (*noise_ptr < 0) *noise_ptr = stats_noise(frame, conf->n_points, a->scale[c->scale], conf->search.threshold_amp, scratch);
+    const data_t noise = *noise_ptr;
+    if (i == 0) a->noise = noise;
+
+    const data_t target = ((a->last != NULL) && (c < a->last)) ? a->target / 2 : a->target;
+    if (_smooth_adaptive_error(a, c, noise) <= target)
+    {
+      choice = c;
+      break;
+    }
+  }
+
+  a->previous = ((a->last != NULL) && (choice != a->last)) ? a->last : NULL;
+  a->last = choice;
+  a->passes += choice->level;
+  a->frames++;
+  return choice;
+}
+
+/*
+ * Peak shapes of the smoothed frame: the Gaussian variance is
+ * -m^2 / (2 ln r), r is the mean of the points at +-m over the peak; m is
+ * the last width, so it adapts in two steps. The kernel variance of the
+ * frame is removed, so shapes do not depend on the smoothing.
+ */
+static void
+_smooth_adaptive_shapes(Smooth_Adaptive *a, const data_t *y, index_t n_points, const Peaks *peaks)
+{
+  if ((a->last == NULL) || (peaks->total_number != a->n_sensors)) return;
+
+  for (index_t k = 0; k < a->n_sensors; k++)
+  {
+    const index_t i = (index_t)(peaks->peak[k].position + 0.5);
+    if ((i == 0) || (i >= n_points - 1) || (y[i] <= 0)) continue;
+
+    data_t variance = (a->peak_variance[k] > 0) ? a->peak_variance[k] + a->last->variance : 64;
+    bool valid = false;
+    for (index_t step = 0; step < 2; step++)
+    {
+      index_t m = (index_t)(sqrt(variance) + 0.5);
+      if (m < 1) m = 1;
+      if (m > i) m = i;
+      if (i + m >= n_points) m = n_points - 1 - i;
+
+      const data_t r = (y[i - m] + y[i + m]) / (2 * y[i]);
+      valid = (r > 0) && (r < 1);
+      if (!valid) break;
+      variance = -(data_t)m * m / (2 * log(r));
+    }
+
+    const data_t peak_variance = variance - a->last->variance;
+    if (!valid || (peak_variance <= 0)) continue;
+
+    /* amplitude before smoothing: smoothing keeps the area */
+    const data_t amplitude = y[i] * sqrt(variance / peak_variance);
+    if (a->peak_variance[k] <= 0)
+    {
+      a->peak_variance[k] = peak_variance;
+      a->amplitude[k] = amplitude;
+    }
+    else
+    {
+      a->peak_variance[k] += (peak_variance - a->peak_variance[k]) / 4;
+      a->amplitude[k] += (amplitude - a->amplitude[k]) / 4;
+    }
+  }
+}
+
+/*
+ * Smoothing shifts the peaks: the index of the moving average and the skew
+ * of peaks (exponential broadening) move their maximum by up to a few
+ * points per setting, and sensors integrate the changes of positions. At
+ * a change of smoothing the frame is searched at both settings and the
+ * difference is added to the offsets, so positions stay in the
+ * coordinates of the smoothing of the first frame.
+ */
+static void
+_smooth_adaptive_offset(Smooth_Adaptive *a, const Signal_Parameters *conf, data_t *scratch, Peaks *peaks)
+{
+  if (a->previous != NULL)
+  {
+    _smooth_passes(a->raw, a->raw, scratch, conf->n_points, a->previous->width, a->previous->level);
+    findpeaks(a->raw, &a->reference, conf);
+    if ((a->reference.total_number == a->n_sensors) && (peaks->total_number == a->n_sensors))
+    {
+      for (index_t k = 0; k < a->n_sensors; k++) a->offset[k] += a->reference.peak[k].position - peaks->peak[k].position;
+    }
+    a->previous = NULL;
+  }
+
+  const index_t n = (peaks->total_number < a->n_sensors) ? peaks->total_number : a->n_sensors;
+  for (index_t k = 0; k < n; k++) peaks->peak[k].position += a->offset[k];
+}
+
+void
+searcher_init(Searcher *s, const Signal_Parameters *conf, const Grid *grid)
+{
+  s->stream = (conf->search.stream_chunk && !conf->plot.show_vs_smooth) ? peak_stream_new(conf) : NULL;
+
+  s->cwt = NULL;
+  if ((s->stream == NULL) && (conf->search.detector == PEAK_DETECTOR_CWT))
+  {
+    s->cwt = cwt_plan_new(conf->n_points, conf->search.cwt_scales, conf->search.cwt_scales_number);
+    if (s->cwt == NULL) fprintf(stderr, _("Wrong wavelet scales, derivative peak search is used\n"));
+  }
+
+  s->xcorr = NULL;
+  s->xcorr_frame = NULL;
+  if ((s->stream == NULL) && (conf->search.detector == PEAK_DETECTOR_XCORR))
+  {
+    s->xcorr = xcorr_tracker_new(conf->search.xcorr_window, conf->search.xcorr_range, conf->search.peaks_real_number);
+    if (s->xcorr == NULL) fprintf(stderr, _("Wrong cross-correlation window, derivative peak search is used\n"));
+    else s->xcorr_frame = MEM_malloc_arrayN(conf->n_points, sizeof(data_t), "searcher_init: xcorr_frame");
+  }
+
+  s->smoothed = MEM_malloc_arrayN(conf->n_points, sizeof(data_t), "searcher_init: smoothed");
+
+  /* only the derivative detector smooths frames; the offsets are of found positions, not tracked ones */
+  s->adaptive = NULL;
+  if (conf->smooth.adaptive && (s->stream == NULL) && (s->cwt == NULL) && (s->xcorr == NULL) && !conf->track.apply)
+  {
+    s->adaptive = _smooth_adaptive_new(conf, grid);
+  }
+
+  s->tracker = NULL;
+  if (conf->track.apply)
+  {
+    s->tracker = MEM_malloc_arrayN(conf->search.peaks_real_number, sizeof(Tracker), "searcher_init: tracker");
+    for (index_t i = 0; i < conf->search.peaks_real_number; i++)
+    {
+      tracker_init(&s->tracker[i], conf->track.process_noise, conf->track.measurement_noise, conf->track.gate);
+    }
+  }
+}
+
+void
+searcher_free(Searcher *s)
+{
+  peak_stream_free(s->stream);
+  cwt_plan_free(s->cwt);
+  xcorr_tracker_free(s->xcorr);
+  if (s->tracker != NULL) MEM_freeN(s->tracker);
+  if (s->xcorr_frame != NULL) MEM_freeN(s->xcorr_frame);
+  MEM_freeN(s->smoothed);
+  _smooth_adaptive_free(s->adaptive);
+}
+
+const data_t *
+searcher_smooth(Searcher *s, const Signal_Parameters *conf, const data_t *frame, data_t *y, uint32_t number)
+{
+  const index_t n = conf->n_points;
+
+  /* the online and wavelet detectors do not need smoothing, cross-correlation uses only the first frame */
+  if ((s->stream != NULL) || (s->cwt != NULL) || ((s->xcorr != NULL) && (number > 0))) return frame;
+
+  if (s->xcorr != NULL) memcpy(s->xcorr_frame, frame, sizeof(data_t) * n);
+
+  index_t width = conf->smooth.width, level = conf->smooth.level;
+  if (s->adaptive != NULL)
+  {
+    const Smooth_Choice *c = _smooth_adaptive_choose(s->adaptive, conf, frame, s->smoothed);
+    width = c->width;
+    level = c->level;
+
+    /* the frame is searched at the previous smoothing too (smoothing may be in place) */
+    if (s->adaptive->previous != NULL) memcpy(s->adaptive->raw, frame, sizeof(data_t) * n);
+  }
+
+  _smooth_passes(frame, y, s->smoothed, n, width, level);
+  return y;
+}
+
+data_t
+searcher_find(Searcher *s, const Signal_Parameters *conf, const data_t *y, uint32_t frame, Peaks *peaks)
+{
+  data_t time = 0;
+
+  if (s->stream != NULL)
+  {
+    /* Frame arrives by chunks (as from DMA), search time includes smoothing */
+    double start_time = get_run_time();
+    peaks->total_number = 0;
+    peak_stream_reset(s->stream);
+    for (uint32_t offset = 0; offset < conf->n_points; offset += conf->search.stream_chunk)
+    {
+      index_t chunk = (conf->n_points - offset < conf->search.stream_chunk) ? conf->n_points - offset : conf->search.stream_chunk;
+      peak_stream_push(s->stream, y + offset, chunk, peaks);
+    }
+    time = get_run_time() - start_time;
+  }
+  else if (s->cwt != NULL)
+  {
+    time = cwt_findpeaks(s->cwt, y, peaks, conf);
+  }
+  else if ((s->xcorr != NULL) && (frame > 0))
+  {
+    time = xcorr_track(s->xcorr, y, conf->n_points, peaks);
+  }
+  else
+  {
+    time = findpeaks(y, peaks, conf);
+    if ((s->xcorr != NULL) && (xcorr_tracker_start(s->xcorr, s->xcorr_frame, conf->n_points, peaks) != 0))
+    {
+      fprintf(stderr, _("Not enough peaks to track, derivative peak search is used\n"));
+      xcorr_tracker_free(s->xcorr);
+      s->xcorr = NULL;
+    }
+  }
+
+  /* Filter peak positions (search window is predicted from the previous measurements) */
+  if (s->tracker != NULL)
+  {
+    tracker_peaks(s->tracker, conf->search.peaks_real_number, peaks, y, conf->n_points, conf->track.refine);
+  }
+
+  if (s->adaptive != NULL)
+  {
+    _smooth_adaptive_shapes(s->adaptive, y, conf->n_points, peaks);
+    _smooth_adaptive_offset(s->adaptive, conf, s->smoothed, peaks);
+  }
+
+  return time;
+}
@@ -0,0 +1,57 @@
+#ifndef ENSEN_SEARCH_H
+#define ENSEN_SEARCH_H
+
+#include "signal/ensen_signal.h"
+
+/* Smoothing tried by the adaptive mode */
+typedef struct {
+  index_t width;
+  index_t level;
+  data_t  gain;       /* noise of the derivative per noise of the frame (smooth_derivative_gain()) */
+  data_t  variance;   /* of the smoothing kernel (points^2) */
+  index_t scale;      /* of its noise estimate (Smooth_Adaptive.scale) */
+} Smooth_Choice;
+
+/* Widths of a level of the adaptive mode: the width of config and its halves */
+#define SMOOTH_ADAPTIVE_WIDTHS 4
+
+/* Smoothing chosen by the noise of every frame and the peak shapes of the previous frames */
+typedef struct {
+  Smooth_Choice       *choice;         /* by cost: levels ascending, then widths ascending */
+  index_t              n_choices;
+  index_t              scale[SMOOTH_ADAPTIVE_WIDTHS + 1];        /* blocks of the noise estimates (points): 1 and the widths */
+  data_t               scale_noise[SMOOTH_ADAPTIVE_WIDTHS + 1];  /* estimates of the frame (< 0 - not made yet) */
+  index_t              n_scales;
+  index_t              n_sensors;
+  data_t              *amplitude;      /* peak of every sensor before smoothing */
+  data_t              *peak_variance;  /* Gaussian variance of the peak before smoothing (points^2, 0 - unknown) */
+  data_t               target;         /* position error (points) */
+  data_t               noise;          /* of the points of the last frame (stats_noise()) */
+  const Smooth_Choice *last;           /* smoothing of the last frame */
+  const Smooth_Choice *previous;       /* smoothing before the last frame if it was changed, NULL - not changed */
+  data_t              *raw;            /* the last frame before smoothing if the smoothing was changed */
+  Peaks                reference;      /* peaks of raw at the previous smoothing */
+  data_t              *offset;         /* of positions of every sensor to those of the smoothing of the first frame (points) */
+  uint64_t             passes;         /* smoothing passes of all frames */
+  uint32_t             frames;
+} Smooth_Adaptive;
+
+/* Peak detector selected by config with its cached state */
+typedef struct {
+  Peak_Stream   *stream;       /* online search (smoothing is done by the detector) */
+  Cwt_Plan      *cwt;          /* wavelet search (no smoothing) */
+  Xcorr_Tracker *xcorr;        /* cross-correlation tracking of the peaks of the first frame */
+  data_t        *xcorr_frame;  /* the first frame before smoothing */
+  Tracker       *tracker;      /* filter of peak positions (one per sensor) */
+  data_t        *smoothed;     /* smoothing buffer (frames are not allocated) */
+  Smooth_Adaptive *adaptive;   /* smoothing chosen by noise of frame (NULL - width and level of config) */
+} Searcher;
+
+/* Frames are of grid (the target of adaptive smoothing is taken in its points) */
+void searcher_init(Searcher *s, const Signal_Parameters *conf, const Grid *grid);
+void searcher_free(Searcher *s);
+/* Smooth frame into y (frame may be y), returns frame to search: y, or frame itself if the detector does not smooth */
+const data_t *searcher_smooth(Searcher *s, const Signal_Parameters *conf, const data_t *frame, data_t *y, uint32_t number);
+data_t searcher_find(Searcher *s, const Signal_Parameters *conf, const data_t *y, uint32_t frame, Peaks *peaks);
+
+#endif
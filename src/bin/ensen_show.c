@@ -1,13 +1,25 @@
+#include <math.h>
+
 #include "ensen_show.h"
 
 void
-show_statistics(Signal_Parameters conf, Signal_Statistics stat, Points temp_gen, Points temp_sens_1, Points temp_sens_2, Points temp_sens_3, Points temp_sens_4)
+show_statistics(Signal_Parameters conf, Signal_Statistics stat, data_t temp_gen, const Sensor_Bank *sensors, const Metrics *metrics)
 {
-  index_t i = 0;
   printf("\n");
-  printf(BLUE("STATISTUS:")" Generation time:\t%f sec\n", stat.generation_time); // the last generation time
-  printf(BLUE("STATISTUS:")" Max search freq:\t%f kHz\n", (1/stat.peak_search_time)/1000); // the last generation time
+  const Latency_Histogram *search = &(*metrics).stage[METRIC_SEARCH];
+  printf(BLUE("STATISTUS:")" Generation time:\t%f sec (median)\n", 1e-9 * latency_percentile(&(*metrics).stage[METRIC_GENERATE], 50));
+  if ((*search).count > 0)
+  {
+    printf(BLUE("STATISTUS:")" Max search freq:\t%f kHz (median), %f kHz (p99)\n",
+           1e6 / latency_percentile(search, 50), 1e6 / latency_percentile(search, 99));
+  }
   printf(BLUE("STATISTUS:")" Number of drops:\t%d\n", stat.n_drops);
+  printf(BLUE("STATISTUS:")" Missed deadlines:\t%u (at %d Hz)\n", stat.n_missed, conf.generation_frequency);
+  printf(BLUE("STATISTUS:")" Period jitter:\t%f ms (max %f ms)\n", 1e3 * stat.jitter, 1e3 * stat.jitter_max);
+  if (conf.rt.apply)
+  {
+    printf(BLUE("STATISTUS:")" Heap allocations:\t%u (after the first frame)\n", stat.n_allocations);
+  }
   if (conf.noise.amplitude > 0)
   {
     if (conf.noise.color == 1) printf(BLUE("STATISTUS:")" Noise color    :\t1 - white\n");
@@ -23,44 +35,20 @@ show_statistics(Signal_Parameters conf, Signal_Statistics stat, Points temp_gen,
     printf(BLUE("STATISTUS:")" Rise of T[step]:\t- (no temperature rise)\n");
   printf(BLUE("STATISTUS:")" Sensor number #:\t%d\n", conf.search.peak_search_number);
 
-  switch (conf.search.peak_search_number)
-  {
-    case 1:
-      printf(BLUE("STATISTUS:")" End temperature:\t%f (generator: %f)\n", temp_sens_1.y[conf.generation_max], temp_gen.y[conf.generation_max]);
-      break;
-    case 2:
-      printf(BLUE("STATISTUS:")" End temperature:\t%f (generator: %f)\n", temp_sens_2.y[conf.generation_max], temp_gen.y[conf.generation_max]);
-      break;
-    case 3:
-      printf(BLUE("STATISTUS:")" End temperature:\t%f (generator: %f)\n", temp_sens_3.y[conf.generation_max], temp_gen.y[conf.generation_max]);
-      break;
-    case 4:
-      printf(BLUE("STATISTUS:")" End temperature:\t%f (generator: %f)\n", temp_sens_4.y[conf.generation_max], temp_gen.y[conf.generation_max]);
-      break;
-  }
+  if ((conf.search.peak_search_number < 1) || (conf.search.peak_search_number > (*sensors).n_sensors)) return;
 
-  data_t diff[conf.generation_max];
-  switch (conf.search.peak_search_number)
-  {
-    case 1:
-      for (i = 0; i <= conf.generation_max; i++) diff[i] = temp_sens_1.y[i] - temp_gen.y[i];
-      break;
-    case 2:
-      for (i = 0; i <= conf.generation_max; i++) diff[i] = temp_sens_2.y[i] - temp_gen.y[i];
-      break;
-    case 3:
-      for (i = 0; i <= conf.generation_max; i++) diff[i] = temp_sens_3.y[i] - temp_gen.y[i];
-      break;
-    case 4:
-      for (i = 0; i <= conf.generation_max; i++) diff[i] = temp_sens_4.y[i] - temp_gen.y[i];
-      break;
-  }
-  printf(BLUE("STATISTUS:")" Max temp deviation:\t[%f, %f]\n", max(diff, conf.generation_max + 1), min(diff, conf.generation_max + 1));
-  printf(BLUE("STATISTUS:")" Min temp deviation:\t%f\n", min_abs(diff, conf.generation_max + 1));
+  const index_t s = conf.search.peak_search_number - 1;
+  printf(BLUE("STATISTUS:")" End temperature:\t%f (generator: %f)\n", (*sensors).temperature[s], temp_gen);
+
+  /* the first frame is the reference (no deviation by definition) */
+  if ((*sensors).dev_count == 0) return;
+  printf(BLUE("STATISTUS:")" Max temp deviation:\t[%f, %f]\n", (*sensors).dev_max[s], (*sensors).dev_min[s]);
+  printf(BLUE("STATISTUS:")" Min temp deviation:\t%f\n", (*sensors).dev_abs_min[s]);
+  printf(BLUE("STATISTUS:")" Mean temp deviation:\t%f +- %f\n", (*sensors).dev_mean[s], sqrt(sensor_bank_deviation_variance(sensors, s)));
 }
 
 void
-show_generator_info(const Signal_Parameters conf, const Signal_Statistics stat, const index_t n_step)
+show_generator_info(const Signal_Parameters conf, const Signal_Statistics stat, const uint32_t n_step)
 {
   index_t i = 0;
 
@@ -83,49 +71,28 @@ show_generator_info(const Signal_Parameters conf, const Signal_Statistics stat,
 }
 
 void
-show_psearch_info(const Signal_Parameters conf, const index_t i_gen, const index_t i_sens, const index_t n_peaks,
-                  const Points temp_sens_1, const Points temp_sens_2, const Points temp_sens_3, const Points temp_sens_4)
+show_psearch_info(const Signal_Parameters conf, const Sensor_Bank *sensors, const index_t n_peaks)
 {
-  data_t value = 0.f;
-
-  if (i_sens == 0) printf("[ ");
+  const index_t n = conf.search.peaks_real_number;
 
   /* Show temperature */
-  switch (i_sens)
+  printf("[ ");
+  for (index_t i_sens = 0; i_sens < (*sensors).n_sensors; i_sens++)
   {
-    case 0:
-      value = temp_sens_1.y[i_gen];
-      break;
-    case 1:
-      value = temp_sens_2.y[i_gen];
-      break;
-    case 2:
-      value = temp_sens_3.y[i_gen];
-      break;
-    case 3:
-      value = temp_sens_4.y[i_gen];
-      break;
-    default:
-      break;
+    printf((i_sens != (*sensors).n_sensors - 1) ? "%f, " : "%f", (*sensors).temperature[i_sens]);
   }
 
-  // format output data string
-  printf((i_sens != conf.search.peaks_real_number - 1) ? "%f, " : "%f", value);
-
   // show the note about found and real number of peaks
-  if (i_sens == conf.search.peaks_real_number - 1)
+  if (n_peaks == n)
+  {
+    printf(" ] -> "GREEN("[%d of %d]\n"), n, n_peaks);
+  }
+  else if (n_peaks < n)
+  {
+    printf(" ] -> "YELLOW("[%d of %d]\n"), n, n_peaks);
+  }
+  else
   {
-    if (n_peaks == conf.search.peaks_real_number)
-    {
-      printf(" ] -> "GREEN("[%d of %d]\n"), conf.search.peaks_real_number, n_peaks);
-    }
-    else if (n_peaks < conf.search.peaks_real_number)
-    {
-      printf(" ] -> "YELLOW("[%d of %d]\n"), conf.search.peaks_real_number, n_peaks);
-    }
-    else
-    {
-      printf(" ] -> "RED("[%d of %d]\n"), conf.search.peaks_real_number, n_peaks);
-    }
+    printf(" ] -> "RED("[%d of %d]\n"), n, n_peaks);
   }
 }
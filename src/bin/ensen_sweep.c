@@ -0,0 +1,289 @@
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#if HAVE_GETTEXT
+  #include <libintl.h>
+  #define _(string) gettext (string)
+#else
+  #define _(string) (string)
+#endif
+
+#include <math.h>
+#include <pthread.h>
+#include <stdlib.h>
+
+#include "ensen_sweep.h"
+#include "ensen_conf.h"
+#include "ensen_data.h"
+#include "ensen_exp.h"
+#include "ensen_search.h"
+
+#include "signal/ensen_benchmark.h"
+#include "thread/ensen_thread_pool.h"
+#include "mem/ensen_mem_guarded.h"
+
+static const char *sweep_key[SWEEP_AXES]  = { "sweep:noise.amplitude", "sweep:noise.color", "sweep:smooth.width", "sweep:smooth.level", "sweep:detector" };
+static const char *sweep_name[SWEEP_AXES] = { "amplitude", "color", "width", "level", "detector" };
+
+/* Error of sensor temperature (found - generated) of a trial, then of all trials of a point */
+typedef struct {
+  uint64_t count;    /* temperatures compared */
+  data_t   mean;
+  data_t   m2;       /* sum of squared differences from the mean */
+  data_t   max_abs;
+  uint32_t n_lost;   /* frames with less peaks than sensors */
+} Sweep_Error;
+
+/* Buffers of a worker (generators are made before the run: FFT planning is not thread safe) */
+typedef struct {
+  Exp_Generator *generator;
+  Points         data;     /* x and grid are shared by all workers */
+  Peak          *peak;     /* generated peaks of the trial */
+  Peaks          found;
+} Sweep_Worker;
+
+typedef struct {
+  const Signal_Parameters *conf;  /* base parameters */
+  Sweep_List      list[SWEEP_AXES];
+  uint32_t        n_points;       /* points of the grid */
+  uint32_t        n_trials;       /* trials of every point */
+  uint32_t        n_frames;       /* frames of every trial */
+  uint64_t        seed;
+  Sweep_Worker   *worker;
+  Sweep_Error    *error;          /* n_points x n_trials, a trial writes only its own */
+  pthread_mutex_t plan_lock;      /* searchers of the wavelet and cross-correlation detectors make FFT plans */
+} Sweep;
+
+/* List of numbers separated by spaces, the value of the base config if there is no list */
+static void
+_sweep_list_read(Sweep_List *list, const dictionary *ini, const char *key, data_t def)
+{
+  const char *s = config_getstring(ini, key, "");
+  char *end = NULL;
+  list->n_values = 0;
+  while (list->n_values < SWEEP_VALUES_MAX)
+  {
+    data_t value = strtod(s, &end);
+    if (end == s) break;
+    list->value[list->n_values++] = value;
+    s = end;
+  }
+  if (list->n_values == 0) list->value[list->n_values++] = def;
+}
+
+/* Values of the grid point (the last parameter changes the fastest) */
+static void
+_sweep_point(const Sweep *sw, uint32_t point, data_t value[SWEEP_AXES])
+{
+  for (int a = SWEEP_AXES - 1; a >= 0; a--)
+  {
+    value[a] = sw->list[a].value[point % sw->list[a].n_values];
+    point /= sw->list[a].n_values;
+  }
+}
+
+static void
+_sweep_set(Signal_Parameters *conf, const data_t value[SWEEP_AXES])
+{
+  conf->noise.amplitude = value[SWEEP_NOISE_AMPLITUDE];
+  conf->noise.color     = (index_t)value[SWEEP_NOISE_COLOR];
+  conf->smooth.width    = (index_t)value[SWEEP_SMOOTH_WIDTH];
+  conf->smooth.level    = (index_t)value[SWEEP_SMOOTH_LEVEL];
+  conf->search.detector = (index_t)value[SWEEP_DETECTOR];
+}
+
+/* Parallel update of mean and m2 (Chan et al.) */
+static void
+_sweep_error_merge(Sweep_Error *a, const Sweep_Error *b)
+{
+  a->n_lost += b->n_lost;
+  if (b->count == 0) return;
+
+  const uint64_t n = a->count + b->count;
+  const data_t delta = b->mean - a->mean;
+  a->mean += delta * b->count / n;
+  a->m2 += b->m2 + delta * delta * ((data_t)a->count * b->count / n);
+  a->count = n;
+  a->max_abs = fmax(a->max_abs, b->max_abs);
+}
+
+/* One Monte Carlo trial: the temperature ramp of config over all frames, noise of stream "task" */
+static void
+_sweep_trial(void *data, uint32_t task, index_t worker)
+{
+  Sweep *sw = data;
+  Sweep_Worker *w = &sw->worker[worker];
+  Sweep_Error *e = &sw->error[task];
+  Signal_Parameters conf = *sw->conf;
+  data_t value[SWEEP_AXES];
+
+  _sweep_point(sw, task / sw->n_trials, value);
+  _sweep_set(&conf, value);
+  conf.peak = w->peak;
+  for (index_t i = 0; i < conf.n_peaks; i++) conf.peak[i] = sw->conf->peak[i];
+  exp_generator_seed(w->generator, sw->seed, task);
+
+  Searcher searcher;
+  Sensor_Bank sensors;
+  pthread_mutex_lock(&sw->plan_lock);
+  searcher_init(&searcher, &conf, &w->data.grid);
+  pthread_mutex_unlock(&sw->plan_lock);
+  sensor_bank_init(&sensors, conf.search.peaks_real_number, 1, conf.temp.room);
+
+  const data_t delta_temp = (conf.temp.apply && (sw->n_frames > 1)) ? (conf.temp.max - conf.temp.room) / (sw->n_frames - 1) : 0;
+  data_t temp_gen = conf.temp.room;
+  Sweep_Error trial = { 0, 0, 0, 0, 0 };
+
+  for (uint32_t f = 0; f < sw->n_frames; f++)
+  {
+    if (f > 0)
+    {
+      for (index_t i = 0; i < conf.n_peaks; i++) conf.peak[i].position += delta_temp * conf.temp.coefficient;
+      temp_gen += delta_temp;
+    }
+
+    data_clear(w->data.y, conf.n_points);
+    signal_generate_exp(w->generator, &w->data, conf.n_peaks, conf.peak, conf.noise, conf.n_points);
+    const data_t *y = searcher_smooth(&searcher, &conf, w->data.y, w->data.y, f);
+    searcher_find(&searcher, &conf, y, f, &w->found);
+    sensor_bank_update(&sensors, &w->found, &w->data.grid, conf.temp.coefficient);
+    if (w->found.total_number < conf.search.peaks_real_number) trial.n_lost++;
+
+    /* the first frame sets the reference positions */
+    if (f == 0) continue;
+    for (index_t s = 0; s < sensors.n_sensors; s++)
+    {
+      const data_t d = sensors.temperature[s] - temp_gen;
+      const data_t delta = d - trial.mean;
+      trial.count++;
+      trial.mean += delta / trial.count;
+      trial.m2 += delta * (d - trial.mean);
+      trial.max_abs = fmax(trial.max_abs, fabs(d));
+    }
+  }
+  *e = trial;
+
+  sensor_bank_free(&sensors);
+  pthread_mutex_lock(&sw->plan_lock);
+  searcher_free(&searcher);
+  pthread_mutex_unlock(&sw->plan_lock);
+}
+
+static void
+_sweep_write(FILE *f, const Sweep *sw, uint32_t point, const Sweep_Error *e)
+{
+  data_t value[SWEEP_AXES];
+  _sweep_point(sw, point, value);
+  const data_t var = (e->count > 0) ? e->m2 / e->count : 0;
+  fprintf(f, "%10g %6d %6d %6d %9d %14.6g %14.6g %14.6g %14.6g %10.4f\n",
+          value[SWEEP_NOISE_AMPLITUDE], (int)value[SWEEP_NOISE_COLOR], (int)value[SWEEP_SMOOTH_WIDTH],
+          (int)value[SWEEP_SMOOTH_LEVEL], (int)value[SWEEP_DETECTOR],
+          e->mean, sqrt(var), sqrt(e->mean * e->mean + var), e->max_abs,
+          (data_t)e->n_lost / ((data_t)sw->n_trials * sw->n_frames));
+}
+
+int
+sweep_signal(const Ensen_Options *opt)
+{
+  dictionary *ini = config_load(opt->config);
+  if (ini == NULL)
+  {
+    fprintf(stderr, _("cannot parse file: %s\n"), opt->config);
+    return -1;
+  }
+
+  Signal_Parameters conf;
+  config_parameters_set(&conf, ini);
+
+  Sweep sw;
+  sw.conf = &conf;
+  const data_t def[SWEEP_AXES] = { conf.noise.amplitude, conf.noise.color, conf.smooth.width, conf.smooth.level, conf.search.detector };
+  sw.n_points = 1;
+  for (index_t a = 0; a < SWEEP_AXES; a++)
+  {
+    _sweep_list_read(&sw.list[a], ini, sweep_key[a], def[a]);
+    sw.n_points *= sw.list[a].n_values;
+  }
+  sw.n_trials = config_getint(ini, "sweep:trials", 16);
+  sw.n_frames = (opt->n_frames > 0) ? opt->n_frames : (uint32_t)config_getint(ini, "sweep:frames", 20);
+  sw.seed     = config_getint(ini, "sweep:seed", 1);
+  const char *output = config_getstring(ini, "sweep:output", "sweep.dat");
+
+  FILE *f = fopen(output, "w");
+  Thread_Pool *pool = (f != NULL) ? thread_pool_new(opt->jobs) : NULL;
+  if ((pool == NULL) || (sw.n_trials == 0) || (conf.search.peaks_real_number == 0))
+  {
+    if (f == NULL) fprintf(stderr, _("cannot write sweep table to %s\n"), output);
+    else fprintf(stderr, _("cannot start sweep: no workers, trials or sensors\n"));
+    if (f != NULL) fclose(f);
+    if (pool != NULL) thread_pool_free(pool);
+    MEM_freeN(conf.peak);
+    config_freedict(ini);
+    return -1;
+  }
+
+  /* frames of all workers share wavelength and grid */
+  Grid grid;
+  grid_uniform_set(&grid, conf.plot.x_min, conf.plot.x_max, conf.n_points);
+  data_t *x = MEM_malloc_arrayN(conf.n_points + 1, sizeof(data_t), "sweep_signal: x");
+  grid_fill(&grid, x);
+
+  const index_t n_workers = thread_pool_size(pool);
+  sw.worker = MEM_calloc_arrayN(n_workers, sizeof(Sweep_Worker), "sweep_signal: worker");
+  for (index_t k = 0; k < n_workers; k++)
+  {
+    Sweep_Worker *w = &sw.worker[k];
+    w->generator = exp_generator_new(conf.n_points);
+    w->data.x = x;
+    w->data.y = MEM_malloc_arrayN(conf.n_points + 1, sizeof(data_t), "sweep_signal: y");
+    w->data.grid = grid;
+    w->peak = MEM_malloc_arrayN(conf.n_peaks, sizeof(Peak), "sweep_signal: peak");
+    w->found.peak = MEM_malloc_arrayN(conf.search.peaks_array_number, sizeof(Peak), "sweep_signal: found");
+    w->found.total_number = 0;
+  }
+  sw.error = MEM_malloc_arrayN((size_t)sw.n_points * sw.n_trials, sizeof(Sweep_Error), "sweep_signal: error");
+  pthread_mutex_init(&sw.plan_lock, NULL);
+
+  /* every trial is a task, its noise depends only on seed and task, not on the worker */
+  printf(_("SWEEP: %u point(s) x %u trial(s) x %u frame(s) on %d worker(s)\n"), sw.n_points, sw.n_trials, sw.n_frames, n_workers);
+  const double start_time = get_run_time();
+  thread_pool_run(pool, sw.n_points * sw.n_trials, _sweep_trial, &sw);
+  const double total_time = get_run_time() - start_time;
+
+  /* trials are merged in order, so the table does not depend on the number of workers */
+  fprintf(f, "# ensen sweep: %u trial(s) of %u frame(s) per point, seed %llu\n", sw.n_trials, sw.n_frames, (unsigned long long)sw.seed);
+  fprintf(f, "# error of sensor temperature (found - generated): mean, sd, rms, max |error|; lost: frames with lost peaks\n");
+  FILE *table[2] = { f, stdout };
+  for (index_t k = 0; k < 2; k++)
+  {
+    fprintf(table[k], "#%9s %6s %6s %6s %9s %14s %14s %14s %14s %10s\n", sweep_name[0], sweep_name[1], sweep_name[2],
+            sweep_name[3], sweep_name[4], "mean", "sd", "rms", "max", "lost");
+  }
+  for (uint32_t p = 0; p < sw.n_points; p++)
+  {
+    Sweep_Error e = { 0, 0, 0, 0, 0 };
+    for (uint32_t t = 0; t < sw.n_trials; t++) _sweep_error_merge(&e, &sw.error[(size_t)p * sw.n_trials + t]);
+    for (index_t k = 0; k < 2; k++) _sweep_write(table[k], &sw, p, &e);
+  }
+  fclose(f);
+  printf(_("SWEEP: %u trial(s) in %f sec, table is written to %s\n"), sw.n_points * sw.n_trials, total_time, output);
+
+  pthread_mutex_destroy(&sw.plan_lock);
+  for (index_t k = 0; k < n_workers; k++)
+  {
+    Sweep_Worker *w = &sw.worker[k];
+    exp_generator_free(w->generator);
+    MEM_freeN(w->data.y);
+    MEM_freeN(w->peak);
+    MEM_freeN(w->found.peak);
+  }
+  MEM_freeN(sw.worker);
+  MEM_freeN(sw.error);
+  MEM_freeN(x);
+  thread_pool_free(pool);
+  MEM_freeN(conf.peak);
+  config_freedict(ini);
+
+  return 0;
+}
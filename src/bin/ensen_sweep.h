@@ -0,0 +1,27 @@
+#ifndef ENSEN_SWEEP_H
+#define ENSEN_SWEEP_H
+
+#include "ensen_private.h"
+#include "ensen.h"
+
+/* Parameters swept (every combination of their lists is a point of the grid) */
+typedef enum {
+  SWEEP_NOISE_AMPLITUDE = 0,
+  SWEEP_NOISE_COLOR,
+  SWEEP_SMOOTH_WIDTH,
+  SWEEP_SMOOTH_LEVEL,
+  SWEEP_DETECTOR,
+  SWEEP_AXES
+} Sweep_Axis;
+
+/* Values of one parameter */
+#define SWEEP_VALUES_MAX 16
+
+typedef struct {
+  index_t n_values;
+  data_t  value[SWEEP_VALUES_MAX];
+} Sweep_List;
+
+int sweep_signal(const Ensen_Options *opt);
+
+#endif
@@ -10,21 +10,35 @@
 #endif
 #define gettext_noop(String) String
 
+#include <stdlib.h>
+#include <string.h>
+
 #include "ensen_utils.h"
+#include "ensen_bench.h"
+#include "ensen_channel.h"
 #include "ensen_conf.h"
 #include "ensen_data.h"
 #include "ensen_show.h"
 #include "ensen_plot.h"
 #include "ensen_exp.h"
-
+#include "ensen_metrics.h"
+#include "ensen_pipeline.h"
+#include "ensen_replay.h"
+#include "ensen_search.h"
+#include "ensen_sweep.h"
+
+#include "thread/ensen_thread_rt.h"
+#include "io/ensen_io_capture.h"
+#include "io/ensen_io_publish.h"
 #include "mem/ensen_mem_guarded.h"
 #include "str/safe_lib.h"
 
 #include "ensen.h"
 
 int
-test_signal(const char * conf_name)
+test_signal(const Ensen_Options *opt)
 {
+  const char *conf_name = opt->config;
   index_t i = 0; // general iterator
 
   /* Parameters setup (config) */
@@ -37,40 +51,101 @@ test_signal(const char * conf_name)
 
   Signal_Parameters conf;
   Points data, data_temp;
-  Points temp_gen, temp_sens_1, temp_sens_2, temp_sens_3, temp_sens_4;
+  Ring temp_gen;
+  Sensor_Bank sensors;
   Signal_Statistics stat;
   
   config_parameters_set(&conf, ini);
+  if (opt->realtime) conf.rt.apply = 1;
   PointsArrays data_arrays = { 
                               &data,
-                              &data_temp, 
-                              &temp_gen, 
-                              &temp_sens_1, 
-                              &temp_sens_2, 
-                              &temp_sens_3, 
-                              &temp_sens_4 
+                              &data_temp
   };
   data_arrays_set(conf, data_arrays);
 
+  /* Temperature of generator, the last conf.history frames are kept */
+  if (ring_init(&temp_gen, conf.history) != 0)
+  {
+      fprintf(stderr, _("wrong history: %d\n"), conf.history);
+      MEM_freeN(data_temp.y);
+      MEM_freeN(data_temp.x);
+      MEM_freeN(data.y);
+      MEM_freeN(data.x);
+      MEM_freeN(conf.peak);
+      config_freedict(ini);
+      return -1;
+  }
+  ring_push(&temp_gen, conf.temp.room);
+
+  /* State of every sensor (peak of interest), as many frames are kept */
+  if (sensor_bank_init(&sensors, conf.search.peaks_real_number, conf.history, conf.temp.room) != 0)
+  {
+      fprintf(stderr, _("wrong number of sensors: %d\n"), conf.search.peaks_real_number);
+      ring_free(&temp_gen);
+      MEM_freeN(data_temp.y);
+      MEM_freeN(data_temp.x);
+      MEM_freeN(data.y);
+      MEM_freeN(data.x);
+      MEM_freeN(conf.peak);
+      config_freedict(ini);
+      return -1;
+  }
+  Calibration *calibration = NULL;
+  if (config_calibration_load(ini, &conf, &calibration) != 0)
+  {
+      sensor_bank_free(&sensors);
+      ring_free(&temp_gen);
+      MEM_freeN(data_temp.y);
+      MEM_freeN(data_temp.x);
+      MEM_freeN(data.y);
+      MEM_freeN(data.x);
+      MEM_freeN(conf.peak);
+      config_freedict(ini);
+      return -1;
+  }
+  sensor_bank_calibrate(&sensors, calibration);
+
   /* Setup graphics */
-  index_t max_number_of_plots = 5;
-  gnuplot_ctrl *win[max_number_of_plots];
-  for (i = 0; i < max_number_of_plots; i++)
+  gnuplot_ctrl *win[MAX_NUMBER_OF_PLOTS];
+  for (i = 0; i < MAX_NUMBER_OF_PLOTS; i++)
   {
     win[i] = NULL;
   }
   graphics_set(win, conf);
 
   /* Generate signal and find peaks */
-  index_t i_gen = 0; // generations iterator
+  uint32_t i_gen = 0; // generations iterator
   data_t *dy_dx = NULL;
   stat.n_drops = 0; // number of droped generations because of too many peaks (more than `peaks_real_number`)
+  stat.n_allocations = 0;
 
   // derivative
   dy_dx = (conf.plot.show_derivative) ? MEM_malloc_arrayN(conf.n_points, sizeof(data_t), "test_signal: dy_dx") : NULL;
 
   init_rnd();
 
+  /* Latency histograms of the stages */
+  Metrics metrics;
+  metrics_init(&metrics, opt->metrics);
+
+  /* All buffers of a frame are allocated before the first frame */
+  Exp_Generator *generator = exp_generator_new(conf.n_points);
+  generator->broaden = &metrics.stage[METRIC_BROADEN];
+
+  /* Generated frames are recorded for replay */
+  Capture_Writer *record = NULL;
+  if ((opt->record != NULL) && ((record = capture_writer_open(opt->record, &data.grid, CAPTURE_FLOAT64)) == NULL))
+  {
+    fprintf(stderr, _("cannot record frames to %s\n"), opt->record);
+  }
+
+  /* Sensor results are published to other processes */
+  Publisher *publish = NULL;
+  if ((opt->publish != NULL) && ((publish = publisher_open(opt->publish, sensors.n_sensors, DATA_PUBLISH_RECORDS)) == NULL))
+  {
+    fprintf(stderr, _("cannot publish results to %s\n"), opt->publish);
+  }
+
   /* Generate main signal */
   Peaks peaks;
   peaks.peak = MEM_malloc_arrayN(conf.search.peaks_array_number, sizeof(Peak), "test_signal: peaks.peak array");
@@ -79,17 +154,40 @@ test_signal(const char * conf_name)
 
   /* Setup experiments */
   index_t smooth_level = 1;
-  data_t x[conf.generation_max];
-  data_t y[conf.generation_max];
+  data_t *x = MEM_calloc_arrayN(conf.history, sizeof(data_t), "test_signal: experiment x");
+  data_t *y = MEM_calloc_arrayN(conf.history, sizeof(data_t), "test_signal: experiment y");
+  const data_t *temp_sens = sensors.temperature; // the first sensor is compared with generator
   data_t noise_amplitude = 0.f;
   data_t noise_step = 0.05;
   conf.smooth.width = (conf.plot.show_vs_smooth == 2) ? 25 : 100;
 
-  data_clear(x, conf.generation_max);
+  /* Peak detector selected by config */
+  Searcher searcher;
+  searcher_init(&searcher, &conf, &data.grid);
+
+  /* Frames are started at the deadlines of the measurement frequency */
+  Schedule schedule;
+  schedule_init(&schedule, conf.generation_frequency);
+
+  /* Stages on their own threads (the experiments change parameters of all stages, so they run serially) */
+  const bool pipelined = conf.pipeline && !conf.plot.show_vs_smooth && !conf.plot.show_vs_noise;
 
-  index_t n_step = 0;
-  for (i_gen = 0; i_gen <= conf.generation_max; i_gen++)
+  /* Lock memory and set priority (inherited by the pipeline stages, peak search pins itself) */
+  realtime_enter(&conf.rt, !pipelined);
+  if (pipelined)
   {
+    Signal_Run run = { &conf, &stat, &data, &data_temp, dy_dx, &searcher, &sensors, &temp_gen, win, &schedule, generator, record, publish, &metrics, 0 };
+    pipeline_signal(&run);
+  }
+
+  uint32_t n_step = 0;
+  size_t allocations = 0;
+  for (i_gen = 0; !pipelined && (i_gen <= conf.generation_max); i_gen++)
+  {
+    /* steady state starts with the second frame */
+    if (i_gen == 1) allocations = MEM_get_memory_allocations();
+    const double frame_start = get_run_time();
+
     /*
      * ======================================
      * Clear data from the previous iteration
@@ -106,16 +204,14 @@ test_signal(const char * conf_name)
      */
 
     /* 
-     * Save previously generated signal peak positions
-     * (ideal from generator and found by searcher)
+     * Save previously generated signal peak position
+     * (positions found by searcher are kept by the sensor bank)
      */
-    data_t peak_position_ideal[conf.search.peaks_real_number];
-    index_t peak_position_found[conf.search.peaks_real_number];
-    for (i = 0; i < conf.search.peaks_real_number; i++)
-    {
-      peak_position_ideal[i] = conf.peak[i].position;
-      peak_position_found[i] = peaks.peak[i].position;
-    }
+    const data_t peak_position_ideal = conf.peak[0].position;
+
+    /* window of the experiment of this frame (NULL - none) */
+    gnuplot_ctrl *experiment_win = NULL;
+    char *experiment_title = NULL;
 
     /* ==================================================
      * ==== Experiment 1: simulate temperature change ===
@@ -125,7 +221,7 @@ test_signal(const char * conf_name)
     {
       for (i = 0; i < conf.n_peaks; i++)
       {
-        conf.peak[i].position = peak_position_ideal[i] + (stat.delta_temp * conf.temp.coefficient);
+        conf.peak[i].position += stat.delta_temp * conf.temp.coefficient;
       }
       show_generator_info(conf, stat, n_step);
       n_step = n_step + 1;
@@ -144,18 +240,13 @@ test_signal(const char * conf_name)
       }
       conf.noise.amplitude = noise_amplitude;
 
-      /* set x values */
-      x[i_gen] = conf.noise.amplitude;
-
-      /* set y values */
-      for (i = 0; i < i_gen + 1; i++)
-      {
-        y[i] = temp_sens_1.y[i] - temp_gen.y[i];
-      }
+      /* set x values (the first conf.history frames), y is the deviation of this frame */
+      if (i_gen < conf.history) x[i_gen] = conf.noise.amplitude;
 
       gnuplot_cmd(win[4], "set xrange [%g:%g]", 0.0, 0.5);
       gnuplot_cmd(win[4], "set yrange [%g:%g]", -20.0, 20.0);
-      gnuplot_plot_xy(win[4], x, y, i_gen + 1, _("dT vs Noise amplitude"));
+      experiment_win = win[4];
+      experiment_title = _("dT vs Noise amplitude");
     }
     else if (conf.plot.show_vs_noise == 2) // change noise color
     {
@@ -163,7 +254,14 @@ test_signal(const char * conf_name)
     }
 
     /* SIGNAL GENERATOR */
-    stat.generation_time = signal_generate_exp(&data, conf.n_peaks, conf.peak, conf.noise, conf.n_points);
+    stat.generation_time = signal_generate_exp(generator, &data, conf.n_peaks, conf.peak, conf.noise, conf.n_points);
+    latency_record_sec(&metrics.stage[METRIC_GENERATE], stat.generation_time);
+    if ((record != NULL) && (capture_writer_append(record, data.y) != 0))
+    {
+      fprintf(stderr, _("cannot record frame %u, recording is stopped\n"), i_gen);
+      capture_writer_close(record);
+      record = NULL;
+    }
     if ((i_gen > 0) & conf.plot.show_signal & (win[0] != NULL))
     {
       gnuplot_plot_xy(win[0], data.x, data.y, conf.n_points, _("Signal"));
@@ -179,6 +277,7 @@ test_signal(const char * conf_name)
      * ==== Experiment 3: evaluate smooth level change ===
      * =================================================== */
     /* Smooth signal */
+    double t = get_run_time();
     index_t smooth_tick = 15;
     if ((i_gen > 0) & (conf.plot.show_vs_smooth == 1)) // change smooth order
     {
@@ -192,18 +291,13 @@ test_signal(const char * conf_name)
         smooth(data.y, conf.n_points, conf.smooth.width);
       }
 
-      /* set x values */
-      x[i_gen] = smooth_level;
-
-      /* set y values */
-      for (i = 0; i < i_gen + 1; i++)
-      {
-        y[i] = temp_sens_1.y[i] - temp_gen.y[i] ;
-      }
+      /* set x values (the first conf.history frames), y is the deviation of this frame */
+      if (i_gen < conf.history) x[i_gen] = smooth_level;
 
       gnuplot_cmd(win[3], "set xrange [%d:%d]", 0, 8);
       gnuplot_cmd(win[3], "set yrange [%g:%g]", -20.0, 20.0);
-      gnuplot_plot_xy(win[3], x, y, i_gen + 1, _("dT vs Smooth order"));
+      experiment_win = win[3];
+      experiment_title = _("dT vs Smooth order");
     }
     else if ((i_gen > 0) & (conf.plot.show_vs_smooth == 2)) // change smooth width
     {
@@ -217,26 +311,19 @@ test_signal(const char * conf_name)
         smooth(data.y, conf.n_points, conf.smooth.width);
       }
 
-      /* set x values */
-      x[i_gen] = conf.smooth.width;
-
-      /* set y values */
-      for (i = 0; i < i_gen + 1; i++)
-      {
-        y[i] = temp_sens_1.y[i] - temp_gen.y[i];
-      }
+      /* set x values (the first conf.history frames), y is the deviation of this frame */
+      if (i_gen < conf.history) x[i_gen] = conf.smooth.width;
 
       gnuplot_cmd(win[3], "set xrange [%d:%d]", 0, 200);
       gnuplot_cmd(win[3], "set yrange [%g:%g]", -20.0, 40.0);
-      gnuplot_plot_xy(win[3], x, y, i_gen + 1, "dT vs Smooth width");
+      experiment_win = win[3];
+      experiment_title = "dT vs Smooth width";
     }
     else
     {
-      for (i = 0; i < conf.smooth.level; i++)
-      {
-        smooth(data.y, conf.n_points, conf.smooth.width);
-      }
+      searcher_smooth(&searcher, &conf, data.y, data.y, i_gen);
     }
+    metrics_stage(&metrics, METRIC_SMOOTH, t);
 
     /* Show plot of smoothed signal */
     if (conf.plot.show_smooth & (win[0] != NULL))
@@ -247,14 +334,16 @@ test_signal(const char * conf_name)
     /* Find and show derivative */
     if (conf.plot.show_derivative & (win[1] != NULL))
     {
+      t = get_run_time();
       data_clear(dy_dx, conf.n_points);
       deriv(conf.n_points, data.y, dy_dx);
+      metrics_stage(&metrics, METRIC_DERIVATIVE, t);
       gnuplot_plot_xy(win[1], data.x, dy_dx, conf.n_points, "dy/dLambda");
     }
 
     /* Find peaks */
-    peaks.peak = MEM_reallocN(peaks.peak, sizeof(Peak) * conf.search.peaks_array_number);
-    stat.peak_search_time = findpeaks(data.y, &peaks, &conf);
+    stat.peak_search_time = searcher_find(&searcher, &conf, data.y, i_gen, &peaks);
+    latency_record_sec(&metrics.stage[METRIC_SEARCH], stat.peak_search_time);
 
     /*
      * =======================================
@@ -262,76 +351,60 @@ test_signal(const char * conf_name)
      * =======================================
      */
 
+    t = get_run_time();
+    sensor_bank_update(&sensors, &peaks, &data.grid, conf.temp.coefficient);
+    if (publish != NULL) data_publish(publish, i_gen, &sensors, &peaks, data.y, conf.n_points);
     if (i_gen > 0)
     {
-      temp_gen.y[i_gen] = temp_gen.y[i_gen - 1] + (conf.peak[0].position - peak_position_ideal[0])/conf.temp.coefficient;
-      temp_sens_1.y[i_gen] = temp_sens_1.y[i_gen - 1] + (data.x[(index_t)peaks.peak[0].position] - data.x[peak_position_found[0]])/conf.temp.coefficient;
-      temp_sens_2.y[i_gen] = temp_sens_2.y[i_gen - 1] + (data.x[(index_t)peaks.peak[1].position] - data.x[peak_position_found[1]])/conf.temp.coefficient;
-      temp_sens_3.y[i_gen] = temp_sens_3.y[i_gen - 1] + (data.x[(index_t)peaks.peak[2].position] - data.x[peak_position_found[2]])/conf.temp.coefficient;
-      temp_sens_4.y[i_gen] = temp_sens_4.y[i_gen - 1] + (data.x[(index_t)peaks.peak[3].position] - data.x[peak_position_found[3]])/conf.temp.coefficient;
+      ring_push(&temp_gen, ring_last(&temp_gen) + (conf.peak[0].position - peak_position_ideal)/conf.temp.coefficient);
+      sensor_bank_deviation(&sensors, ring_last(&temp_gen));
+    }
+    t = metrics_stage(&metrics, METRIC_TEMPERATURE, t);
 
-      printf(_(MAGENTA("PSEARCHER:")" Found %d peak(s) in %f sec at "), peaks.total_number, stat.peak_search_time);
-      for (index_t i_sens = 0; i_sens < conf.search.peaks_real_number; i_sens++)
-      {
-        show_psearch_info(conf, i_gen, i_sens, peaks.total_number, temp_sens_1, temp_sens_2, temp_sens_3, temp_sens_4);
-
-        // Plot markers in peak positions
-        if ((conf.plot.show_signal || conf.plot.show_smooth || conf.plot.show_derivative) & conf.plot.show_markers & (win[0] != NULL))
-        {
-          data_t marker_x[2] = { data.x[(index_t)peaks.peak[i_sens].position], data.x[(index_t)peaks.peak[i_sens].position] };
-          data_t marker_y[2] = { conf.plot.y_min, conf.plot.y_max };
-          gnuplot_plot_xy(win[0], marker_x, marker_y, 2, _("Peak marker"));
-        }
-      }
+    /* deviation of this frame is paired with the parameter the experiment set for it */
+    if (experiment_win != NULL)
+    {
+      if (i_gen < conf.history) y[i_gen] = temp_sens[0] - ring_last(&temp_gen);
+      gnuplot_plot_xy(experiment_win, x, y, (i_gen < conf.history) ? i_gen + 1 : conf.history, experiment_title);
     }
 
-    /* Temperature */
-    if (conf.temp.apply & conf.plot.show_temperature)
+    if (i_gen > 0)
     {
-      gnuplot_cmd(win[2], "set yrange [%d:%g]", 0, (conf.temp.max + 700));
-      data_temp.x[i_gen] = i_gen;
-      switch (conf.search.peak_search_number)
-      {
-        case 1:
-          gnuplot_plot_xy(win[2], data_temp.x, temp_sens_1.y, i_gen + 1, _("T (sensor 1)"));
-          break;
-        case 2:
-          gnuplot_plot_xy(win[2], data_temp.x, temp_sens_2.y, i_gen + 1, _("T (sensor 2)"));
-          break;
-        case 3:
-          gnuplot_plot_xy(win[2], data_temp.x, temp_sens_3.y, i_gen + 1, _("T (sensor 3)"));
-          break;
-        case 4:
-          gnuplot_plot_xy(win[2], data_temp.x, temp_sens_4.y, i_gen + 1, _("T (sensor 4)"));
-          break;
-      }
-      gnuplot_plot_xy(win[2], data_temp.x, temp_gen.y, i_gen + 1, _("T (generator)"));
+      printf(_(MAGENTA("PSEARCHER:")" Found %d peak(s) in %f sec at "), peaks.total_number, stat.peak_search_time);
+      show_psearch_info(conf, &sensors, peaks.total_number);
+
+      // Plot markers in peak positions
+      graphics_markers(win, conf, &sensors);
     }
+
+    /* Temperature */
+    graphics_temperature(win, conf, &data_temp, &sensors, &temp_gen);
+    metrics_stage(&metrics, METRIC_PLOT, t);
+    metrics_stage(&metrics, METRIC_FRAME, frame_start);
+    metrics_poll(&metrics);
+
     /* Isolate desired segment for curve fitting */
-    // index_t points_segment_size = 100; // number of points
-    // data_t points_segment_center = 300.0; // data center value
-    // Points data_segment;
-    // data_segment.x = (data_t *)malloc(sizeof(data_t) * points_segment_size);
-    // data_segment.y = (data_t *)malloc(sizeof(data_t) * points_segment_size);
-    // // data_window_get(points, n_points, 200, points_segment_size, segment);
-    // index_t n1 = val2ind(data.x, conf.n_points, points_segment_center - (points_segment_size / 2));
-    // for (index_t ii = 0; ii < points_segment_size; ii++)
-    // {
-    //   data_segment.x[ii] = data.x[n1];
-    //   data_segment.y[ii] = data.y[n1];
-    //   n1 = n1 + 1;
-    // }
-    // gnuplot_plot_points(win, &data_segment, points_segment_size, "Segment");
+    // data_t points_segment_size = 1.0; // window width (nm)
+    // data_t points_segment_center = 1511.0; // data center value
+    // Points_View data_segment = points_view_window(points_view(&data, conf.n_points), points_segment_center, points_segment_size);
+    // signal_fit_view(data_segment, 2);
+    // gnuplot_plot_xy(win[0], view_ptr(data_segment.x, 0), view_ptr(data_segment.y, 0), data_segment.x.length, "Segment");
 
     /* Simulate mesurements frequency */
     if (conf.generation_max != 1)
     {
-      usleep(1000000/conf.generation_frequency);
+      schedule_wait(&schedule);
     }
   }
+  if (!pipelined) stat.n_allocations = (i_gen > 1) ? MEM_get_memory_allocations() - allocations : 0;
+  realtime_leave(&conf.rt);
+  stat.n_missed   = schedule.missed;
+  stat.jitter     = schedule_jitter(&schedule);
+  stat.jitter_max = schedule.jitter_max;
 
   /* Statistics */
-  show_statistics(conf, stat, temp_gen, temp_sens_1, temp_sens_2, temp_sens_3, temp_sens_4);
+  show_statistics(conf, stat, ring_last(&temp_gen), &sensors, &metrics);
+  metrics_dump(&metrics);
 
   /* Do not close window untill we press any key */
   if (conf.plot.show_signal || conf.plot.show_smooth || conf.plot.show_derivative || conf.plot.show_temperature)
@@ -353,11 +426,12 @@ test_signal(const char * conf_name)
   MEM_freeN(data_temp.x);
   MEM_freeN(data_temp.y);
   
-  MEM_freeN(temp_gen.y);
-  MEM_freeN(temp_sens_1.y);
-  MEM_freeN(temp_sens_2.y);
-  MEM_freeN(temp_sens_3.y);
-  MEM_freeN(temp_sens_4.y);
+  ring_free(&temp_gen);
+  sensor_bank_free(&sensors);
+  calibration_free(calibration);
+
+  MEM_freeN(x);
+  MEM_freeN(y);
 
   if (conf.plot.show_derivative)
   {
@@ -365,6 +439,10 @@ test_signal(const char * conf_name)
   }
 
   MEM_freeN(peaks.peak);
+  searcher_free(&searcher);
+  exp_generator_free(generator);
+  capture_writer_close(record);
+  publisher_close(publish, true);
 
   config_freedict(ini);
   free_gnuplot(conf, win);
@@ -373,7 +451,7 @@ test_signal(const char * conf_name)
 }
 
 int
-main(int argc __UNUSED__, const char ** argv __UNUSED__)
+main(int argc, const char ** argv)
 {
 # ifdef MEM_DEBUG_APPLY
   MEM_use_guarded_allocator(); /* SLOW, use only for debugging */
@@ -381,25 +459,55 @@ main(int argc __UNUSED__, const char ** argv __UNUSED__)
   MEM_init_memleak_detection();
   MEM_enable_fail_on_memleak();
 
-  clearscreen();
+  /* Options */
+  Ensen_Options opt = { "config.ini", false, false, 0, NULL, NULL, NULL, NULL, 1, false, false, false };
+  for (int i = 1; i < argc; i++)
+  {
+    if (strcmp(argv[i], "--bench") == 0) opt.bench = true;
+    else if (strcmp(argv[i], "--realtime") == 0) opt.realtime = true;
+    else if (strcmp(argv[i], "--sweep") == 0) opt.sweep = true;
+    else if (strcmp(argv[i], "--channels") == 0) opt.channels = true;
+    else if (strcmp(argv[i], "--profile") == 0) opt.profile = true;
+    else if ((strcmp(argv[i], "--frames") == 0) && (i + 1 < argc)) opt.n_frames = strtoul(argv[++i], NULL, 10);
+    else if ((strcmp(argv[i], "--config") == 0) && (i + 1 < argc)) opt.config = argv[++i];
+    else if ((strcmp(argv[i], "--record") == 0) && (i + 1 < argc)) opt.record = argv[++i];
+    else if ((strcmp(argv[i], "--publish") == 0) && (i + 1 < argc)) opt.publish = argv[++i];
+    else if ((strcmp(argv[i], "--metrics") == 0) && (i + 1 < argc)) opt.metrics = argv[++i];
+    else if ((strcmp(argv[i], "--replay") == 0) && (i + 1 < argc)) opt.replay = argv[++i];
+    else if ((strcmp(argv[i], "--jobs") == 0) && (i + 1 < argc)) opt.jobs = strtoul(argv[++i], NULL, 10);
+    else
+    {
+      fprintf(stderr, _("usage: %s [--bench] [--realtime] [--frames N] [--config FILE] [--record FILE] [--publish NAME] [--metrics FILE] [--profile] [--replay FILE | --sweep | --channels] [--jobs N]\n"), argv[0]);
+      return 1;
+    }
+  }
+
+  if (!opt.bench && !opt.sweep && !opt.channels && (opt.replay == NULL)) clearscreen();
   
-  const char * conf_file_name = "config.ini";
-  FILE *f = fopen(conf_file_name, "r");
-  if (f == NULL) {
+  FILE *f = fopen(opt.config, "r");
+  if ((f == NULL) && (strcmp(opt.config, "config.ini") == 0)) {
     config_parameters_set_default();
-    printf(_("Cannot find configuration file: %s. Created the new one!\n"), conf_file_name);
+    printf(_("Cannot find configuration file: %s. Created the new one!\n"), opt.config);
+  }
+
+  /* regions are counted by all threads of the run */
+  if (opt.profile && (profile_enable() == 0))
+  {
+    fprintf(stderr, _("hardware counters are not available (see /proc/sys/kernel/perf_event_paranoid), regions are timed only\n"));
   }
 
-  test_signal("config.ini");
+  int ret = (opt.replay != NULL) ? replay_signal(&opt) : (opt.sweep) ? sweep_signal(&opt) : (opt.channels) ? channels_signal(&opt) : (opt.bench) ? bench_signal(&opt) : test_signal(&opt);
   
   if (f)
   {
     fclose(f);
   }
 
+  if (opt.profile) profile_print(stdout);
+
 # ifdef MEM_DEBUG_APPLY
   printf(_("Used %ld kB of memory \n"), MEM_get_peak_memory()/1024);
 # endif
 
-  return 0;
+  return (ret == 0) ? 0 : 1;
 }
@@ -85,7 +85,7 @@ extern int usleep (__useconds_t __useconds); /* from <unistd.h> */
 
 /* Data */
 typedef double     data_t;
-typedef u_int16_t index_t;
+typedef uint16_t  index_t;
 
 typedef struct _point Point;
 struct _point
@@ -94,13 +94,44 @@ struct _point
     data_t y;
 };
 
+typedef struct _grid Grid;
+struct _grid
+{
+    data_t         start;  /* value of the first point */
+    data_t         step;   /* distance between points (uniform grid) */
+    index_t        count;  /* number of points */
+    const data_t * values; /* values of the calibrated (non-uniform, ascending) grid, NULL if uniform */
+};
+
 typedef struct
 {
     data_t * x;
     data_t * y;
     data_t * lambda;
+    Grid     grid; /* descriptor of x values */
 } Points;
 
+/*
+ * View of data_t array without copy: element i is data[offset + i * stride].
+ * Windows of frames and x/y of Point arrays (stride 2) are passed to the
+ * kernels as views (see signal/ensen_signal_view.h).
+ */
+typedef struct _view View;
+struct _view
+{
+    data_t * data;    /* underlying array */
+    uint32_t offset;  /* first element of view */
+    index_t  length;  /* number of elements */
+    index_t  stride;  /* distance between elements (in data_t) */
+};
+
+typedef struct _points_view Points_View;
+struct _points_view
+{
+    View x;
+    View y;
+};
+
 typedef struct _peak Peak;
 struct _peak
 {
@@ -129,6 +160,8 @@ struct _smooth
 {
     index_t width;
     index_t level;
+    index_t adaptive;  /* choose width and level of every frame by its noise (width and level are the maximum) */
+    data_t  target;    /* adaptive: position error to meet (x units) */
 };
 
 typedef struct _plot Plot;
@@ -147,6 +180,13 @@ struct _plot
     index_t show_vs_noise;
 };
 
+/* Peak detectors */
+#define PEAK_DETECTOR_DERIV 0 /* zero crossing of the derivative of the smoothed signal */
+#define PEAK_DETECTOR_CWT   1 /* ridge lines of the continuous wavelet transform */
+#define PEAK_DETECTOR_XCORR 2 /* shift of the first frame peaks by cross-correlation */
+
+#define CWT_SCALES_MAX 16
+
 typedef struct _peak_search Peak_Search;
 struct _peak_search
 {
@@ -156,6 +196,13 @@ struct _peak_search
     index_t peaks_real_number;
     index_t peaks_array_number;
     index_t peak_search_number;
+    index_t stream_chunk;       /* push frame to the online detector by chunks of this size (0 - off) */
+    index_t detector;           /* PEAK_DETECTOR_* */
+    index_t cwt_scales_number;
+    data_t  cwt_scales[CWT_SCALES_MAX]; /* wavelet scales (points) */
+    data_t  cwt_snr;            /* minimal ridge coefficient to noise ratio */
+    index_t xcorr_window;       /* reference window around peak (points) */
+    index_t xcorr_range;        /* maximal shift between frames (points) */
 };
 
 typedef struct _temp Temperature;
@@ -168,6 +215,24 @@ struct _temp
     index_t apply;
 };
 
+typedef struct _tracking Tracking;
+struct _tracking
+{
+    index_t apply;             /* filter peak positions by Kalman tracker */
+    data_t  process_noise;     /* variance of drift change per measurement (points^2) */
+    data_t  measurement_noise; /* variance of found position (points^2) */
+    data_t  gate;              /* search window and outlier rejection (sigmas) */
+    index_t refine;            /* half width of sub-sample refinement (points, 0 - off) */
+};
+
+typedef struct _realtime Realtime;
+struct _realtime
+{
+    index_t apply;             /* lock memory, preallocated frames are checked for allocations */
+    index_t priority;          /* SCHED_FIFO priority (0 - keep the default scheduler) */
+    int     cpu;               /* core of the processing thread (-1 - no pinning) */
+};
+
 typedef struct _signal_parameters Signal_Parameters;
 struct _signal_parameters
 {
@@ -176,11 +241,15 @@ struct _signal_parameters
     Peak       * peak;
     Noise        noise;
     Smooth       smooth;
-    index_t      generation_max;
+    uint32_t     generation_max;
+    index_t      history;
+    index_t      pipeline;
     index_t      generation_frequency;
     Temperature  temp;
     Plot         plot;
     Peak_Search  search;
+    Tracking     track;
+    Realtime     rt;
 };
 
 typedef struct _signal_statistics Signal_Statistics;
@@ -190,16 +259,15 @@ struct _signal_statistics
     data_t peak_search_time;
     index_t n_drops;
     data_t delta_temp;
+    uint32_t n_missed;  /* frames started after their deadline */
+    data_t jitter;      /* standard deviation of frame period (sec.) */
+    data_t jitter_max;  /* maximal deviation of frame period from nominal (sec.) */
+    uint32_t n_allocations; /* heap allocations after the first frame */
 };
 
 typedef struct {
     Points *data;
     Points *data_temp;
-    Points *temp_gen;
-    Points *temp_sens_1;
-    Points *temp_sens_2;
-    Points *temp_sens_3;
-    Points *temp_sens_4;
 } PointsArrays;
 
 
@@ -0,0 +1,122 @@
+#ifndef ENSEN_IO_CAPTURE_H
+#define ENSEN_IO_CAPTURE_H
+
+#ifndef ENSEN_PRIVATE_H
+    #include "ensen_private.h"
+#endif
+
+/*
+ * Binary capture of spectra: a header (grid descriptor, data type and
+ * number of frames), values of the calibrated grid (if any), then frames
+ * of a fixed stride. Frames are aligned to CAPTURE_ALIGN bytes, so the
+ * reader maps the file and passes frames to the kernels without copy.
+ * Numbers are stored in the byte order of the host.
+ */
+
+#define CAPTURE_MAGIC   "ENSENCAP"
+#define CAPTURE_VERSION 1
+#define CAPTURE_ALIGN   64
+
+/* Data types of frame values */
+#define CAPTURE_FLOAT64 1 /* data_t, frames are read without copy */
+#define CAPTURE_FLOAT32 2 /* half of the size, converted on read */
+
+typedef struct _capture_header Capture_Header;
+struct _capture_header
+{
+    char     magic[8];     /* CAPTURE_MAGIC (not terminated) */
+    uint32_t version;      /* CAPTURE_VERSION */
+    uint32_t data_type;    /* CAPTURE_FLOAT64, CAPTURE_FLOAT32 */
+    uint32_t n_points;     /* points in frame */
+    uint32_t calibrated;   /* 1 - n_points grid values (float64) follow the header */
+    double   grid_start;   /* uniform grid: value of the first point */
+    double   grid_step;    /* uniform grid: distance between points */
+    uint64_t n_frames;     /* frames written when the writer was closed */
+    uint64_t frame_offset; /* offset of the first frame (bytes) */
+    uint64_t frame_stride; /* distance between frames (bytes) */
+};
+
+typedef struct _capture Capture;
+typedef struct _capture_writer Capture_Writer;
+
+/**
+    @brief Map capture for reading
+    @param path File name
+    @return Capture (close with capture_close()), NULL if the file cannot be
+            mapped or is not a capture
+**/
+Capture *capture_open(const char *path);
+
+/**
+    @brief Unmap capture
+    @param c Capture
+**/
+void capture_close(Capture *c);
+
+/**
+    @brief Header of capture
+    @param c Capture
+    @return Header (in the mapped file)
+**/
+const Capture_Header *capture_header(const Capture *c);
+
+/**
+    @brief Number of complete frames
+    @param c Capture
+    @return Frames in the file (the size of file is used: frames of a writer
+            that was not closed are read too, a partial frame is not)
+**/
+uint64_t capture_frames(const Capture *c);
+
+/**
+    @brief Grid of frames
+    @param c Capture
+    @param grid Grid descriptor (values of calibrated grid are in the mapped file)
+**/
+void capture_grid(const Capture *c, Grid *grid);
+
+/**
+    @brief Frame of capture
+    @param c Capture
+    @param frame Frame number (< capture_frames())
+    @param scratch Buffer of n_points for conversion (may be NULL for CAPTURE_FLOAT64)
+    @return Frame values: pointer into the mapped file for CAPTURE_FLOAT64,
+            scratch with converted values otherwise
+**/
+const data_t *capture_frame(const Capture *c, uint64_t frame, data_t *scratch);
+
+/**
+    @brief Open capture for appending frames
+    @param path File name (a new file is created if it does not exist or is empty)
+    @param grid Grid of frames
+    @param data_type CAPTURE_FLOAT64 or CAPTURE_FLOAT32
+    @return Writer (close with capture_writer_close()), NULL on failure or if
+            the existing file has another grid or data type
+**/
+Capture_Writer *capture_writer_open(const char *path, const Grid *grid, uint32_t data_type);
+
+/**
+    @brief Append frame
+    @param w Writer
+    @param y Frame values (n_points of grid)
+    @return 0 on success, -1 on failure (see errno)
+
+    No memory is allocated: frames may be recorded from the frame loop.
+**/
+int capture_writer_append(Capture_Writer *w, const data_t *y);
+
+/**
+    @brief Number of frames in the file
+    @param w Writer
+    @return Frames (including the frames before opening)
+**/
+uint64_t capture_writer_frames(const Capture_Writer *w);
+
+/**
+    @brief Store number of frames in header and close the file
+    @param w Writer
+    @return 0 on success, -1 on failure
+**/
+int capture_writer_close(Capture_Writer *w);
+
+#endif
@@ -0,0 +1,129 @@
+#ifndef ENSEN_IO_PUBLISH_H
+#define ENSEN_IO_PUBLISH_H
+
+#ifndef ENSEN_PRIVATE_H
+    #include "ensen_private.h"
+#endif
+
+/*
+ * Results of frames published to other processes of the same host through
+ * a POSIX shared memory ring. The ring has one writer and any number of
+ * readers; readers never block the writer. Every slot of the ring is a
+ * seqlock: its sequence number is odd while the slot is written and is
+ * 2 * (record + 1) when record is complete, so a reader copies a slot and
+ * accepts the copy only if the sequence number is the expected one before
+ * and after the copy. A reader that is too slow misses overwritten records
+ * (they are reported as lost), it never reads a torn one.
+ *
+ * Layout: a header of PUBLISH_ALIGN bytes (magic, version, number of
+ * sensors, ring capacity, slot size, number of records written), then
+ * capacity slots; a slot is the sequence number, frame number and
+ * timestamp followed by Publish_Reading of every sensor.
+ */
+
+#define PUBLISH_MAGIC   "ENSENPUB"
+#define PUBLISH_VERSION 1
+#define PUBLISH_ALIGN   64
+
+/* Attempts of a reader to copy a slot which is being written */
+#define PUBLISH_READ_SPIN 1024
+
+typedef struct _publish_reading Publish_Reading;
+struct _publish_reading
+{
+    double position;     /* peak position (x units) */
+    double temperature;
+    double quality;      /* signal at the peak (0 - the peak is lost in this frame) */
+};
+
+/* Record of the ring as seen by a reader */
+typedef struct _publish_record Publish_Record;
+struct _publish_record
+{
+    uint64_t number;     /* records written before this one */
+    uint64_t frame;      /* frame number of the writer */
+    int64_t  timestamp;  /* publication time (CLOCK_MONOTONIC, nsec, see publish_now()) */
+};
+
+typedef struct _publisher Publisher;
+typedef struct _publish_reader Publish_Reader;
+
+/**
+    @brief Time of the publication clock
+    @return CLOCK_MONOTONIC (nsec), the same for all processes of the host
+**/
+int64_t publish_now(void);
+
+/**
+    @brief Create shared memory ring
+    @param name Shared memory object name ("/name")
+    @param n_sensors Number of sensors of a record
+    @param capacity Records kept (rounded up to a power of 2)
+    @return Publisher (close with publisher_close()), NULL on failure (see errno)
+
+    An existing object of the name is replaced.
+**/
+Publisher *publisher_open(const char *name, index_t n_sensors, uint32_t capacity);
+
+/**
+    @brief Unmap ring
+    @param p Publisher (may be NULL)
+    @param unlink Remove the shared memory object (readers keep their mappings)
+**/
+void publisher_close(Publisher *p, bool unlink);
+
+/**
+    @brief Start the next record
+    @param p Publisher
+    @return Readings of all sensors in the ring slot, filled by the caller
+            before publisher_commit() (no copy and no allocation)
+**/
+Publish_Reading *publisher_begin(Publisher *p);
+
+/**
+    @brief Publish the record started by publisher_begin()
+    @param p Publisher
+    @param frame Frame number
+**/
+void publisher_commit(Publisher *p, uint64_t frame);
+
+/**
+    @brief Map ring of a publisher for reading
+    @param name Shared memory object name
+    @return Reader (close with publish_reader_close()), NULL if there is no
+            ring of the name
+**/
+Publish_Reader *publish_reader_open(const char *name);
+
+/**
+    @brief Unmap ring
+    @param r Reader (may be NULL)
+**/
+void publish_reader_close(Publish_Reader *r);
+
+/**
+    @brief Number of sensors of a record
+    @param r Reader
+    @return Number of readings copied by publish_read()
+**/
+index_t publish_reader_sensors(const Publish_Reader *r);
+
+/**
+    @brief Number of records written
+    @param r Reader
+    @return Records published so far (the last one is number - 1)
+**/
+uint64_t publish_reader_head(const Publish_Reader *r);
+
+/**
+    @brief Copy record
+    @param r Reader
+    @param number Record number (< publish_reader_head())
+    @param record Frame and timestamp of the record
+    @param reading Readings of all sensors (publish_reader_sensors())
+    @return 0 on success, -1 if the record is not published yet, has been
+            overwritten or is being written for too long
+**/
+int publish_read(const Publish_Reader *r, uint64_t number, Publish_Record *record, Publish_Reading *reading);
+
+#endif
@@ -0,0 +1,286 @@
+#include <errno.h>
+#include <fcntl.h>
+#include <stddef.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "ensen_private.h"
+#include "ensen_io_capture.h"
+#include "signal/ensen_signal_grid.h"
+#include "mem/ensen_mem_guarded.h"
+
+struct _capture
+{
+    const unsigned char *map;
+    size_t               size;
+    const Capture_Header *header;
+    uint64_t             n_frames;
+};
+
+struct _capture_writer
+{
+    int             fd;
+    Capture_Header  header;
+    unsigned char * frame;     /* one frame of stride bytes (conversion and padding) */
+};
+
+static inline uint64_t
+_capture_align(uint64_t size)
+{
+    return (size + CAPTURE_ALIGN - 1) / CAPTURE_ALIGN * CAPTURE_ALIGN;
+}
+
+static inline size_t
+_capture_type_size(uint32_t data_type)
+{
+    return (data_type == CAPTURE_FLOAT64) ? sizeof(double) : (data_type == CAPTURE_FLOAT32) ? sizeof(float) : 0;
+}
+
+/* Header is consistent with itself and with the size of file */
+static bool
+_capture_header_valid(const Capture_Header *h, uint64_t size)
+{
+    const size_t type_size = _capture_type_size(h->data_type);
+
+    if (memcmp(h->magic, CAPTURE_MAGIC, sizeof(h->magic)) != 0) return false;
+    if ((h->version != CAPTURE_VERSION) || (type_size == 0) || (h->n_points == 0)) return false;
+    if (h->n_points > UINT16_MAX) return false; /* frames are indexed by index_t */
+    if (h->frame_stride < (uint64_t)h->n_points * type_size) return false;
+    if (h->frame_offset < sizeof(Capture_Header) + (h->calibrated ? (uint64_t)h->n_points * sizeof(double) : 0)) return false;
+    if ((h->frame_offset % CAPTURE_ALIGN) || (h->frame_stride % CAPTURE_ALIGN)) return false;
+    return h->frame_offset <= size;
+}
+
+/* write() all bytes at offset */
+static int
+_capture_pwrite(int fd, const void *buf, size_t len, off_t offset)
+{
+    const unsigned char *p = buf;
+    while (len > 0)
+    {
+        ssize_t n = pwrite(fd, p, len, offset);
+        if (n < 0)
+        {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        p += n;
+        len -= (size_t)n;
+        offset += n;
+    }
+    return 0;
+}
+
+Capture *
+capture_open(const char *path)
+{
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return NULL;
+
+    struct stat st;
+    if ((fstat(fd, &st) != 0) || ((size_t)st.st_size < sizeof(Capture_Header)))
+    {
+        close(fd);
+        errno = EINVAL;
+        return NULL;
+    }
+
+    void *map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) return NULL;
+
+    const Capture_Header *h = map;
+    if (!_capture_header_valid(h, st.st_size))
+    {
+        munmap(map, st.st_size);
+        errno = EINVAL;
+        return NULL;
+    }
+
+    /* frames are read in order */
+    posix_madvise(map, st.st_size, POSIX_MADV_SEQUENTIAL);
+
+    Capture *c = MEM_callocN(sizeof(Capture), "capture_open: capture");
+    c->map      = map;
+    c->size     = st.st_size;
+    c->header   = h;
+    c->n_frames = (c->size - h->frame_offset) / h->frame_stride;
+
+    return c;
+}
+
+void
+capture_close(Capture *c)
+{
+    if (c == NULL) return;
+
+    munmap((void *)c->map, c->size);
+    MEM_freeN(c);
+}
+
+const Capture_Header *
+capture_header(const Capture *c)
+{
+    return c->header;
+}
+
+uint64_t
+capture_frames(const Capture *c)
+{
+    return c->n_frames;
+}
+
+void
+capture_grid(const Capture *c, Grid *grid)
+{
+    const Capture_Header *h = c->header;
+
+    if (h->calibrated)
+    {
+        grid_calibrated_set(grid, (const data_t *)(c->map + sizeof(Capture_Header)), h->n_points);
+    }
+    else
+    {
+        grid_uniform_set(grid, h->grid_start, h->grid_start + h->grid_step * h->n_points, h->n_points);
+        grid->step = h->grid_step; /* exactly as recorded */
+    }
+}
+
+const data_t *
+capture_frame(const Capture *c, uint64_t frame, data_t *scratch)
+{
+    const Capture_Header *h = c->header;
+    const unsigned char *p = c->map + h->frame_offset + frame * h->frame_stride;
+
+    if (h->data_type == CAPTURE_FLOAT64) return (const data_t *)p;
+
+    const float *f = (const float *)p;
+    for (uint32_t i = 0; i < h->n_points; i++) scratch[i] = f[i];
+    return scratch;
+}
+
+Capture_Writer *
+capture_writer_open(const char *path, const Grid *grid, uint32_t data_type)
+{
+    const size_t type_size = _capture_type_size(data_type);
+    if ((type_size == 0) || (grid->count == 0))
+    {
+        errno = EINVAL;
+        return NULL;
+    }
+
+    /* header of the new file */
+    Capture_Header h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, CAPTURE_MAGIC, sizeof(h.magic));
+    h.version      = CAPTURE_VERSION;
+    h.data_type    = data_type;
+    h.n_points     = grid->count;
+    h.calibrated   = (grid->values != NULL);
+    h.grid_start   = grid->start;
+    h.grid_step    = grid->step;
+    h.frame_offset = _capture_align(sizeof(h) + (h.calibrated ? (uint64_t)h.n_points * sizeof(double) : 0));
+    h.frame_stride = _capture_align((uint64_t)h.n_points * type_size);
+
+    int fd = open(path, O_RDWR | O_CREAT, 0644);
+    if (fd < 0) return NULL;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0)
+    {
+        close(fd);
+        return NULL;
+    }
+
+    if (st.st_size == 0)
+    {
+        /* new file: header and grid values, frames are appended */
+        unsigned char *head = MEM_calloc_arrayN(h.frame_offset, 1, "capture_writer_open: head");
+        memcpy(head, &h, sizeof(h));
+        if (h.calibrated) memcpy(head + sizeof(h), grid->values, (size_t)h.n_points * sizeof(double));
+        const int ret = _capture_pwrite(fd, head, h.frame_offset, 0);
+        MEM_freeN(head);
+        if (ret != 0)
+        {
+            close(fd);
+            return NULL;
+        }
+    }
+    else
+    {
+        /* existing file: the same frames only, a partial frame is overwritten */
+        Capture_Header old;
+        bool same = (pread(fd, &old, sizeof(old), 0) == (ssize_t)sizeof(old)) && _capture_header_valid(&old, st.st_size)
+                    && (old.data_type == h.data_type) && (old.n_points == h.n_points) && (old.calibrated == h.calibrated)
+                    && (old.frame_offset == h.frame_offset) && (old.frame_stride == h.frame_stride);
+
+        if (same && h.calibrated)
+        {
+            double *values = MEM_malloc_arrayN(h.n_points, sizeof(double), "capture_writer_open: values");
+            same = (pread(fd, values, (size_t)h.n_points * sizeof(double), sizeof(h)) == (ssize_t)(h.n_points * sizeof(double)))
+                   && (memcmp(values, grid->values, (size_t)h.n_points * sizeof(double)) == 0);
+            MEM_freeN(values);
+        }
+        else if (same)
+        {
+            same = !((old.grid_start < h.grid_start) || (old.grid_start > h.grid_start)
+                     || (old.grid_step < h.grid_step) || (old.grid_step > h.grid_step));
+        }
+
+        if (!same)
+        {
+            close(fd);
+            errno = EINVAL;
+            return NULL;
+        }
+        h.n_frames = (st.st_size - h.frame_offset) / h.frame_stride;
+    }
+
+    Capture_Writer *w = MEM_callocN(sizeof(Capture_Writer), "capture_writer_open: writer");
+    w->fd     = fd;
+    w->header = h;
+    w->frame  = MEM_calloc_arrayN(h.frame_stride, 1, "capture_writer_open: frame");
+
+    return w;
+}
+
+int
+capture_writer_append(Capture_Writer *w, const data_t *y)
+{
+    const Capture_Header *h = &w->header;
+
+    if (h->data_type == CAPTURE_FLOAT64)
+    {
+        memcpy(w->frame, y, (size_t)h->n_points * sizeof(double));
+    }
+    else
+    {
+        float *f = (float *)w->frame;
+        for (uint32_t i = 0; i < h->n_points; i++) f[i] = (float)y[i];
+    }
+
+    if (_capture_pwrite(w->fd, w->frame, h->frame_stride, h->frame_offset + w->header.n_frames * h->frame_stride) != 0) return -1;
+    w->header.n_frames++;
+    return 0;
+}
+
+uint64_t
+capture_writer_frames(const Capture_Writer *w)
+{
+    return w->header.n_frames;
+}
+
+int
+capture_writer_close(Capture_Writer *w)
+{
+    if (w == NULL) return 0;
+
+    int ret = _capture_pwrite(w->fd, &w->header.n_frames, sizeof(w->header.n_frames), offsetof(Capture_Header, n_frames));
+    if (close(w->fd) != 0) ret = -1;
+
+    MEM_freeN(w->frame);
+    MEM_freeN(w);
+    return ret;
+}
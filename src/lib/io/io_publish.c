@@ -0,0 +1,230 @@
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "ensen_private.h"
+#include "ensen_io_publish.h"
+#include "mem/atomic_ops.h"
+#include "mem/ensen_mem_guarded.h"
+
+typedef struct _publish_header Publish_Header;
+struct _publish_header
+{
+    char     magic[8];   /* PUBLISH_MAGIC (not terminated) */
+    uint32_t version;    /* PUBLISH_VERSION */
+    uint32_t n_sensors;
+    uint32_t capacity;   /* slots (power of 2) */
+    uint32_t slot_size;  /* bytes, multiple of PUBLISH_ALIGN */
+    uint64_t head;       /* records written (atomic) */
+};
+
+typedef struct _publish_slot Publish_Slot;
+struct _publish_slot
+{
+    uint64_t        seq;        /* odd - being written, 2 * (record + 1) - complete (atomic) */
+    uint64_t        frame;
+    int64_t         timestamp;
+    uint64_t        reserved;
+    Publish_Reading sensor[];
+};
+
+struct _publisher
+{
+    Publish_Header *header;
+    unsigned char  *slots;
+    size_t          size;
+    uint64_t        head;       /* record being written */
+    char            name[256];
+};
+
+struct _publish_reader
+{
+    const Publish_Header *header;
+    const unsigned char  *slots;
+    size_t                size;
+};
+
+static inline size_t
+_publish_align(size_t size)
+{
+    return (size + PUBLISH_ALIGN - 1) / PUBLISH_ALIGN * PUBLISH_ALIGN;
+}
+
+static inline const Publish_Slot *
+_publish_slot(const Publish_Header *h, const unsigned char *slots, uint64_t number)
+{
+    return (const Publish_Slot *)(slots + (size_t)(number & (h->capacity - 1)) * h->slot_size);
+}
+
+int64_t
+publish_now(void)
+{
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (int64_t)t.tv_sec * 1000000000 + t.tv_nsec;
+}
+
+Publisher *
+publisher_open(const char *name, index_t n_sensors, uint32_t capacity)
+{
+    if ((n_sensors == 0) || (capacity == 0) || (strlen(name) >= sizeof(((Publisher *)0)->name))) return NULL;
+
+    uint32_t n = 1;
+    while (n < capacity) n <<= 1;
+
+    const size_t slot_size = _publish_align(sizeof(Publish_Slot) + (size_t)n_sensors * sizeof(Publish_Reading));
+    const size_t size = PUBLISH_ALIGN + (size_t)n * slot_size;
+
+    /* the object is recreated: readers of the previous one keep their mapping */
+    shm_unlink(name);
+    int fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd < 0) return NULL;
+    if (ftruncate(fd, size) != 0)
+    {
+        close(fd);
+        shm_unlink(name);
+        return NULL;
+    }
+    unsigned char *map = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED)
+    {
+        shm_unlink(name);
+        return NULL;
+    }
+
+    Publisher *p = MEM_callocN(sizeof(Publisher), "publisher_open: publisher");
+    p->header = (Publish_Header *)map;
+    p->slots  = map + PUBLISH_ALIGN;
+    p->size   = size;
+    p->head   = 0;
+    strcpy(p->name, name);
+
+    /* the memory is zero: no record is complete; magic is written the last */
+    p->header->version   = PUBLISH_VERSION;
+    p->header->n_sensors = n_sensors;
+    p->header->capacity  = n;
+    p->header->slot_size = slot_size;
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    memcpy(p->header->magic, PUBLISH_MAGIC, sizeof(p->header->magic));
+
+    return p;
+}
+
+void
+publisher_close(Publisher *p, bool unlink)
+{
+    if (p == NULL) return;
+
+    munmap(p->header, p->size);
+    if (unlink) shm_unlink(p->name);
+    MEM_freeN(p);
+}
+
+Publish_Reading *
+publisher_begin(Publisher *p)
+{
+    Publish_Slot *slot = (Publish_Slot *)_publish_slot(p->header, p->slots, p->head);
+
+    /* readers of the slot fail from now on, the readings are not written before the mark */
+    atomic_store_uint64(&slot->seq, 2 * p->head + 1);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+
+    return slot->sensor;
+}
+
+void
+publisher_commit(Publisher *p, uint64_t frame)
+{
+    Publish_Slot *slot = (Publish_Slot *)_publish_slot(p->header, p->slots, p->head);
+
+    slot->frame = frame;
+    slot->timestamp = publish_now();
+    atomic_store_uint64(&slot->seq, 2 * (p->head + 1));
+    atomic_store_uint64(&p->header->head, ++p->head);
+}
+
+Publish_Reader *
+publish_reader_open(const char *name)
+{
+    int fd = shm_open(name, O_RDONLY, 0);
+    if (fd < 0) return NULL;
+
+    struct stat st;
+    if ((fstat(fd, &st) != 0) || ((size_t)st.st_size < PUBLISH_ALIGN))
+    {
+        close(fd);
+        return NULL;
+    }
+    const size_t size = st.st_size;
+    const unsigned char *map = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) return NULL;
+
+    const Publish_Header *h = (const Publish_Header *)map;
+    bool valid = (memcmp(h->magic, PUBLISH_MAGIC, sizeof(h->magic)) == 0);
+    __atomic_thread_fence(__ATOMIC_ACQUIRE); /* the header is written before magic */
+    valid = valid && (h->version == PUBLISH_VERSION) && (h->capacity > 0)
+                  && ((h->capacity & (h->capacity - 1)) == 0)
+                  && (h->slot_size >= sizeof(Publish_Slot) + (size_t)h->n_sensors * sizeof(Publish_Reading))
+                  && (PUBLISH_ALIGN + (size_t)h->capacity * h->slot_size <= size);
+    if (!valid)
+    {
+        munmap((void *)map, size);
+        return NULL;
+    }
+
+    Publish_Reader *r = MEM_callocN(sizeof(Publish_Reader), "publish_reader_open: reader");
+    r->header = h;
+    r->slots  = map + PUBLISH_ALIGN;
+    r->size   = size;
+    return r;
+}
+
+void
+publish_reader_close(Publish_Reader *r)
+{
+    if (r == NULL) return;
+
+    munmap((void *)r->header, r->size);
+    MEM_freeN(r);
+}
+
+index_t
+publish_reader_sensors(const Publish_Reader *r)
+{
+    return r->header->n_sensors;
+}
+
+uint64_t
+publish_reader_head(const Publish_Reader *r)
+{
+    return atomic_load_uint64(&r->header->head);
+}
+
+int
+publish_read(const Publish_Reader *r, uint64_t number, Publish_Record *record, Publish_Reading *reading)
+{
+    const Publish_Slot *slot = _publish_slot(r->header, r->slots, number);
+    const uint64_t expected = 2 * (number + 1);
+
+    for (index_t attempt = 0; attempt < PUBLISH_READ_SPIN; attempt++)
+    {
+        const uint64_t seq = atomic_load_uint64(&slot->seq);
+        if (seq == expected - 1) continue;  /* being written */
+        if (seq != expected) return -1;     /* not yet written or overwritten */
+
+        record->number    = number;
+        record->frame     = slot->frame;
+        record->timestamp = slot->timestamp;
+        memcpy(reading, slot->sensor, sizeof(Publish_Reading) * r->header->n_sensors);
+
+        /* the copy is complete before the sequence number is checked again */
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (atomic_load_uint64(&slot->seq) == expected) return 0;
+    }
+    return -1;
+}
@@ -56,4 +56,40 @@ data_t random_range_zero_one(void);
 /// @return random value of type data_t
 data_t random_range_pm_one(void);
 
-#endif
\ No newline at end of file
+/// @brief State of an independent random stream (xoshiro256**).
+/// Unlike the functions above it has no global state, so every thread
+/// (or every Monte Carlo trial) draws from its own stream.
+typedef struct _random_stream Random_Stream;
+struct _random_stream
+{
+    uint64_t s[4];
+};
+
+/// @brief Seeds random stream
+/// @param rs Random stream
+/// @param seed Seed of the experiment
+/// @param stream Number of the stream (trial, thread), streams of the same
+/// seed are seeded by splitmix64 of (seed, stream) and do not correlate
+void random_stream_init(Random_Stream *rs, uint64_t seed, uint64_t stream);
+
+/// @brief Next random number of stream
+/// @param rs Random stream
+/// @return uniformly distributed 64-bit value
+uint64_t random_stream_next(Random_Stream *rs);
+
+/// @brief Random number of stream in range [0,1)
+/// @param rs Random stream
+/// @return random value of type data_t
+data_t random_stream_zero_one(Random_Stream *rs);
+
+/// @brief Random number of stream in range [-1,1)
+/// @param rs Random stream
+/// @return random value of type data_t
+data_t random_stream_pm_one(Random_Stream *rs);
+
+/// @brief Normally distributed random number of stream (Box-Muller)
+/// @param rs Random stream
+/// @return random value of zero mean and unit variance
+data_t random_stream_normal(Random_Stream *rs);
+
+#endif
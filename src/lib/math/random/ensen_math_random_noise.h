@@ -94,4 +94,27 @@ data_t *initPink(int depth, data_t alpha);
 /// @return value of type data_t
 data_t *initBlue(int depth, data_t alpha);
 
-#endif
\ No newline at end of file
+// Noise of random streams (reentrant)
+
+#define NOISE_RANDOM 0 /* uniform in [-1,1) */
+#define NOISE_WHITE  1 /* normal */
+#define NOISE_BROWN  2 /* integrated white noise (leaky, stationary) */
+#define NOISE_VIOLET 3 /* differentiated white noise */
+
+/// @brief Starts noise sequence of color
+/// @param rs Random stream
+/// @param color Noise color (NOISE_*)
+/// @return state of the sequence for random_stream_noise()
+data_t random_stream_noise_start(Random_Stream *rs, index_t color);
+
+/// @brief Next value of noise sequence of color
+/// @param rs Random stream
+/// @param color Noise color (NOISE_*, pink and blue are not implemented:
+/// they are NOISE_RANDOM)
+/// @param state State of the sequence (from random_stream_noise_start())
+/// @return value of type data_t
+/// Every color has the variance of NOISE_RANDOM (1/3), so noise amplitude
+/// means the same noise power for all colors.
+data_t random_stream_noise(Random_Stream *rs, index_t color, data_t *state);
+
+#endif
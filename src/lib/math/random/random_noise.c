@@ -224,4 +224,36 @@ genBlueNoise(data_t *B, data_t *A, int depth)
   // Assign the dot product to the last value of PN
   B[depth - 2] = dot;
   return B[depth - 2];
-}
\ No newline at end of file
+}
+
+/* standard deviation of the uniform noise in [-1,1) */
+#define NOISE_SIGMA 0.57735026918962576
+/* correlation of the neighbour values of brown noise */
+#define NOISE_BROWN_R 0.98
+
+data_t
+random_stream_noise_start(Random_Stream *rs, index_t color)
+{
+  /* brown noise starts in its stationary state */
+  return (color == NOISE_BROWN || color == NOISE_VIOLET) ? random_stream_normal(rs) : 0;
+}
+
+data_t
+random_stream_noise(Random_Stream *rs, index_t color, data_t *state)
+{
+  data_t w;
+  switch (color)
+  {
+  case NOISE_WHITE:
+    return NOISE_SIGMA * random_stream_normal(rs);
+  case NOISE_BROWN:
+    *state = NOISE_BROWN_R * (*state) + sqrt(1 - NOISE_BROWN_R * NOISE_BROWN_R) * random_stream_normal(rs);
+    return NOISE_SIGMA * (*state);
+  case NOISE_VIOLET:
+    w = *state;
+    *state = random_stream_normal(rs);
+    return NOISE_SIGMA * (*state - w) / R2;
+  default:
+    return random_stream_pm_one(rs);
+  }
+}
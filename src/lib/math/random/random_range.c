@@ -1,3 +1,4 @@
+#include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <time.h> /* srand48() */
@@ -121,3 +122,64 @@ random_range_pm_one(void)
     /* return (data_t)mrand48()/RAND_MAX; */
 }
 
+static uint64_t
+_splitmix64(uint64_t *x)
+{
+  uint64_t z = (*x += 0x9e3779b97f4a7c15ULL);
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+  return z ^ (z >> 31);
+}
+
+static inline uint64_t
+_rotl(uint64_t x, int k)
+{
+  return (x << k) | (x >> (64 - k));
+}
+
+void
+random_stream_init(Random_Stream *rs, uint64_t seed, uint64_t stream)
+{
+  /* the stream number is mixed before the seed, so (seed, stream) pairs do not overlap */
+  uint64_t x = seed;
+  x ^= _splitmix64(&stream);
+  for (index_t i = 0; i < 4; i++) rs->s[i] = _splitmix64(&x);
+}
+
+uint64_t
+random_stream_next(Random_Stream *rs)
+{
+  uint64_t *s = rs->s;
+  const uint64_t result = _rotl(s[1] * 5, 7) * 9;
+  const uint64_t t = s[1] << 17;
+
+  s[2] ^= s[0];
+  s[3] ^= s[1];
+  s[1] ^= s[2];
+  s[0] ^= s[3];
+  s[2] ^= t;
+  s[3] = _rotl(s[3], 45);
+
+  return result;
+}
+
+data_t
+random_stream_zero_one(Random_Stream *rs)
+{
+  /* the upper 53 bits fill the mantissa */
+  return (random_stream_next(rs) >> 11) * 0x1.0p-53;
+}
+
+data_t
+random_stream_pm_one(Random_Stream *rs)
+{
+  return 2 * random_stream_zero_one(rs) - 1;
+}
+
+data_t
+random_stream_normal(Random_Stream *rs)
+{
+  const data_t u = 1 - random_stream_zero_one(rs); /* (0,1], log is finite */
+  const data_t v = random_stream_zero_one(rs);
+  return sqrt(-2 * log(u)) * cos(2 * M_PI * v);
+}
@@ -163,6 +163,8 @@ extern void (*MEM_set_memory_debug)(void);
 extern size_t (*MEM_get_memory_in_use)(void);
 /** Get amount of memory blocks in use. */
 extern unsigned int (*MEM_get_memory_blocks_in_use)(void);
+/** Get number of allocations since the start (never decreases, a steady loop must not change it). */
+extern size_t (*MEM_get_memory_allocations)(void);
 
 /** Reset the peak memory statistic to zero. */
 extern void (*MEM_reset_peak_memory)(void);
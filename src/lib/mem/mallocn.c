@@ -39,6 +39,7 @@ bool (*MEM_consistency_check)(void) = MEM_lockfree_consistency_check;
 void (*MEM_set_memory_debug)(void) = MEM_lockfree_set_memory_debug;
 size_t (*MEM_get_memory_in_use)(void) = MEM_lockfree_get_memory_in_use;
 uint (*MEM_get_memory_blocks_in_use)(void) = MEM_lockfree_get_memory_blocks_in_use;
+size_t (*MEM_get_memory_allocations)(void) = MEM_lockfree_get_memory_allocations;
 void (*MEM_reset_peak_memory)(void) = MEM_lockfree_reset_peak_memory;
 size_t (*MEM_get_peak_memory)(void) = MEM_lockfree_get_peak_memory;
 
@@ -119,6 +120,7 @@ void MEM_use_lockfree_allocator(void)
   MEM_set_memory_debug = MEM_lockfree_set_memory_debug;
   MEM_get_memory_in_use = MEM_lockfree_get_memory_in_use;
   MEM_get_memory_blocks_in_use = MEM_lockfree_get_memory_blocks_in_use;
+  MEM_get_memory_allocations = MEM_lockfree_get_memory_allocations;
   MEM_reset_peak_memory = MEM_lockfree_reset_peak_memory;
   MEM_get_peak_memory = MEM_lockfree_get_peak_memory;
 
@@ -151,6 +153,7 @@ void MEM_use_guarded_allocator(void)
   MEM_set_memory_debug = MEM_guarded_set_memory_debug;
   MEM_get_memory_in_use = MEM_guarded_get_memory_in_use;
   MEM_get_memory_blocks_in_use = MEM_guarded_get_memory_blocks_in_use;
+  MEM_get_memory_allocations = MEM_guarded_get_memory_allocations;
   MEM_reset_peak_memory = MEM_guarded_reset_peak_memory;
   MEM_get_peak_memory = MEM_guarded_get_peak_memory;
 
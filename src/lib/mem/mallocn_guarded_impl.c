@@ -149,6 +149,7 @@ static const char *check_memlist(MemHead *memh);
 
 static uint totblock = 0;
 static size_t mem_in_use = 0, peak_mem = 0;
+static size_t totalloc = 0;
 
 static volatile struct localListBase _membase;
 static volatile struct localListBase *membase = &_membase;
@@ -444,6 +445,7 @@ static void make_memhead_header(MemHead *memh, size_t len, const char *str)
   memt->tag3 = MEMTAG3;
 
   atomic_add_and_fetch_u(&totblock, 1);
+  atomic_add_and_fetch_z(&totalloc, 1);
   atomic_add_and_fetch_z(&mem_in_use, len);
 
   mem_lock_thread();
@@ -1244,6 +1246,17 @@ uint MEM_guarded_get_memory_blocks_in_use(void)
   return _totblock;
 }
 
+size_t MEM_guarded_get_memory_allocations(void)
+{
+  size_t _totalloc;
+
+  mem_lock_thread();
+  _totalloc = totalloc;
+  mem_unlock_thread();
+
+  return _totalloc;
+}
+
 #ifndef NDEBUG
 const char *MEM_guarded_name_ptr(void *vmemh)
 {
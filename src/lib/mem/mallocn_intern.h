@@ -93,6 +93,7 @@ void memory_usage_init(void);
 void memory_usage_block_alloc(size_t size);
 void memory_usage_block_free(size_t size);
 size_t memory_usage_block_num(void);
+size_t memory_usage_allocation_num(void);
 size_t memory_usage_current(void);
 size_t memory_usage_peak(void);
 void memory_usage_peak_reset(void);
@@ -134,6 +135,7 @@ bool MEM_lockfree_consistency_check(void);
 void MEM_lockfree_set_memory_debug(void);
 size_t MEM_lockfree_get_memory_in_use(void);
 unsigned int MEM_lockfree_get_memory_blocks_in_use(void);
+size_t MEM_lockfree_get_memory_allocations(void);
 void MEM_lockfree_reset_peak_memory(void);
 size_t MEM_lockfree_get_peak_memory(void) ATTR_WARN_UNUSED_RESULT;
 #ifndef NDEBUG
@@ -178,6 +180,7 @@ bool MEM_guarded_consistency_check(void);
 void MEM_guarded_set_memory_debug(void);
 size_t MEM_guarded_get_memory_in_use(void);
 unsigned int MEM_guarded_get_memory_blocks_in_use(void);
+size_t MEM_guarded_get_memory_allocations(void);
 void MEM_guarded_reset_peak_memory(void);
 size_t MEM_guarded_get_peak_memory(void) ATTR_WARN_UNUSED_RESULT;
 #ifndef NDEBUG
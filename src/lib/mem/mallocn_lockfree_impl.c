@@ -386,6 +386,11 @@ uint MEM_lockfree_get_memory_blocks_in_use(void)
   return (uint)memory_usage_block_num();
 }
 
+size_t MEM_lockfree_get_memory_allocations(void)
+{
+  return memory_usage_allocation_num();
+}
+
 /* dummy */
 void MEM_lockfree_reset_peak_memory(void)
 {
@@ -45,6 +45,10 @@ struct alignas(128) Local {
    * Number of allocated blocks. Can be negative and is atomic for the same reason as above.
    */
   std::atomic<int64_t> blocks_num = 0;
+  /**
+   * Number of allocations made by the thread (never decreases).
+   */
+  std::atomic<int64_t> allocations_num = 0;
   /**
    * Amount of memory used when the peak was last updated. This is used so that we don't have to
    * update the peak memory usage after every memory allocation. Instead it's only updated when "a
@@ -88,6 +92,10 @@ struct Global {
    * Number of blocks that are not tracked by #Local, for the same reason as above.
    */
   std::atomic<int64_t> blocks_num_outside_locals = 0;
+  /**
+   * Number of allocations that are not tracked by #Local, for the same reason as above.
+   */
+  std::atomic<int64_t> allocations_num_outside_locals = 0;
   /**
    * Peak memory usage since the last reset.
    */
@@ -150,6 +158,8 @@ Local::~Local()
   /* Don't forget the memory counts stored locally. */
   this->global->blocks_num_outside_locals.fetch_add(this->blocks_num, std::memory_order_relaxed);
   this->global->mem_in_use_outside_locals.fetch_add(this->mem_in_use, std::memory_order_relaxed);
+  this->global->allocations_num_outside_locals.fetch_add(this->allocations_num,
+                                                         std::memory_order_relaxed);
 
   if (this->is_main) {
     /* The main thread started shutting down. Use global counters from now on to avoid accessing
@@ -192,6 +202,7 @@ void memory_usage_block_alloc(const size_t size)
      * synchronization if another thread is computing the total current memory usage at the same
      * time, which is very rare compared to doing allocations. */
     local.blocks_num.fetch_add(1, std::memory_order_relaxed);
+    local.allocations_num.fetch_add(1, std::memory_order_relaxed);
     local.mem_in_use.fetch_add(int64_t(size), std::memory_order_relaxed);
 
     /* If a certain amount of new memory has been allocated, update the peak. */
@@ -203,6 +214,7 @@ void memory_usage_block_alloc(const size_t size)
     Global &global = get_global();
     /* Increase global memory counts. */
     global.blocks_num_outside_locals.fetch_add(1, std::memory_order_relaxed);
+    global.allocations_num_outside_locals.fetch_add(1, std::memory_order_relaxed);
     global.mem_in_use_outside_locals.fetch_add(int64_t(size), std::memory_order_relaxed);
   }
 }
@@ -237,6 +249,19 @@ size_t memory_usage_block_num()
   return size_t(blocks_num);
 }
 
+size_t memory_usage_allocation_num()
+{
+  Global &global = get_global();
+  std::lock_guard lock{global.locals_mutex};
+
+  /* Count all allocations made so far. */
+  int64_t allocations_num = global.allocations_num_outside_locals;
+  for (Local *local : global.locals) {
+    allocations_num += local->allocations_num;
+  }
+  return size_t(allocations_num);
+}
+
 size_t memory_usage_current()
 {
   Global &global = get_global();
@@ -1,11 +1,257 @@
-#include "signal/ensen_benchmark.h"
+#define _GNU_SOURCE /* syscall() */
 
+#include <pthread.h>
+#include <string.h>
 #include <time.h> // get_time()
+#include <unistd.h>
+#ifdef __linux__
+    #include <linux/perf_event.h>
+    #include <sys/ioctl.h>
+    #include <sys/syscall.h>
+#endif
+
+#include "signal/ensen_benchmark.h"
+#include "mem/atomic_ops.h"
+
+static Profile_Region  profile_region[PROFILE_REGIONS_MAX];
+static uint32_t        profile_n_regions = 0;   /* atomic, regions are appended under the lock */
+static pthread_mutex_t profile_lock = PTHREAD_MUTEX_INITIALIZER;
+static uint32_t        profile_on = 0;          /* atomic */
+static uint32_t        profile_mask = 0;        /* atomic, counters opened by all threads */
+
+static const char *profile_counter_name[PROFILE_COUNTERS] = { "cycles", "instr", "L1D miss", "LLC miss", "br. miss" };
+
+/* Counters of a thread: one group, all values are read at once */
+typedef struct {
+    int      state;                      /* 0 - not opened yet, 1 - open, -1 - not available */
+    int      fd[PROFILE_COUNTERS];       /* descriptors of the group, the first one leads (closed when the thread exits) */
+    index_t  n;                          /* counters in the group */
+    index_t  index[PROFILE_COUNTERS];    /* Profile_Counter of the values of the group */
+    unsigned mask;
+} Profile_Thread;
+
+static __thread Profile_Thread profile_thread;
+
+#ifdef __linux__
+static const struct {
+    uint32_t type;
+    uint64_t config;
+} profile_event[PROFILE_COUNTERS] = {
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+    { PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16) },
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES },
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES },
+};
+
+static int
+_profile_event_open(Profile_Counter c, int group)
+{
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size           = sizeof(attr);
+    attr.type           = profile_event[c].type;
+    attr.config         = profile_event[c].config;
+    attr.disabled       = (group < 0);   /* the group is enabled when complete */
+    attr.exclude_kernel = 1;
+    attr.exclude_hv     = 1;
+    attr.read_format    = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    return syscall(SYS_perf_event_open, &attr, 0, -1, group, PERF_FLAG_FD_CLOEXEC);
+}
+
+static pthread_key_t  profile_key;
+static pthread_once_t profile_key_once = PTHREAD_ONCE_INIT;
+
+/* Destructor of profile_key (the descriptors of the main thread are closed with the process) */
+static void
+_profile_thread_close(void *data)
+{
+    Profile_Thread *t = data;
+    for (index_t k = 0; k < t->n; k++) close(t->fd[k]);
+    t->state = -1;
+    t->n = 0;
+    t->mask = 0;
+}
+
+static void
+_profile_key_create(void)
+{
+    pthread_key_create(&profile_key, _profile_thread_close);
+}
+#endif
+
+/* Values of the group of thread, false if they cannot be read */
+static bool
+_profile_group_read(const Profile_Thread *t, Profile_Mark *m)
+{
+    uint64_t value[3 + PROFILE_COUNTERS];   /* number of values, times enabled and running, the values */
+    const ssize_t size = sizeof(uint64_t) * (3 + t->n);
+    if (read(t->fd[0], value, size) != size) return false;
+
+    m->enabled = value[1];
+    m->running = value[2];
+    for (index_t k = 0; k < t->n; k++) m->counter[t->index[k]] = value[3 + k];
+    return true;
+}
+
+static void
+_profile_thread_open(Profile_Thread *t)
+{
+    t->state = -1;
+    t->n = 0;
+    t->mask = 0;
+
+#ifdef __linux__
+    /* counters which are not supported by the CPU (or VM) are skipped */
+    for (index_t c = 0; c < PROFILE_COUNTERS; c++)
+    {
+        const int fd = _profile_event_open(c, (t->n > 0) ? t->fd[0] : -1);
+        if (fd < 0) continue;
+        t->fd[t->n] = fd;
+        t->index[t->n++] = c;
+        t->mask |= 1u << c;
+    }
+    if (t->n == 0) return;
+    if ((pthread_once(&profile_key_once, _profile_key_create) != 0) || (pthread_setspecific(profile_key, t) != 0)
+        || (ioctl(t->fd[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP) != 0))
+    {
+        _profile_thread_close(t);
+        return;
+    }
+
+    /* a group which does not fit the free counters (watchdog, other users) is opened, but never runs */
+    Profile_Mark m;
+    if (!_profile_group_read(t, &m) || (m.running == 0))
+    {
+        _profile_thread_close(t);
+        return;
+    }
 
-double 
+    t->state = 1;
+    atomic_fetch_and_or_uint32(&profile_mask, t->mask);
+#endif
+}
+
+static bool
+_profile_read(Profile_Mark *m)
+{
+    Profile_Thread *t = &profile_thread;
+    if (t->state == 0) _profile_thread_open(t);
+    if (t->state < 0) return false;
+
+    return _profile_group_read(t, m);
+}
+
+static Profile_Region *
+_profile_region(const char *name)
+{
+    index_t n = atomic_load_uint32(&profile_n_regions);
+    for (index_t i = 0; i < n; i++)
+    {
+        if ((profile_region[i].name == name) || (strcmp(profile_region[i].name, name) == 0)) return &profile_region[i];
+    }
+
+    Profile_Region *r = NULL;
+    pthread_mutex_lock(&profile_lock);
+    for (index_t i = n; (r == NULL) && (i < profile_n_regions); i++)
+    {
+        if (strcmp(profile_region[i].name, name) == 0) r = &profile_region[i];
+    }
+    n = profile_n_regions;
+    if ((r == NULL) && (n < PROFILE_REGIONS_MAX))
+    {
+        r = &profile_region[n];
+        r->name = name;
+        atomic_store_uint32(&profile_n_regions, n + 1);
+    }
+    pthread_mutex_unlock(&profile_lock);
+    return r;
+}
+
+double
 get_run_time(void)
 {
     struct timespec tv;
     clock_gettime(CLOCK_MONOTONIC, &tv);
     return tv.tv_sec + tv.tv_nsec / 1000000000.0;
-}
\ No newline at end of file
+}
+
+unsigned
+profile_enable(void)
+{
+    atomic_store_uint32(&profile_on, 1);
+    if (profile_thread.state == 0) _profile_thread_open(&profile_thread);
+    return profile_thread.mask;
+}
+
+void
+profile_begin(Profile_Mark *m)
+{
+    m->counted = atomic_load_uint32(&profile_on) && _profile_read(m);
+    m->time = get_run_time();
+}
+
+double
+profile_end(const Profile_Mark *m, const char *region)
+{
+    const double time = get_run_time() - m->time;
+    if (!atomic_load_uint32(&profile_on)) return time;
+
+    Profile_Mark end;
+    const bool counted = m->counted && _profile_read(&end) && (end.running > m->running);
+    Profile_Region *r = _profile_region(region);
+    if (r == NULL) return time;
+
+    atomic_fetch_and_add_uint64(&r->calls, 1);
+    atomic_fetch_and_add_uint64(&r->time, (uint64_t)(time * 1e9 + 0.5));
+    if (counted)
+    {
+        /* counters multiplexed with other events count a part of the region, they are scaled to all of it */
+        const uint64_t enabled = end.enabled - m->enabled, running = end.running - m->running;
+        const double scale = (running < enabled) ? (double)enabled / running : 1.0;
+        const unsigned mask = profile_thread.mask;
+        for (index_t c = 0; c < PROFILE_COUNTERS; c++)
+        {
+            if (mask & (1u << c)) atomic_fetch_and_add_uint64(&r->counter[c], (uint64_t)((end.counter[c] - m->counter[c]) * scale + 0.5));
+        }
+        atomic_fetch_and_add_uint64(&r->counted, 1);
+        if (running < enabled) atomic_fetch_and_add_uint64(&r->scaled, 1);
+    }
+    return time;
+}
+
+const Profile_Region *
+profile_regions(index_t *n_regions)
+{
+    *n_regions = atomic_load_uint32(&profile_n_regions);
+    return profile_region;
+}
+
+void
+profile_print(FILE *f)
+{
+    index_t n = 0;
+    const Profile_Region *region = profile_regions(&n);
+    const unsigned mask = atomic_load_uint32(&profile_mask);
+
+    fprintf(f, "%-20s %10s %10s", "region", "calls", "mean, us");
+    for (index_t c = 0; c < PROFILE_COUNTERS; c++) fprintf(f, " %12s", profile_counter_name[c]);
+    fprintf(f, " %6s\n", "IPC");
+
+    for (index_t i = 0; i < n; i++)
+    {
+        const Profile_Region *r = &region[i];
+        fprintf(f, "%-20s %10llu %10.2f", r->name, (unsigned long long)r->calls, (r->calls > 0) ? 1e-3 * r->time / r->calls : 0.0);
+        for (index_t c = 0; c < PROFILE_COUNTERS; c++)
+        {
+            if ((mask & (1u << c)) && (r->counted > 0)) fprintf(f, " %11.0f%c", (double)r->counter[c] / r->counted, (r->scaled > 0) ? '~' : ' ');
+            else fprintf(f, " %12s", "-");
+        }
+        const unsigned ipc = (1u << PROFILE_CYCLES) | (1u << PROFILE_INSTRUCTIONS);
+        if (((mask & ipc) == ipc) && (r->counter[PROFILE_CYCLES] > 0))
+        {
+            fprintf(f, " %6.2f\n", (double)r->counter[PROFILE_INSTRUCTIONS] / r->counter[PROFILE_CYCLES]);
+        }
+        else fprintf(f, " %6s\n", "-");
+    }
+}
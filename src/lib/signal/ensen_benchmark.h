@@ -1,6 +1,95 @@
 #ifndef ENSEN_BENCHMARK_H
 #define ENSEN_BENCHMARK_H
 
+#ifndef ENSEN_PRIVATE_H
+    #include "ensen_private.h"
+#endif
+
+/*
+ * Profiling regions: wall time and hardware counters (perf_event_open) of
+ * named code regions, summed over all calls and threads. Counters count the
+ * calling thread in user space; every thread opens its own counters at its
+ * first region. When counters are not permitted (perf_event_paranoid,
+ * containers, other systems) regions are timed only. Profiling is off until
+ * profile_enable(): a region costs then two clock reads, as get_run_time().
+ */
+
+#define PROFILE_REGIONS_MAX 16
+
+typedef enum {
+    PROFILE_CYCLES = 0,
+    PROFILE_INSTRUCTIONS,
+    PROFILE_L1D_MISSES,     /* L1 data cache read misses */
+    PROFILE_LLC_MISSES,     /* last level cache misses */
+    PROFILE_BRANCH_MISSES,
+    PROFILE_COUNTERS
+} Profile_Counter;
+
+/* Start of a region (on the stack of the caller, regions may be nested) */
+typedef struct _profile_mark Profile_Mark;
+struct _profile_mark
+{
+    double   time;
+    uint64_t counter[PROFILE_COUNTERS];
+    uint64_t enabled;   /* time of the counters (nsec): enabled */
+    uint64_t running;   /* and on the CPU (less if they are multiplexed with other events) */
+    bool     counted;   /* counters were read */
+};
+
+typedef struct _profile_region Profile_Region;
+struct _profile_region
+{
+    const char *name;
+    uint64_t    calls;
+    uint64_t    time;                       /* nsec */
+    uint64_t    counter[PROFILE_COUNTERS];  /* events of calls with counters */
+    uint64_t    counted;                    /* calls with counters */
+    uint64_t    scaled;                     /* of them, with multiplexed counters (scaled to the time enabled) */
+};
+
+/**
+    @brief Wall clock
+    @return CLOCK_MONOTONIC (sec)
+**/
 double get_run_time(void);
 
-#endif
\ No newline at end of file
+/**
+    @brief Start profiling of regions
+    @return Hardware counters open for the calling thread (bit k -
+            Profile_Counter k), 0 if regions are timed only
+**/
+unsigned profile_enable(void);
+
+/**
+    @brief Enter region
+    @param m Mark of the region start
+**/
+void profile_begin(Profile_Mark *m);
+
+/**
+    @brief Leave region
+    @param m Mark of profile_begin()
+    @param region Name of region (string constant, at most PROFILE_REGIONS_MAX
+                  names are kept, the others are timed only)
+    @return Time since profile_begin() (sec)
+**/
+double profile_end(const Profile_Mark *m, const char *region);
+
+/**
+    @brief Profiled regions
+    @param n_regions Number of regions
+    @return Regions in order of their first call (valid until exit)
+**/
+const Profile_Region *profile_regions(index_t *n_regions);
+
+/**
+    @brief Print regions
+    @param f Stream
+
+    Calls, mean time and, per call, cycles, instructions (IPC), L1D, LLC
+    and branch misses; a column is "-" if the counter is not available,
+    values are marked with "~" if some calls were scaled.
+**/
+void profile_print(FILE *f);
+
+#endif
@@ -4,8 +4,20 @@
 #include "ensen_private.h"
 
 #include "ensen_signal_fit.h"
+#include "ensen_signal_batch.h"
+#include "ensen_signal_calib.h"
+#include "ensen_signal_cwt.h"
+#include "ensen_signal_polyfit.h"
+#include "ensen_signal_ring.h"
+#include "ensen_signal_sensor.h"
 #include "ensen_signal_form_gaussian.h"
 #include "ensen_signal_form_random.h"
 #include "ensen_signal_generator.h"
+#include "ensen_signal_grid.h"
+#include "ensen_signal_stats.h"
+#include "ensen_signal_stream.h"
+#include "ensen_signal_tracker.h"
+#include "ensen_signal_view.h"
+#include "ensen_signal_xcorr.h"
 
 #endif
\ No newline at end of file
@@ -0,0 +1,45 @@
+#ifndef ENSEN_SIGNAL_BATCH_H
+#define ENSEN_SIGNAL_BATCH_H
+
+#ifndef ENSEN_PRIVATE_H
+    #include "ensen_private.h"
+#endif
+
+#include "thread/ensen_thread_pool.h"
+
+typedef struct _peak_batch Peak_Batch;
+struct _peak_batch
+{
+    uint32_t                   n_frames;
+    data_t                  ** frame;  /* frames (smoothed in place) */
+    const Signal_Parameters ** conf;   /* parameters of every frame (may point to the same one) */
+    Peaks                    * peaks;  /* found peaks of every frame (peak arrays of search.peaks_array_number) */
+    const data_t            ** source; /* NULL - frames are smoothed in place, else frame f is smoothed from
+                                          source[f] (read only, e.g. mapped capture) into frame[f] */
+    data_t                   * scratch;/* smoothing memory of the workers: thread_pool_size(pool) x n_points
+                                          of the longest frame (allocated by the caller once for all batches) */
+};
+
+/**
+    @brief Smooth and find peaks in independent frames in parallel
+    @param pool Thread pool
+    @param batch Frames, their parameters and results
+    @return Time of execution (in sec.)
+
+    Every frame is smoothed (smooth.level passes of smooth.width) and
+    searched by findpeaks() on one worker with its own part of scratch, so
+    the result of a frame does not depend on the number of workers or on
+    the order in which frames are taken. Nothing is allocated.
+
+    @code
+    Thread_Pool *pool = thread_pool_new(0);
+    data_t *scratch = MEM_malloc_arrayN((size_t)thread_pool_size(pool) * n_points, sizeof(data_t), "scratch");
+    Peak_Batch batch = { n_frames, frames, confs, peaks, NULL, scratch };
+    findpeaks_batch(pool, &batch);
+    MEM_freeN(scratch);
+    thread_pool_free(pool);
+    @endcode
+**/
+data_t findpeaks_batch(Thread_Pool *pool, const Peak_Batch *batch);
+
+#endif
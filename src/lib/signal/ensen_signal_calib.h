@@ -0,0 +1,81 @@
+#ifndef ENSEN_SIGNAL_CALIB_H
+#define ENSEN_SIGNAL_CALIB_H
+
+#ifndef ENSEN_PRIVATE_H
+    #include "ensen_private.h"
+#endif
+
+/*
+ * Calibration of sensors: temperature of every sensor as a function of the
+ * shift of its peak from the reference position (x units), a polynomial or
+ * a piecewise-linear table per sensor. Coefficients of polynomials are kept
+ * by power over all sensors (structure of arrays), so every Horner step of
+ * a frame is one vector loop over sensors; tables are interpolated after
+ * a binary search of the segment. Evaluation does not allocate and does not
+ * modify the model: one model may be shared by threads.
+ */
+
+#define CALIB_ORDER_MAX 7   /* highest power of a polynomial */
+
+typedef struct _calibration Calibration;
+struct _calibration
+{
+    index_t   n_sensors;
+    index_t   order;            /* highest power of all polynomials */
+    data_t  * coefficient;      /* (CALIB_ORDER_MAX + 1) x n_sensors: coefficient[k * n_sensors + s] of shift^k */
+    index_t   n_tables;         /* sensors with tables */
+    index_t * table;            /* their numbers (their polynomials are 0) */
+    index_t * n_knots;          /* of the table of every sensor (0 - polynomial) */
+    data_t ** knot_shift;       /* ascending */
+    data_t ** knot_temperature;
+};
+
+/**
+    @brief Allocate calibration of linear sensors
+    @param n_sensors Number of sensors
+    @param temperature Temperature at the reference position
+    @param coefficient Shift of peak per degree (x units)
+    @return Calibration (temperature + shift / coefficient for every
+            sensor), NULL if there are no sensors or coefficient is 0
+**/
+Calibration *calibration_new(index_t n_sensors, data_t temperature, data_t coefficient);
+
+/**
+    @brief Free calibration
+    @param c Calibration (may be NULL)
+**/
+void calibration_free(Calibration *c);
+
+/**
+    @brief Set polynomial of sensor
+    @param c Calibration
+    @param sensor Sensor number
+    @param coefficient Coefficients of shift^0 .. shift^(n - 1)
+    @param n Number of coefficients (1 .. CALIB_ORDER_MAX + 1)
+    @return 0 on success, -1 on wrong sensor or number
+**/
+int calibration_set_polynomial(Calibration *c, index_t sensor, const data_t *coefficient, index_t n);
+
+/**
+    @brief Set table of sensor
+    @param c Calibration
+    @param sensor Sensor number
+    @param shift Shifts of knots (strictly ascending, copied)
+    @param temperature Temperatures of knots (copied)
+    @param n Number of knots (at least 2)
+    @return 0 on success, -1 on wrong sensor, number or order of knots
+
+    Between knots temperature is linear, outside the table the first or the
+    last segment is extended.
+**/
+int calibration_set_table(Calibration *c, index_t sensor, const data_t *shift, const data_t *temperature, index_t n);
+
+/**
+    @brief Temperatures of all sensors
+    @param c Calibration
+    @param shift Shift of peak of every sensor (x units)
+    @param temperature Temperature of every sensor (not shift)
+**/
+void calibration_eval(const Calibration *c, const data_t *shift, data_t *temperature);
+
+#endif
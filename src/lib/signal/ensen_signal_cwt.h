@@ -0,0 +1,47 @@
+#ifndef ENSEN_SIGNAL_CWT_H
+#define ENSEN_SIGNAL_CWT_H
+
+#ifndef ENSEN_PRIVATE_H
+    #include "ensen_private.h"
+#endif
+
+typedef struct _cwt_plan Cwt_Plan;
+
+/**
+    @brief Create continuous wavelet transform peak detector
+    @param n_points Number of points in frame
+    @param scales Wavelet scales (points), any order
+    @param n_scales Number of scales (up to CWT_SCALES_MAX)
+    @return Detector with cached FFT plans and wavelet spectra (free with cwt_plan_free()),
+            NULL if scales are not valid
+
+    Mexican hat wavelets are precomputed in frequency domain, so one frame
+    costs one forward FFT and one inverse FFT per scale.
+**/
+Cwt_Plan *cwt_plan_new(index_t n_points, const data_t *scales, index_t n_scales);
+
+/**
+    @brief Free continuous wavelet transform peak detector
+    @param plan Detector
+**/
+void cwt_plan_free(Cwt_Plan *plan);
+
+/**
+    @brief Find peaks as ridge lines of continuous wavelet transform
+    @param plan Detector created for conf->n_points
+    @param y Signal (not smoothed)
+    @param p Found peaks (ascending positions, up to search.peaks_array_number)
+    @param conf Signal parameters (search thresholds are used)
+    @return Time of execution (in sec.)
+
+    Local maxima of the transform are linked across scales into ridge
+    lines, from the largest scale down. A ridge is a peak if it spans at
+    least half of the scales, its best coefficient is search.cwt_snr times
+    above the noise level (median absolute deviation at the smallest scale)
+    and the signal around it is above search.threshold_amp. The position is
+    taken at the scale with the best coefficient. Of two peaks closer than
+    the duplicate distance of findpeaks() the stronger one is kept.
+**/
+data_t cwt_findpeaks(Cwt_Plan *plan, const data_t *y, Peaks *p, const Signal_Parameters *conf);
+
+#endif
@@ -1,20 +1,67 @@
 #ifndef ENSEN_SIGNAL_FIT_H
 #define ENSEN_SIGNAL_FIT_H
 
-void signal_fit_gaussEliminationLS(int m, int n, double a[m][n], double x[n-1]);
-void signal_fit_printMatrix(int m, int n, double matrix[m][n]);
-void signal_fit(Point (*p)[], index_t n_points, index_t n_poly);
+int signal_fit(Point (*p)[], index_t n_points, index_t n_poly);
+int signal_fit_view(Points_View pv, index_t n_poly);
 void smooth(data_t *y, index_t n_points, index_t smoothwidth);
-index_t val2ind(data_t *x, index_t n_points, data_t val);
-data_t min(data_t *x, index_t n_points);
-data_t max(data_t *x, index_t n_points);
-data_t min_abs(data_t *x, index_t n_points);
-data_t max_abs(data_t *x, index_t n_points);
-data_t sum(data_t *x, index_t n_points);
+void smooth_view(View out, View in, index_t smoothwidth);
+
+/* Lanes smoothed together by smooth_lanes() (running sums kept in L1) */
+#define SMOOTH_LANES_GROUP 16
+
+/**
+    @brief Moving average of several signals at once (SIMD lanes)
+    @param out Smoothed signals (interleaved as in, not in)
+    @param in Signals interleaved point by point: in[i * n_lanes + lane]
+    @param n_points Number of points of every signal
+    @param n_lanes Number of signals
+    @param smoothwidth Width of window (points)
+
+    Every lane is the same as smooth_view() of its signal, but the inner
+    loop runs over the lanes of a point, two lanes per SSE2 instruction
+    ('nan' is masked out instead of branched over), for any number of
+    signals of the same length and window.
+**/
+void smooth_lanes(data_t *restrict out, const data_t *restrict in, index_t n_points, index_t n_lanes, index_t smoothwidth);
+
+/**
+    @brief Noise gain of the derivative of smoothed signal
+    @param smoothwidth Width of window (points, < 2 - no smoothing)
+    @param level Number of smooth_view() passes
+    @param variance Variance of the smoothing kernel (points^2)
+    @return Standard deviation of deriv() of smoothed white noise of unit
+            standard deviation
+
+    The kernel of level passes is computed exactly (allocates level *
+    smoothwidth points), so the gain is also right for one pass, whose
+    derivative is two spikes and not a Gaussian one.
+**/
+data_t smooth_derivative_gain(index_t smoothwidth, index_t level, data_t *variance);
+
+index_t val2ind(const data_t *x, index_t n_points, data_t val);
+data_t min(const data_t *x, index_t n_points);
+data_t max(const data_t *x, index_t n_points);
+data_t min_abs(const data_t *x, index_t n_points);
+data_t max_abs(const data_t *x, index_t n_points);
+data_t sum(const data_t *x, index_t n_points);
 void data_window_get(Point (*p)[], index_t n_points, data_t center, data_t window, Point (*segment)[]);
-void deriv(index_t size, data_t * in, data_t * out);
-void deriv_points(index_t size, Points * in, data_t * out);
-index_t findpeak(index_t size, data_t * input);
-data_t findpeaks(data_t * input, Peaks * p, Signal_Parameters * conf);
+void deriv(index_t size, const data_t * in, data_t * out);
+void deriv_points(index_t size, const Points * in, data_t * out);
+void deriv_view(View out, View in);
+index_t findpeak(index_t size, const data_t * input);
+
+/* Maximal half width of findpeak_refine() */
+#define PEAK_REFINE_HALF_MAX 64
+
+/**
+    @brief Sub-sample position of peak
+    @param y Signal
+    @param n_points Number of points in signal
+    @param position Peak position (point)
+    @param half Half width of the fitted part (points, up to PEAK_REFINE_HALF_MAX)
+    @return Vertex of the least-squares parabola around position (position itself if the fit fails)
+**/
+data_t findpeak_refine(const data_t * y, index_t n_points, index_t position, index_t half);
+data_t findpeaks(const data_t * input, Peaks * p, const Signal_Parameters * conf);
 
 #endif
@@ -0,0 +1,51 @@
+#ifndef ENSEN_SIGNAL_GRID_H
+#define ENSEN_SIGNAL_GRID_H
+
+#ifndef ENSEN_PRIVATE_H
+    #include "ensen_private.h"
+#endif
+
+/**
+    @brief Setup uniform grid
+    @param grid Grid descriptor
+    @param start Value of the first point
+    @param end Upper limit of the range (as in data_convert_to_lambda())
+    @param count Number of points
+**/
+void grid_uniform_set(Grid *grid, data_t start, data_t end, index_t count);
+
+/**
+    @brief Setup calibrated (non-uniform) grid
+    @param grid Grid descriptor
+    @param values Ascending point values (not copied, must outlive the grid)
+    @param count Number of points
+**/
+void grid_calibrated_set(Grid *grid, const data_t *values, index_t count);
+
+/**
+    @brief Index of the grid point nearest to the value
+    @param grid Grid descriptor
+    @param val Value to look for
+    @return Index of the nearest point (the upper one on a tie), clamped to the grid
+
+    O(1) for uniform grid, O(log n) binary search for calibrated grid.
+**/
+index_t grid_val2ind(const Grid *grid, data_t val);
+
+/**
+    @brief Value of the grid at (fractional) index
+    @param grid Grid descriptor
+    @param index Index of point, fractional part is interpolated linearly
+    @return Grid value (the first or the last one outside of a calibrated
+            grid, 0 if the grid is empty)
+**/
+data_t grid_ind2val(const Grid *grid, data_t index);
+
+/**
+    @brief Fill array with grid values
+    @param grid Grid descriptor
+    @param x Output array of grid->count values
+**/
+void grid_fill(const Grid *grid, data_t *x);
+
+#endif
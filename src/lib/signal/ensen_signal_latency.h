@@ -0,0 +1,115 @@
+#ifndef ENSEN_SIGNAL_LATENCY_H
+#define ENSEN_SIGNAL_LATENCY_H
+
+#ifndef ENSEN_PRIVATE_H
+    #include "ensen_private.h"
+#endif
+
+/*
+ * Latency histogram of fixed size (HDR style): values are nanoseconds,
+ * every power of two is split into LATENCY_SUB_COUNT linear buckets, so
+ * a value is kept with relative error below 1/LATENCY_SUB_COUNT (3%) from
+ * 1 ns up to 2^LATENCY_MAX_BITS ns (18 min); larger values are counted in
+ * the last bucket. Recording is a bit scan and an increment, without
+ * allocation, sorting or locking: a histogram has one writer.
+ */
+
+#define LATENCY_SUB_BITS  5
+#define LATENCY_SUB_COUNT (1 << LATENCY_SUB_BITS)
+#define LATENCY_MAX_BITS  40
+#define LATENCY_BUCKETS   ((LATENCY_MAX_BITS - LATENCY_SUB_BITS + 1) * LATENCY_SUB_COUNT)
+
+typedef struct _latency_histogram Latency_Histogram;
+struct _latency_histogram
+{
+    uint64_t count;                     /* recorded values */
+    uint64_t sum;                       /* nsec */
+    uint64_t min;                       /* nsec (UINT64_MAX - empty) */
+    uint64_t max;                       /* nsec, exact */
+    uint32_t bucket[LATENCY_BUCKETS];   /* counts (see latency_bucket()) */
+};
+
+/**
+    @brief Bucket of value
+    @param nsec Value
+    @return Index of the bucket: values below 2 * LATENCY_SUB_COUNT are
+            exact, the others lose the bits below the LATENCY_SUB_BITS + 1
+            highest ones
+**/
+static inline index_t
+latency_bucket(uint64_t nsec)
+{
+    if (nsec >= ((uint64_t)1 << LATENCY_MAX_BITS)) nsec = ((uint64_t)1 << LATENCY_MAX_BITS) - 1;
+    const index_t msb = 63 - __builtin_clzll(nsec | 1);
+    const index_t shift = (msb > LATENCY_SUB_BITS) ? msb - LATENCY_SUB_BITS : 0;
+    return shift * LATENCY_SUB_COUNT + (index_t)(nsec >> shift);
+}
+
+/**
+    @brief Record value
+    @param h Histogram
+    @param nsec Latency (nsec)
+**/
+static inline void
+latency_record(Latency_Histogram *h, uint64_t nsec)
+{
+    h->bucket[latency_bucket(nsec)]++;
+    h->count++;
+    h->sum += nsec;
+    if (nsec < h->min) h->min = nsec;
+    if (nsec > h->max) h->max = nsec;
+}
+
+/**
+    @brief Record time interval
+    @param h Histogram
+    @param sec Latency (sec, as differences of get_run_time(); negative is 0)
+**/
+static inline void
+latency_record_sec(Latency_Histogram *h, double sec)
+{
+    latency_record(h, (sec > 0) ? (uint64_t)(sec * 1e9 + 0.5) : 0);
+}
+
+/**
+    @brief Empty histogram
+    @param h Histogram
+**/
+void latency_reset(Latency_Histogram *h);
+
+/**
+    @brief Add the values of one histogram to another
+    @param dst Histogram
+    @param src Histogram (not modified)
+**/
+void latency_merge(Latency_Histogram *dst, const Latency_Histogram *src);
+
+/**
+    @brief Highest value of bucket
+    @param bucket Index of bucket
+    @return nsec
+**/
+uint64_t latency_bucket_value(index_t bucket);
+
+/**
+    @brief Percentile
+    @param h Histogram
+    @param p Percentile (0 .. 100)
+    @return Highest value of the bucket of the nearest-rank value (nsec), not
+            above the maximum; 0 for empty histogram
+**/
+uint64_t latency_percentile(const Latency_Histogram *h, double p);
+
+/**
+    @brief Print percentiles of histograms
+    @param f Stream
+    @param name Names of histograms
+    @param h Histograms (empty ones are skipped)
+    @param n Number of histograms
+    @param json JSON object of histograms by name, text table otherwise
+
+    Count, mean, p50, p90, p99, p99.9 and max are printed in microseconds.
+**/
+void latency_print(FILE *f, const char *const name[], const Latency_Histogram h[], index_t n, bool json);
+
+#endif
@@ -0,0 +1,91 @@
+#ifndef ENSEN_SIGNAL_POLYFIT_H
+#define ENSEN_SIGNAL_POLYFIT_H
+
+#ifndef ENSEN_PRIVATE_H
+    #include "ensen_private.h"
+#endif
+
+/* Maximal polynomial order supported by the fitting workspace */
+#define POLYFIT_ORDER_MAX 8
+
+typedef struct _polyfit_workspace Polyfit_Workspace;
+struct _polyfit_workspace
+{
+    index_t order;                                               /* order of the last successful fit */
+    data_t  x_center;                                            /* abscissa offset: u = (x - x_center) * x_scale */
+    data_t  x_scale;                                             /* abscissa scale (maps the fitted range to [-1, 1]) */
+    data_t  moment[2 * POLYFIT_ORDER_MAX + 1];                   /* power sums: sum(u^k) */
+    data_t  rhs[POLYFIT_ORDER_MAX + 1];                          /* weighted sums: sum(u^k * y) */
+    data_t  chol[POLYFIT_ORDER_MAX + 1][POLYFIT_ORDER_MAX + 1];  /* Cholesky factor of the normal matrix */
+    data_t  coeff[POLYFIT_ORDER_MAX + 1];                        /* coefficients in the scaled variable u */
+};
+
+/**
+    @brief Least-squares polynomial fit
+    @param ws Workspace (reusable, no memory is allocated)
+    @param x Abscissa values
+    @param y Ordinate values
+    @param n_points Number of points to fit
+    @param order Polynomial order (up to POLYFIT_ORDER_MAX)
+    @return 0 on success, -1 if the system is degenerate or the order is not supported
+
+    The abscissa is centred and scaled to [-1, 1] before the power sums are
+    accumulated, so the normal matrix stays well conditioned. The normal
+    equations are solved by Cholesky decomposition. The result is kept in
+    the workspace and evaluated with polyfit_eval().
+
+    @code
+    Polyfit_Workspace ws;
+    if (polyfit(&ws, data.x + n1, data.y + n1, n2 - n1, 2) == 0)
+    {
+        data_t top = polyfit_vertex(&ws);
+    }
+    @endcode
+**/
+int polyfit(Polyfit_Workspace *ws, const data_t *x, const data_t *y, index_t n_points, index_t order);
+
+/**
+    @brief Least-squares polynomial fit of the array of points (x and y)
+    @param ws Workspace (reusable, no memory is allocated)
+    @param p Pointer to the array of points
+    @param n_points Number of points to fit
+    @param order Polynomial order (up to POLYFIT_ORDER_MAX)
+    @return 0 on success, -1 on failure (see polyfit())
+**/
+int polyfit_points(Polyfit_Workspace *ws, Point (*p)[], index_t n_points, index_t order);
+
+/**
+    @brief Least-squares polynomial fit of Points view
+    @param ws Workspace (reusable, no memory is allocated)
+    @param pv Points view (any strides, no data is copied)
+    @param order Polynomial order (up to POLYFIT_ORDER_MAX)
+    @return 0 on success, -1 on failure (see polyfit())
+**/
+int polyfit_view(Polyfit_Workspace *ws, Points_View pv, index_t order);
+
+/**
+    @brief Evaluate fitted polynomial
+    @param ws Workspace with the result of polyfit()
+    @param x Abscissa value
+    @return Value of polynomial in x
+**/
+data_t polyfit_eval(const Polyfit_Workspace *ws, data_t x);
+
+/**
+    @brief Position of extremum of the fitted parabola
+    @param ws Workspace with the result of polyfit() of order 2
+    @return Abscissa of vertex (x_center if parabola is degenerate)
+**/
+data_t polyfit_vertex(const Polyfit_Workspace *ws);
+
+/**
+    @brief Coefficients of fitted polynomial in the original abscissa
+    @param ws Workspace with the result of polyfit()
+    @param c Output array of order + 1 coefficients (c[0] + c[1]*x + ...)
+
+    Note: the power basis of the raw abscissa is badly conditioned for
+    large x (e.g. wavelength in nm). Use polyfit_eval() when possible.
+**/
+void polyfit_coefficients(const Polyfit_Workspace *ws, data_t *c);
+
+#endif
@@ -0,0 +1,78 @@
+#ifndef ENSEN_SIGNAL_RING_H
+#define ENSEN_SIGNAL_RING_H
+
+#ifndef ENSEN_PRIVATE_H
+    #include "ensen_private.h"
+#endif
+
+/*
+ * Time series of fixed capacity: the oldest value is overwritten, so
+ * memory does not grow with the number of frames.
+ */
+typedef struct _ring Ring;
+struct _ring
+{
+    data_t   * data;
+    index_t    capacity;
+    index_t    head;     /* position of the next value */
+    uint64_t   count;    /* number of values pushed since ring_init() */
+};
+
+/**
+    @brief Allocate ring buffer
+    @param r Ring buffer
+    @param capacity Number of kept values
+    @return 0 on success, -1 if capacity is zero
+**/
+int ring_init(Ring *r, index_t capacity);
+
+/**
+    @brief Free ring buffer
+    @param r Ring buffer
+**/
+void ring_free(Ring *r);
+
+/**
+    @brief Append value (the oldest one is overwritten when ring is full)
+    @param r Ring buffer
+    @param value Value
+**/
+static inline void
+ring_push(Ring *r, data_t value)
+{
+    (*r).data[(*r).head] = value;
+    (*r).head = ((*r).head + 1 == (*r).capacity) ? 0 : (*r).head + 1;
+    (*r).count++;
+}
+
+/**
+    @brief Number of kept values
+    @param r Ring buffer
+    @return min(count, capacity)
+**/
+static inline index_t
+ring_length(const Ring *r)
+{
+    return ((*r).count < (*r).capacity) ? (index_t)(*r).count : (*r).capacity;
+}
+
+/**
+    @brief The last pushed value
+    @param r Ring buffer (not empty)
+    @return Value
+**/
+static inline data_t
+ring_last(const Ring *r)
+{
+    return (*r).data[((*r).head == 0) ? (*r).capacity - 1 : (*r).head - 1];
+}
+
+/**
+    @brief Copy kept values in order of arrival
+    @param r Ring buffer
+    @param out Output array (capacity elements)
+    @return Number of copied values (ring_length())
+**/
+index_t ring_copy(const Ring *r, data_t *out);
+
+#endif
@@ -0,0 +1,118 @@
+#ifndef ENSEN_SIGNAL_SENSOR_H
+#define ENSEN_SIGNAL_SENSOR_H
+
+#ifndef ENSEN_PRIVATE_H
+    #include "ensen_private.h"
+#endif
+
+#include "ensen_signal_ring.h"
+#include "ensen_signal_calib.h"
+
+/*
+ * State of all sensors (gratings) of a fiber as a structure of arrays.
+ * Every array is a part of one allocation, so a step over all sensors
+ * is a plain loop over contiguous arrays. Temperature history is a ring
+ * buffer per sensor (all of them share head and count) and deviation
+ * statistics are updated online: memory and cost of a frame do not
+ * depend on the number of frames.
+ */
+typedef struct _sensor_bank Sensor_Bank;
+struct _sensor_bank
+{
+    index_t   n_sensors;
+    index_t   capacity;    /* temperature samples kept per sensor */
+    index_t   head;        /* position of the next sample in history */
+    uint64_t  count;       /* number of samples recorded */
+    bool      started;     /* reference positions are set */
+    const Calibration *calibration; /* temperature of shift from origin (NULL - linear, see sensor_bank_update()) */
+
+    data_t  * position;    /* peak position in the last frame (x units) */
+    data_t  * reference;   /* peak position in the previous frame (x units) */
+    data_t  * origin;      /* peak position in the first frame (x units) */
+    data_t  * shift;       /* position - origin (x units) */
+    data_t  * temperature; /* current temperature */
+    data_t  * history;     /* ring buffers of temperature, n_sensors x capacity (sensor-major) */
+
+    /* deviation from the reference temperature (Welford) */
+    uint64_t  dev_count;
+    data_t  * dev_mean;
+    data_t  * dev_m2;      /* sum of squared differences from the mean */
+    data_t  * dev_min;
+    data_t  * dev_max;
+    data_t  * dev_abs_min;
+};
+
+/**
+    @brief Allocate sensor bank
+    @param bank Sensor bank
+    @param n_sensors Number of sensors
+    @param capacity Number of frames kept in history
+    @param temperature Initial temperature of all sensors (the first sample of history)
+    @return 0 on success, -1 if there are no sensors or no history
+**/
+int sensor_bank_init(Sensor_Bank *bank, index_t n_sensors, index_t capacity, data_t temperature);
+
+/**
+    @brief Free sensor bank
+    @param bank Sensor bank
+**/
+void sensor_bank_free(Sensor_Bank *bank);
+
+/**
+    @brief Ring buffer of temperature history of one sensor
+    @param bank Sensor bank
+    @param sensor Sensor number (< n_sensors)
+    @return Ring (shares memory with bank, do not free)
+**/
+static inline Ring
+sensor_bank_history(const Sensor_Bank *bank, index_t sensor)
+{
+    Ring r = { (*bank).history + (size_t)sensor * (*bank).capacity, (*bank).capacity, (*bank).head, (*bank).count };
+    return r;
+}
+
+/**
+    @brief Update positions and temperatures of all sensors
+    @param bank Sensor bank
+    @param p Peaks found in frame (peak k belongs to sensor k)
+    @param grid Grid of frame (converts peak position to x units)
+    @param coefficient Shift of peak per degree (x units)
+
+    The first call only sets the reference positions. A sensor without
+    peak in frame keeps its position, so its temperature does not change.
+    Without calibration the shift from the previous frame over coefficient
+    is added to temperature; with calibration temperature is that of the
+    shift from the first frame, for all sensors at once (coefficient is
+    not used).
+**/
+void sensor_bank_update(Sensor_Bank *bank, const Peaks *p, const Grid *grid, data_t coefficient);
+
+/**
+    @brief Set calibration of sensors
+    @param bank Sensor bank
+    @param c Calibration of bank->n_sensors sensors, kept until
+             sensor_bank_free() (not freed), NULL - linear coefficient
+    @return 0 on success, -1 if the number of sensors differs
+**/
+int sensor_bank_calibrate(Sensor_Bank *bank, const Calibration *c);
+
+/**
+    @brief Accumulate deviation of every sensor from reference temperature
+    @param bank Sensor bank
+    @param temperature Reference temperature of the frame
+**/
+void sensor_bank_deviation(Sensor_Bank *bank, data_t temperature);
+
+/**
+    @brief Variance of deviation of sensor
+    @param bank Sensor bank
+    @param sensor Sensor number
+    @return Population variance (0 before the first deviation)
+**/
+static inline data_t
+sensor_bank_deviation_variance(const Sensor_Bank *bank, index_t sensor)
+{
+    return ((*bank).dev_count > 0) ? (*bank).dev_m2[sensor] / (*bank).dev_count : 0;
+}
+
+#endif
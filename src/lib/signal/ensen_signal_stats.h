@@ -0,0 +1,65 @@
+#ifndef ENSEN_SIGNAL_STATS_H
+#define ENSEN_SIGNAL_STATS_H
+
+#ifndef ENSEN_PRIVATE_H
+    #include "ensen_private.h"
+#endif
+
+typedef struct _stats Stats;
+struct _stats
+{
+    data_t  min;      /* minimal value */
+    data_t  max;      /* maximal value */
+    index_t argmin;   /* index of the (first) minimal value */
+    index_t argmax;   /* index of the (first) maximal value */
+    data_t  abs_min;  /* minimal absolute value */
+    data_t  abs_max;  /* maximal absolute value */
+    data_t  sum;      /* sum of values */
+    data_t  mean;     /* mean value */
+    data_t  variance; /* population variance */
+};
+
+/**
+    @brief Statistics of array in one pass
+    @param x Array (not modified)
+    @param n_points Number of points in array (array size)
+    @param stats Output statistics (all fields are zero for empty array)
+
+    Minimum, maximum (with their indices), absolute minimum and maximum,
+    sum, mean and variance are reduced together, two values per SSE2
+    register when available. Variance is accumulated around x[0] to avoid
+    cancellation on signals with large offset.
+**/
+void stats_reduce(const data_t *x, index_t n_points, Stats *stats);
+
+/**
+    @brief Statistics of view in one pass (see stats_reduce())
+    @param view View (any stride, SSE2 is used for contiguous views)
+    @param stats Output statistics (indices are relative to the view)
+**/
+void stats_reduce_view(View view, Stats *stats);
+
+/* Differences of blocks of the peak-free part below which stats_noise() uses the whole signal */
+#define STATS_NOISE_POINTS_MIN 16
+
+/**
+    @brief Standard deviation of white noise of signal at scale
+    @param y Signal (not modified)
+    @param n_points Number of points in signal
+    @param block Scale (points): differences of means of blocks of block
+                 points are taken, 1 - of the points
+    @param threshold Blocks of mean at or above threshold are peaks and are skipped
+    @param scratch Array of n_points / block (overwritten)
+    @return Noise estimate: median absolute difference of the peak-free
+            block means (1.4826 * sqrt(block / 2) of it), 0 for less than 2 blocks
+
+    The difference removes the slow baseline, the median ignores the flanks
+    of peaks below threshold; the estimate is O(n) (selection). For white
+    noise the estimate does not depend on block; noise with more power at
+    high frequencies (violet) is lower at large blocks, noise with more
+    power at low frequencies (brown) is higher: the estimate is the white
+    noise which a filter of width block passes as much as the noise of y.
+**/
+data_t stats_noise(const data_t *y, index_t n_points, index_t block, data_t threshold, data_t *scratch);
+
+#endif
@@ -0,0 +1,62 @@
+#ifndef ENSEN_SIGNAL_STREAM_H
+#define ENSEN_SIGNAL_STREAM_H
+
+#ifndef ENSEN_PRIVATE_H
+    #include "ensen_private.h"
+#endif
+
+typedef struct _peak_stream Peak_Stream;
+
+/**
+    @brief Create online peak detector
+    @param conf Signal parameters (n_points, smooth and search setup are used)
+    @return Peak detector (free with peak_stream_free())
+
+    Online version of the smooth() x level -> findpeaks() chain: a frame is
+    pushed in chunks of any size, the smoothing and derivative state is
+    carried across chunk boundaries and every peak is reported as soon as
+    its neighbourhood is complete (see peak_stream_latency()). Positions
+    are indices of the raw frame, the same as reported by findpeaks().
+
+    @code
+    Peak_Stream *ps = peak_stream_new(&conf);
+    peaks.total_number = 0;
+    while (dma_chunk_ready(&chunk, &n))
+    {
+        if (peak_stream_push(ps, chunk, n, &peaks)) report(&peaks);
+    }
+    peak_stream_reset(ps); // next frame
+    @endcode
+**/
+Peak_Stream *peak_stream_new(const Signal_Parameters *conf);
+
+/**
+    @brief Free online peak detector
+    @param ps Peak detector
+**/
+void peak_stream_free(Peak_Stream *ps);
+
+/**
+    @brief Start new frame (the smoothing and detector state is cleared)
+    @param ps Peak detector
+**/
+void peak_stream_reset(Peak_Stream *ps);
+
+/**
+    @brief Push chunk of samples of the current frame
+    @param ps Peak detector
+    @param chunk Samples (continuation of the previously pushed ones)
+    @param n Number of samples in chunk
+    @param p Found peaks are appended to p->peak (up to search.peaks_array_number)
+    @return Number of peaks found in this chunk
+**/
+index_t peak_stream_push(Peak_Stream *ps, const data_t *chunk, index_t n, Peaks *p);
+
+/**
+    @brief Delay between a sample and the moment a peak at it can be reported
+    @param ps Peak detector
+    @return Delay in samples (smoothing delay plus derivative window)
+**/
+index_t peak_stream_latency(const Peak_Stream *ps);
+
+#endif
@@ -0,0 +1,79 @@
+#ifndef ENSEN_SIGNAL_TRACKER_H
+#define ENSEN_SIGNAL_TRACKER_H
+
+#ifndef ENSEN_PRIVATE_H
+    #include "ensen_private.h"
+#endif
+
+/* Number of rejected measurements in a row after which the track is restarted */
+#define TRACKER_MISSES_MAX 2
+
+/*
+ * Constant-velocity Kalman filter of one peak position (points), one
+ * step per frame. The state is kept by value: no memory is allocated.
+ */
+typedef struct _tracker Tracker;
+struct _tracker
+{
+    data_t  position;          /* estimated position */
+    data_t  velocity;          /* estimated drift per frame */
+    data_t  p[2][2];           /* covariance of (position, velocity) */
+    data_t  process_noise;     /* variance of drift change per frame */
+    data_t  measurement_noise; /* variance of measured position */
+    data_t  gate;              /* accepted innovation (in sigmas) */
+    index_t misses;            /* rejected measurements in a row */
+    bool    started;           /* the first measurement is received */
+};
+
+/**
+    @brief Initialize tracker
+    @param t Tracker
+    @param process_noise Variance of drift change per frame (points^2)
+    @param measurement_noise Variance of measured position (points^2)
+    @param gate Measurements farther than gate sigmas from prediction are rejected
+**/
+void tracker_init(Tracker *t, data_t process_noise, data_t measurement_noise, data_t gate);
+
+/**
+    @brief Predict position for the next frame (call once per frame before tracker_update())
+    @param t Tracker
+**/
+void tracker_predict(Tracker *t);
+
+/**
+    @brief Predicted search window
+    @param t Tracker (after tracker_predict())
+    @param from First position of window
+    @param to Last position of window (the whole axis before the first measurement)
+**/
+void tracker_window(const Tracker *t, data_t *from, data_t *to);
+
+/**
+    @brief Fuse measured position with prediction
+    @param t Tracker (after tracker_predict())
+    @param measurement Measured position (sub-sample)
+    @return 0 if measurement is accepted, -1 if it is rejected as outlier
+
+    After TRACKER_MISSES_MAX rejections in a row the peak is assumed to
+    have jumped and the track is restarted from the next measurement.
+**/
+int tracker_update(Tracker *t, data_t measurement);
+
+/**
+    @brief Track peaks of the frame by array of trackers (one per sensor)
+    @param t Trackers
+    @param n_trackers Number of trackers (not more than size of p->peak array)
+    @param p Found peaks, replaced by the estimated positions of sensors 0 .. n_trackers - 1
+    @param y Signal the peaks were found in (for refinement)
+    @param n_points Number of points in signal
+    @param refine Half width of sub-sample refinement by findpeak_refine() (0 - off)
+
+    Every tracker takes the found peak nearest to its prediction inside
+    its search window (see tracker_window()), so spurious and missing
+    peaks do not shift sensors. A sensor without a peak in the window
+    keeps the predicted position, unless the frame has exactly one peak
+    per sensor: then the peaks have jumped and the track is restarted.
+**/
+void tracker_peaks(Tracker *t, index_t n_trackers, Peaks *p, const data_t *y, index_t n_points, index_t refine);
+
+#endif
@@ -0,0 +1,109 @@
+#ifndef ENSEN_SIGNAL_VIEW_H
+#define ENSEN_SIGNAL_VIEW_H
+
+#ifndef ENSEN_PRIVATE_H
+    #include "ensen_private.h"
+#endif
+
+/**
+    @brief Address of view element
+    @param v View
+    @param i Element index (< v.length)
+    @return Pointer to element of the underlying array
+**/
+static inline data_t *
+view_ptr(View v, index_t i)
+{
+    return v.data + v.offset + (size_t)i * v.stride;
+}
+
+/**
+    @brief View of the whole contiguous array
+    @param data Array
+    @param length Number of elements
+    @return View (stride 1)
+**/
+static inline View
+view_array(data_t *data, index_t length)
+{
+    View v = { data, 0, length, 1 };
+    return v;
+}
+
+/**
+    @brief Part of view (no data is copied)
+    @param v View
+    @param from First element of the part
+    @param length Number of elements (clipped by the end of v)
+    @return View of elements from .. from + length - 1
+**/
+static inline View
+view_slice(View v, index_t from, index_t length)
+{
+    if (from > v.length) from = v.length;
+    if (length > v.length - from) length = v.length - from;
+    v.offset += (uint32_t)from * v.stride;
+    v.length = length;
+    return v;
+}
+
+/**
+    @brief View of the first n_points of Points (x and y arrays)
+    @param p Points
+    @param n_points Number of points
+    @return Points view (stride 1)
+**/
+static inline Points_View
+points_view(const Points *p, index_t n_points)
+{
+    Points_View pv = { view_array((*p).x, n_points), view_array((*p).y, n_points) };
+    return pv;
+}
+
+/**
+    @brief Adaptor of the array of points (AoS) to Points view
+    @param p Pointer to the array of points
+    @param n_points Number of points
+    @return Points view (Point is a pair of data_t: stride 2)
+**/
+static inline Points_View
+points_view_aos(Point (*p)[], index_t n_points)
+{
+    const index_t stride = sizeof(Point) / sizeof(data_t);
+    Points_View pv = { { &(*p)[0].x, 0, n_points, stride }, { &(*p)[0].y, 0, n_points, stride } };
+    return pv;
+}
+
+/**
+    @brief Part of Points view (no data is copied)
+    @param pv Points view
+    @param from First point of the part
+    @param length Number of points (clipped by the end of pv)
+    @return Points view of points from .. from + length - 1
+**/
+static inline Points_View
+points_view_slice(Points_View pv, index_t from, index_t length)
+{
+    pv.x = view_slice(pv.x, from, length);
+    pv.y = view_slice(pv.y, from, length);
+    return pv;
+}
+
+/**
+    @brief Index of the view element nearest to val
+    @param x View of ascending values
+    @param val Value to look for
+    @return Index of the nearest element (binary search, upper one on tie)
+**/
+index_t view_val2ind(View x, data_t val);
+
+/**
+    @brief Isolate segment (window) of points for curve fitting
+    @param pv Points view (ascending x)
+    @param center Center of the window (x units)
+    @param window Width of the window (x units), 0 - the whole range of x
+    @return Points view of the points inside the window (no data is copied)
+**/
+Points_View points_view_window(Points_View pv, data_t center, data_t window);
+
+#endif
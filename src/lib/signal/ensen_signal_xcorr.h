@@ -0,0 +1,60 @@
+#ifndef ENSEN_SIGNAL_XCORR_H
+#define ENSEN_SIGNAL_XCORR_H
+
+#ifndef ENSEN_PRIVATE_H
+    #include "ensen_private.h"
+#endif
+
+typedef struct _xcorr_tracker Xcorr_Tracker;
+
+/**
+    @brief Create cross-correlation shift tracker
+    @param window Reference window around every peak (points)
+    @param range Maximal shift of a peak between two frames (points), less than
+                 the distance to the neighbour peak minus the shift
+    @param n_sensors Number of tracked peaks
+    @return Tracker with cached FFT plans (free with xcorr_tracker_free()), NULL if window is too short
+
+    Every frame the window of the current frame (extended by range on both
+    sides) is correlated with the stored reference window of every sensor.
+    The correlation is normalized by the local energy of the frame, so it
+    does not depend on amplitude and baseline changes, and its maximum is
+    refined by parabolic interpolation. No smoothing or derivative is used.
+**/
+Xcorr_Tracker *xcorr_tracker_new(index_t window, index_t range, index_t n_sensors);
+
+/**
+    @brief Free cross-correlation shift tracker
+    @param tr Tracker
+**/
+void xcorr_tracker_free(Xcorr_Tracker *tr);
+
+/**
+    @brief Store reference windows
+    @param tr Tracker
+    @param y Reference frame (not smoothed)
+    @param n_points Number of points in frame
+    @param p Peaks found in the reference frame (the first n_sensors are tracked)
+    @return 0 on success, -1 if there are less peaks than sensors
+**/
+int xcorr_tracker_start(Xcorr_Tracker *tr, const data_t *y, index_t n_points, const Peaks *p);
+
+/**
+    @brief Track peaks in the next frame
+    @param tr Tracker (started)
+    @param y Frame (not smoothed)
+    @param n_points Number of points in frame
+    @param p Peak positions (n_sensors, sub-sample precision), a lost peak keeps its previous position
+    @return Time of execution (in sec.)
+**/
+data_t xcorr_track(Xcorr_Tracker *tr, const data_t *y, index_t n_points, Peaks *p);
+
+/**
+    @brief Displacement of the peak from its reference position
+    @param tr Tracker
+    @param sensor Sensor number
+    @return Displacement (points), multiply by grid step to get wavelength shift
+**/
+data_t xcorr_shift(const Xcorr_Tracker *tr, index_t sensor);
+
+#endif
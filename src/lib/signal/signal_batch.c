@@ -0,0 +1,59 @@
+#include <string.h>
+
+#include "ensen_private.h"
+#include "ensen_benchmark.h"
+#include "ensen_signal_batch.h"
+#include "ensen_signal_fit.h"
+#include "ensen_signal_view.h"
+
+typedef struct _batch_run Batch_Run;
+struct _batch_run
+{
+    const Peak_Batch * batch;
+    data_t           * scratch;  /* n_points_max per worker (of batch) */
+    index_t            n_points_max;
+};
+
+static void
+_batch_frame(void *data, uint32_t f, index_t worker)
+{
+    const Batch_Run *run = data;
+    const Signal_Parameters *conf = run->batch->conf[f];
+    const index_t n = (*conf).n_points;
+
+    /* passes alternate between frame and scratch: no copy per pass */
+    data_t *frame = run->batch->frame[f];
+    data_t *scratch = run->scratch + (size_t)worker * run->n_points_max;
+    const data_t *source = (run->batch->source != NULL) ? run->batch->source[f] : frame;
+    const index_t level = (*conf).smooth.level;
+
+    /* read only source: the first pass writes frame or scratch, so the last one writes frame */
+    View a = view_array((data_t *)source, n);
+    View b = view_array(((source != frame) && (level % 2 == 1)) ? frame : scratch, n);
+    for (index_t l = 0; l < level; l++)
+    {
+        smooth_view(b, a, (*conf).smooth.width);
+        a = b;
+        b = view_array((b.data == frame) ? scratch : frame, n);
+    }
+    if (a.data != frame) memcpy(frame, a.data, sizeof(data_t) * n);
+
+    findpeaks(run->batch->frame[f], &run->batch->peaks[f], conf);
+}
+
+data_t
+findpeaks_batch(Thread_Pool *pool, const Peak_Batch *batch)
+{
+    double start_time = get_run_time();
+    Batch_Run run = { batch, batch->scratch, 0 };
+
+    for (uint32_t f = 0; f < batch->n_frames; f++)
+    {
+        if ((*batch->conf[f]).n_points > run.n_points_max) run.n_points_max = (*batch->conf[f]).n_points;
+    }
+    if (run.n_points_max == 0) return get_run_time() - start_time;
+
+    thread_pool_run(pool, batch->n_frames, _batch_frame, &run);
+
+    return get_run_time() - start_time;
+}
@@ -0,0 +1,169 @@
+#include <string.h>
+
+#ifdef __SSE2__
+  #include <emmintrin.h>
+#endif
+
+#include "ensen_private.h"
+#include "ensen_signal_calib.h"
+#include "mem/ensen_mem_guarded.h"
+
+Calibration *
+calibration_new(index_t n_sensors, data_t temperature, data_t coefficient)
+{
+    if ((n_sensors == 0) || !((coefficient < 0) || (coefficient > 0))) return NULL;
+
+    Calibration *c = MEM_callocN(sizeof(Calibration), "calibration_new: c");
+    c->n_sensors        = n_sensors;
+    c->order            = 1;
+    c->coefficient      = MEM_calloc_arrayN((size_t)(CALIB_ORDER_MAX + 1) * n_sensors, sizeof(data_t), "calibration_new: coefficient");
+    c->n_tables         = 0;
+    c->table            = MEM_malloc_arrayN(n_sensors, sizeof(index_t), "calibration_new: table");
+    c->n_knots          = MEM_calloc_arrayN(n_sensors, sizeof(index_t), "calibration_new: n_knots");
+    c->knot_shift       = MEM_calloc_arrayN(n_sensors, sizeof(data_t *), "calibration_new: knot_shift");
+    c->knot_temperature = MEM_calloc_arrayN(n_sensors, sizeof(data_t *), "calibration_new: knot_temperature");
+
+    for (index_t s = 0; s < n_sensors; s++)
+    {
+        c->coefficient[s] = temperature;
+        c->coefficient[n_sensors + s] = 1.0 / coefficient;
+    }
+    return c;
+}
+
+static void
+_calibration_table_free(Calibration *c, index_t sensor)
+{
+    if (c->n_knots[sensor] == 0) return;
+
+    MEM_freeN(c->knot_shift[sensor]);
+    MEM_freeN(c->knot_temperature[sensor]);
+    c->knot_shift[sensor] = c->knot_temperature[sensor] = NULL;
+    c->n_knots[sensor] = 0;
+
+    index_t k = 0;
+    for (index_t i = 0; i < c->n_tables; i++)
+    {
+        if (c->table[i] != sensor) c->table[k++] = c->table[i];
+    }
+    c->n_tables = k;
+}
+
+void
+calibration_free(Calibration *c)
+{
+    if (c == NULL) return;
+
+    for (index_t s = 0; s < c->n_sensors; s++) _calibration_table_free(c, s);
+    MEM_freeN(c->coefficient);
+    MEM_freeN(c->table);
+    MEM_freeN(c->n_knots);
+    MEM_freeN(c->knot_shift);
+    MEM_freeN(c->knot_temperature);
+    MEM_freeN(c);
+}
+
+/* Highest power with a coefficient of any sensor (Horner runs to it for all sensors) */
+static void
+_calibration_order(Calibration *c)
+{
+    const index_t n = c->n_sensors;
+    c->order = 0;
+    for (index_t k = CALIB_ORDER_MAX; (k > 0) && (c->order == 0); k--)
+    {
+        for (index_t s = 0; s < n; s++)
+        {
+            const data_t a = c->coefficient[(size_t)k * n + s];
+            if ((a < 0) || (a > 0))
+            {
+                c->order = k;
+                break;
+            }
+        }
+    }
+}
+
+int
+calibration_set_polynomial(Calibration *c, index_t sensor, const data_t *coefficient, index_t n)
+{
+    if ((sensor >= c->n_sensors) || (n == 0) || (n > CALIB_ORDER_MAX + 1)) return -1;
+
+    _calibration_table_free(c, sensor);
+    for (index_t k = 0; k <= CALIB_ORDER_MAX; k++)
+    {
+        c->coefficient[(size_t)k * c->n_sensors + sensor] = (k < n) ? coefficient[k] : 0;
+    }
+    _calibration_order(c);
+    return 0;
+}
+
+int
+calibration_set_table(Calibration *c, index_t sensor, const data_t *shift, const data_t *temperature, index_t n)
+{
+    if ((sensor >= c->n_sensors) || (n < 2)) return -1;
+    for (index_t i = 1; i < n; i++)
+    {
+        if (!(shift[i] > shift[i - 1])) return -1;
+    }
+
+    _calibration_table_free(c, sensor);
+    c->knot_shift[sensor] = MEM_malloc_arrayN(n, sizeof(data_t), "calibration_set_table: knot_shift");
+    c->knot_temperature[sensor] = MEM_malloc_arrayN(n, sizeof(data_t), "calibration_set_table: knot_temperature");
+    memcpy(c->knot_shift[sensor], shift, sizeof(data_t) * n);
+    memcpy(c->knot_temperature[sensor], temperature, sizeof(data_t) * n);
+    c->n_knots[sensor] = n;
+    c->table[c->n_tables++] = sensor;
+
+    /* the polynomial of a table sensor is 0 */
+    for (index_t k = 0; k <= CALIB_ORDER_MAX; k++) c->coefficient[(size_t)k * c->n_sensors + sensor] = 0;
+    _calibration_order(c);
+    return 0;
+}
+
+void
+calibration_eval(const Calibration *c, const data_t *shift, data_t *temperature)
+{
+    const index_t n = c->n_sensors;
+    const data_t *a = c->coefficient;
+    const index_t order = c->order;
+    index_t s = 0;
+
+    /* Horner by powers, two sensors per step */
+#ifdef __SSE2__
+    for (; s + 2 <= n; s += 2)
+    {
+        const __m128d x = _mm_loadu_pd(shift + s);
+        __m128d t = _mm_loadu_pd(a + (size_t)order * n + s);
+        for (index_t k = order; k-- > 0;)
+        {
+            t = _mm_add_pd(_mm_mul_pd(t, x), _mm_loadu_pd(a + (size_t)k * n + s));
+        }
+        _mm_storeu_pd(temperature + s, t);
+    }
+#endif
+    for (; s < n; s++)
+    {
+        const data_t x = shift[s];
+        data_t t = a[(size_t)order * n + s];
+        for (index_t k = order; k-- > 0;) t = t * x + a[(size_t)k * n + s];
+        temperature[s] = t;
+    }
+
+    /* tables: segment of shift (the end segments are extended) */
+    for (index_t i = 0; i < c->n_tables; i++)
+    {
+        const index_t sensor = c->table[i];
+        const data_t *xk = c->knot_shift[sensor];
+        const data_t *tk = c->knot_temperature[sensor];
+        const data_t x = shift[sensor];
+
+        index_t lo = 0, hi = c->n_knots[sensor] - 1;
+        while (hi - lo > 1)
+        {
+            const index_t mid = (lo + hi) / 2;
+            if (x < xk[mid]) hi = mid;
+            else lo = mid;
+        }
+        temperature[sensor] = tk[lo] + (x - xk[lo]) * (tk[hi] - tk[lo]) / (xk[hi] - xk[lo]);
+    }
+}
@@ -0,0 +1,357 @@
+#include <math.h>
+#include <string.h>
+#include <complex.h>
+#include <fftw3.h>
+
+#include "ensen_private.h"
+#include "ensen_signal_cwt.h"
+#include "ensen_benchmark.h"
+#include "signal_intern.h"
+#include "mem/ensen_mem_guarded.h"
+
+#define RIDGE_NONE UINT16_MAX
+
+typedef struct _ridge Ridge;
+struct _ridge
+{
+    index_t position;      /* position at the last linked scale */
+    index_t best_position; /* position at the scale with the best coefficient */
+    index_t best_scale;
+    index_t length;        /* number of linked scales */
+    index_t gap;           /* number of scales passed without a maximum */
+    bool    open;
+    bool    extended;      /* linked at the current scale */
+    data_t  best;          /* best coefficient */
+};
+
+struct _cwt_plan
+{
+    index_t        n_points;
+    index_t        n_scales;
+    index_t        pad;          /* constant extension of the frame on both sides */
+    int            n_fft;
+    data_t         scale[CWT_SCALES_MAX]; /* ascending */
+
+    fftw_plan      forward;
+    fftw_plan      backward;
+    double       * in;           /* padded frame / inverse transform output */
+    fftw_complex * spectrum;     /* spectrum of the padded frame */
+    fftw_complex * product;      /* spectrum multiplied by the wavelet (destroyed by c2r) */
+    double       * wavelet;      /* real spectra of the wavelets (n_scales x n_fft/2 + 1), 1/n_fft included */
+
+    data_t       * coef;         /* transform (n_scales x n_points) */
+    data_t       * scratch;      /* n_points: noise estimation */
+    index_t      * owner;        /* n_points: ridge ending at position, RIDGE_NONE if none */
+    Ridge        * ridge;
+    index_t        ridges_max;
+};
+
+/* Sampled Mexican hat (1/s normalization) placed around zero of the circular buffer */
+static void
+_cwt_wavelet(double *buf, int n_fft, data_t s)
+{
+    const int half = (int)ceil(5 * s);
+    data_t sum = 0;
+
+    memset(buf, 0, sizeof(double) * n_fft);
+    for (int t = -half; t <= half; t++)
+    {
+        const data_t u = (data_t)t / s;
+        const data_t v = (1 - u * u) * exp(-u * u / 2) / s;
+        buf[(t + n_fft) % n_fft] = v;
+        sum += v;
+    }
+
+    /* zero response to the constant baseline */
+    for (int t = -half; t <= half; t++)
+    {
+        buf[(t + n_fft) % n_fft] -= sum / (2 * half + 1);
+    }
+}
+
+Cwt_Plan *
+cwt_plan_new(index_t n_points, const data_t *scales, index_t n_scales)
+{
+    if ((n_points < 4) || (n_scales == 0) || (n_scales > CWT_SCALES_MAX)) return NULL;
+
+    Cwt_Plan *plan = MEM_callocN(sizeof(Cwt_Plan), "cwt_plan_new: plan");
+
+    /* Sort scales (ascending) */
+    for (index_t s = 0; s < n_scales; s++)
+    {
+        index_t j = s;
+        while ((j > 0) && (plan->scale[j - 1] > scales[s]))
+        {
+            plan->scale[j] = plan->scale[j - 1];
+            j--;
+        }
+        plan->scale[j] = scales[s];
+    }
+    if (!(plan->scale[0] >= 1))
+    {
+        MEM_freeN(plan);
+        return NULL;
+    }
+
+    plan->n_points = n_points;
+    plan->n_scales = n_scales;
+    plan->pad      = (index_t)ceil(5 * plan->scale[n_scales - 1]);
+    plan->n_fft    = 1;
+    while (plan->n_fft < n_points + 2 * plan->pad) plan->n_fft <<= 1;
+
+    const int n_freq = plan->n_fft/2 + 1;
+
+    /* FFT buffers are aligned by fftw (SIMD codelets) */
+    plan->in       = fftw_malloc(sizeof(double) * plan->n_fft);
+    plan->spectrum = fftw_malloc(sizeof(fftw_complex) * n_freq);
+    plan->product  = fftw_malloc(sizeof(fftw_complex) * n_freq);
+
+    /* Planning overwrites the buffers: done once, before the wavelets are computed */
+    plan->forward  = fftw_plan_dft_r2c_1d(plan->n_fft, plan->in, plan->spectrum, FFTW_MEASURE);
+    plan->backward = fftw_plan_dft_c2r_1d(plan->n_fft, plan->product, plan->in, FFTW_MEASURE);
+
+    plan->wavelet = MEM_malloc_arrayN((size_t)n_scales * n_freq, sizeof(double), "cwt_plan_new: wavelet");
+    for (index_t s = 0; s < n_scales; s++)
+    {
+        _cwt_wavelet(plan->in, plan->n_fft, plan->scale[s]);
+        fftw_execute(plan->forward);
+
+        /* the wavelet is symmetric: its spectrum is real */
+        for (int k = 0; k < n_freq; k++)
+        {
+            plan->wavelet[(size_t)s * n_freq + k] = creal(plan->spectrum[k]) / plan->n_fft;
+        }
+    }
+
+    plan->coef       = MEM_malloc_arrayN((size_t)n_scales * n_points, sizeof(data_t), "cwt_plan_new: coef");
+    plan->scratch    = MEM_malloc_arrayN(n_points, sizeof(data_t), "cwt_plan_new: scratch");
+    plan->owner      = MEM_malloc_arrayN(n_points, sizeof(index_t), "cwt_plan_new: owner");
+    plan->ridges_max = n_points/4 + 16;
+    plan->ridge      = MEM_malloc_arrayN(plan->ridges_max, sizeof(Ridge), "cwt_plan_new: ridge");
+
+    return plan;
+}
+
+void
+cwt_plan_free(Cwt_Plan *plan)
+{
+    if (plan == NULL) return;
+
+    fftw_destroy_plan(plan->forward);
+    fftw_destroy_plan(plan->backward);
+    fftw_free(plan->in);
+    fftw_free(plan->spectrum);
+    fftw_free(plan->product);
+
+    MEM_freeN(plan->wavelet);
+    MEM_freeN(plan->coef);
+    MEM_freeN(plan->scratch);
+    MEM_freeN(plan->owner);
+    MEM_freeN(plan->ridge);
+    MEM_freeN(plan);
+}
+
+/* Transform of the frame at every scale */
+static void
+_cwt_transform(Cwt_Plan *plan, const data_t *y)
+{
+    const index_t n = plan->n_points;
+    const int n_freq = plan->n_fft/2 + 1;
+    int i;
+
+    /* constant extension: no step at the frame edges */
+    for (i = 0; i < plan->pad; i++) plan->in[i] = y[0];
+    memcpy(plan->in + plan->pad, y, sizeof(double) * n);
+    for (i = plan->pad + n; i < plan->n_fft; i++) plan->in[i] = y[n - 1];
+
+    fftw_execute(plan->forward);
+
+    for (index_t s = 0; s < plan->n_scales; s++)
+    {
+        const double *w = plan->wavelet + (size_t)s * n_freq;
+        for (int k = 0; k < n_freq; k++) plan->product[k] = plan->spectrum[k] * w[k];
+
+        fftw_execute(plan->backward);
+        memcpy(plan->coef + (size_t)s * n, plan->in + plan->pad, sizeof(double) * n);
+    }
+}
+
+/* k-th smallest value (the array is reordered) */
+static data_t
+_cwt_select(data_t *a, index_t n, index_t k)
+{
+    index_t lo = 0, hi = n - 1;
+    while (lo < hi)
+    {
+        const data_t pivot = a[lo + (hi - lo)/2];
+        index_t i = lo, j = hi;
+        while (i <= j)
+        {
+            while (a[i] < pivot) i++;
+            while (a[j] > pivot) j--;
+            if (i <= j)
+            {
+                data_t t = a[i]; a[i] = a[j]; a[j] = t;
+                i++;
+                if (j == 0) break;
+                j--;
+            }
+        }
+        if (k <= j) hi = j;
+        else if (k >= i) lo = i;
+        else break;
+    }
+    return a[k];
+}
+
+/* Noise level: median absolute coefficient at the smallest scale (Gaussian sigma estimate) */
+static data_t
+_cwt_noise(Cwt_Plan *plan)
+{
+    for (index_t i = 0; i < plan->n_points; i++) plan->scratch[i] = fabs(plan->coef[i]);
+    const data_t noise = _cwt_select(plan->scratch, plan->n_points, plan->n_points/2) / 0.6745;
+    return (noise > 0) ? noise : 1e-300;
+}
+
+/* Link local maxima into ridge lines, from the largest scale down */
+static index_t
+_cwt_ridges(Cwt_Plan *plan)
+{
+    const index_t n = plan->n_points;
+    index_t n_ridges = 0;
+
+    for (index_t i = 0; i < n; i++) plan->owner[i] = RIDGE_NONE;
+
+    for (int s = plan->n_scales - 1; s >= 0; s--)
+    {
+        const data_t *c = plan->coef + (size_t)s * n;
+        const index_t tol = (index_t)ceil(plan->scale[s] / 2);
+        const index_t n_open = n_ridges;
+
+        for (index_t r = 0; r < n_open; r++) plan->ridge[r].extended = false;
+
+        for (index_t i = 1; i < n - 1; i++)
+        {
+            if (!((c[i] > c[i - 1]) && (c[i] >= c[i + 1]) && (c[i] > 0))) continue;
+
+            /* nearest ridge ending around i, which is not linked yet */
+            index_t from = (i > tol) ? i - tol : 0;
+            index_t to   = (n - 1 - i > tol) ? i + tol : n - 1;
+            index_t best = RIDGE_NONE, dist = UINT16_MAX;
+            for (index_t j = from; j <= to; j++)
+            {
+                const index_t r = plan->owner[j];
+                if ((r == RIDGE_NONE) || plan->ridge[r].extended) continue;
+                const index_t d = (j > i) ? j - i : i - j;
+                if (d < dist) { dist = d; best = r; }
+            }
+
+            Ridge *rd;
+            if (best != RIDGE_NONE)
+            {
+                rd = &plan->ridge[best];
+                rd->length++;
+            }
+            else if (n_ridges < plan->ridges_max)
+            {
+                rd = &plan->ridge[n_ridges++];
+                rd->length = 1;
+                rd->best = 0;
+                rd->open = true;
+            }
+            else continue;
+
+            rd->position = i;
+            rd->gap = 0;
+            rd->extended = true;
+            if (c[i] > rd->best)
+            {
+                rd->best = c[i];
+                rd->best_position = i;
+                rd->best_scale = s;
+            }
+        }
+
+        /* Move ridge ends to the positions at this scale, close ridges with more than one gap */
+        for (index_t i = 0; i < n; i++) plan->owner[i] = RIDGE_NONE;
+        for (index_t r = 0; r < n_ridges; r++)
+        {
+            Ridge *rd = &plan->ridge[r];
+            if (!rd->open) continue;
+            if (!rd->extended && (r < n_open) && (++rd->gap > 1))
+            {
+                rd->open = false;
+                continue;
+            }
+            plan->owner[rd->position] = r;
+        }
+    }
+    return n_ridges;
+}
+
+data_t
+cwt_findpeaks(Cwt_Plan *plan, const data_t *y, Peaks *p, const Signal_Parameters *conf)
+{
+    double start_time = get_run_time();
+    const index_t n = plan->n_points;
+    const index_t min_length = (plan->n_scales + 1)/2;
+    index_t num_of_peaks = 0;
+
+    (*p).total_number = 0;
+
+    _cwt_transform(plan, y);
+    const data_t noise = _cwt_noise(plan);
+    const index_t n_ridges = _cwt_ridges(plan);
+
+    for (index_t r = 0; r < n_ridges; r++)
+    {
+        const Ridge *rd = &plan->ridge[r];
+        if ((rd->length < min_length) || (rd->best / noise < (*conf).search.cwt_snr)) continue;
+
+        /* amplitude: mean signal in the core of the peak */
+        const index_t half = (index_t)ceil(plan->scale[rd->best_scale] / 2);
+        const index_t from = (rd->best_position > half) ? rd->best_position - half : 0;
+        const index_t to   = (n - 1 - rd->best_position > half) ? rd->best_position + half : n - 1;
+        data_t amplitude = 0;
+        for (index_t i = from; i <= to; i++) amplitude += y[i];
+        amplitude /= (to - from + 1);
+        if (amplitude <= (*conf).search.threshold_amp) continue;
+
+        /* ascending positions, of two close peaks keep the stronger one */
+        const data_t position = rd->best_position;
+        index_t j = 0;
+        while ((j < num_of_peaks) && ((*p).peak[j].position < position)) j++;
+
+        bool duplicate = false;
+        for (index_t k = (j > 0) ? j - 1 : 0; (k <= j) && (k < num_of_peaks); k++)
+        {
+            if (fabs((*p).peak[k].position - position)/n >= PEAK_DUPLICATE_DISTANCE) continue;
+            duplicate = true;
+            if (plan->scratch[k] < rd->best)
+            {
+                (*p).peak[k].position  = position;
+                (*p).peak[k].amplitude = amplitude;
+                plan->scratch[k] = rd->best;
+            }
+            break;
+        }
+        if (duplicate) continue;
+
+        if (num_of_peaks >= (*conf).search.peaks_array_number) // out of peaks array size
+        {
+            printf("Warning: Found too many peaks. Out of array size. \n");
+            break;
+        }
+
+        /* strength of accepted peaks is kept in scratch (noise estimation is done) */
+        memmove(&(*p).peak[j + 1], &(*p).peak[j], sizeof(Peak) * (num_of_peaks - j));
+        memmove(&plan->scratch[j + 1], &plan->scratch[j], sizeof(data_t) * (num_of_peaks - j));
+        (*p).peak[j].position  = position;
+        (*p).peak[j].amplitude = amplitude;
+        plan->scratch[j] = rd->best;
+        ++num_of_peaks;
+    }
+
+    (*p).total_number = num_of_peaks;
+    return get_run_time() - start_time;
+}
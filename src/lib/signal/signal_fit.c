@@ -1,192 +1,236 @@
 #include <stdio.h>
 #include <math.h>
 
+#ifdef __SSE2__
+  #include <emmintrin.h>
+#endif
+
 #include "ensen_private.h"
 #include "ensen_benchmark.h"
 #include "ensen_signal_fit.h"
+#include "ensen_signal_polyfit.h"
+#include "ensen_signal_grid.h"
+#include "ensen_signal_view.h"
+#include "signal_intern.h"
 #include "mem/ensen_mem_guarded.h"
 
 /**
-    Function that performs Gauss-Elimination and returns the Upper triangular matrix and solution of equations:
-    There are two options to do this in C.
-    1. Pass the augmented matrix (a) as the parameter, and calculate and store the upperTriangular(Gauss-Eliminated Matrix) in it.
-    2. Use malloc and make the function of pointer type and return the pointer.
-    This program uses the first option.
+    @brief Polynomial fit (the points are replaced by the fitted curve)
+    @param p Points of data to fit
+    @param n_points Total number of points
+    @param n_poly Polynom order
+    @return 0 on success, -1 on failure (see polyfit())
 **/
-void 
-signal_fit_gaussEliminationLS(int m, int n, double a[m][n], double x[n-1])
+int
+signal_fit(Point (*p)[], index_t n_points, index_t n_poly)
 {
-    int i,j,k;
-    for(i=0;i<m-1;i++){
-        //Partial Pivoting
-        for(k=i+1;k<m;k++){
-            //If diagonal element(absolute vallue) is smaller than any of the terms below it
-            if(fabs(a[i][i])<fabs(a[k][i])){
-                //Swap the rows
-                for(j=0;j<n;j++){                
-                    double temp;
-                    temp=a[i][j];
-                    a[i][j]=a[k][j];
-                    a[k][j]=temp;
-                }
-            }
-        }
-        //Begin Gauss Elimination
-        for(k=i+1;k<m;k++){
-            double  term=a[k][i]/ a[i][i];
-            for(j=0;j<n;j++){
-                a[k][j]=a[k][j]-term*a[i][j];
-            }
-        }
-         
-    }
-    //Begin Back-substitution
-    for(i=m-1;i>=0;i--){
-        x[i]=a[i][n-1];
-        for(j=i+1;j<n-1;j++){
-            x[i]=x[i]-a[i][j]*x[j];
-        }
-        x[i]=x[i]/a[i][i];
-    }
-             
+  return signal_fit_view(points_view_aos(p, n_points), n_poly);
 }
 
-/**
-    Function that prints the elements of a matrix row-wise
-    Parameters: rows(m),columns(n),matrix[m][n] 
-**/
-void 
-signal_fit_printMatrix(int m, int n, double matrix[m][n])
+int
+signal_fit_view(Points_View pv, index_t n_poly)
 {
-    int i,j;
-    for(i=0;i<m;i++){
-        for(j=0;j<n;j++){
-            printf("%lf\t",matrix[i][j]);
-        }
-        printf("\n");
-    } 
+  Polyfit_Workspace ws;
+
+  if (polyfit_view(&ws, pv, n_poly) != 0) return -1;
+
+  for (index_t i = 0; i < pv.y.length; i++)
+  {
+    *view_ptr(pv.y, i) = polyfit_eval(&ws, *view_ptr(pv.x, i));
+  }
+  return 0;
 }
 
-/**
-    @brief Polynomial fit
-    @param p Points of data to fit
-    @param n_points Total number of points
-    @param n_poly Polynom order
-**/
 void
-signal_fit(Point (*p)[], index_t n_points, index_t n_poly)
+smooth(data_t *y, index_t n_points, index_t w)
 {
-  //arrays to store the c and y-axis data-points
-  index_t i,j; 
-  double x[n_points];
-  double y[n_points];
-  for (i = 0; i < n_points; i++)
-  {
-    x[i] = (*p)[i].x;
-    y[i] = (*p)[i].y;
-  }
-  // an array of size 2*n_poly+1 for storing n_points, Sig xi, Sig xi^2, ...., etc. which are the independent components of the normal matrix
-  double X[2*n_poly+1]; 
-  for(i=0;i<=2*n_poly;i++){
-      X[i]=0;
-      for(j=0;j<n_points;j++){
-          X[i]=X[i]+pow(x[j],i);
-      }
-  }
-  //the normal augmented matrix
-  double B[n_poly+1][n_poly+2];  
-  // rhs
-  double Y[n_poly+1];      
-  for(i=0;i<=n_poly;i++){
-      Y[i]=0;
-      for(j=0;j<n_points;j++){
-          Y[i]=Y[i]+pow(x[j],i)*y[j];
-      }
-  }
-  for(i=0;i<=n_poly;i++){
-      for(j=0;j<=n_poly;j++){
-          B[i][j]=X[i+j]; 
-      }
-  }
-  for(i=0;i<=n_poly;i++){
-      B[i][n_poly+1]=Y[i];
-  }
-  double A[n_poly+1];
-  printf("The polynomial fit is given by the equation:\n");
-  signal_fit_printMatrix(n_poly+1,n_poly+2,B);
-  signal_fit_gaussEliminationLS(n_poly+1,n_poly+2,B,A);
-  for(i = 0; i <= n_poly; i++){
-      printf("%lfx^%d+",A[i],i);
-  }
+    data_t *s = MEM_malloc_arrayN(n_points, sizeof(data_t), "signal_fit: smooth");
 
-  for (i = 0; i < n_points; i++)
-  {
-    (*p)[i].y = 0;
-    for(j = 0; i <= n_poly; i++)
+    smooth_view(view_array(s, n_points), view_array(y, n_points), w);
+    for (index_t i = 0; i < n_points; i++)
     {
-      (*p)[i].y += A[j]*pow(y[i], j);
+        y[i] = s[i];
     }
-  }
+    
+    MEM_freeN(s);
 }
 
 void
-smooth(data_t *y, index_t n_points, index_t w)
+smooth_view(View out, View in, index_t w)
 {
+    const index_t n_points = in.length;
+    index_t i, k;
+
+    if ((w < 2) || (w > n_points))
+    {
+        for (i = 0; i < n_points; i++) *view_ptr(out, i) = *view_ptr(in, i);
+        return;
+    }
+
     data_t SumPoints = 0.0;
-    for (index_t i = 0; i < w; i++)
+    for (i = 0; i < w; i++)
     {
         /* hack to avoid appearing of 'nan' in data */
-        if(y[i] >= 0 || y[i] < 0) SumPoints += y[i];
+        const data_t v = *view_ptr(in, i);
+        if(v >= 0 || v < 0) SumPoints += v;
     }
-    
-    data_t *s = MEM_malloc_arrayN(n_points, sizeof(data_t), "signal_fit: smooth");
-    for (index_t i = 0; i < n_points; i++)
+
+    for (i = 0; i < n_points; i++)
     {
-       s[i] = 0; // avoid garbage values
+       *view_ptr(out, i) = 0; // avoid garbage values
     }
 
-    index_t halfw = round(w/2);
-    for (index_t k = 0; k <= (n_points-w); k++)
+    index_t halfw = w/2;
+    for (k = 0; k <= (n_points-w); k++)
     {
-        s[k + halfw - 1] = SumPoints;
-        if(y[k] >= 0 || y[k] < 0) SumPoints -= y[k]; 
-        if(y[k + w] >= 0 || y[k + w] < 0) SumPoints += y[k + w];
+        *view_ptr(out, k + halfw - 1) = SumPoints / w;
+
+        const data_t first = *view_ptr(in, k);
+        if(first >= 0 || first < 0) SumPoints -= first;
+        if (k + w < n_points)
+        {
+            const data_t next = *view_ptr(in, k + w);
+            if(next >= 0 || next < 0) SumPoints += next;
+        }
     }
 
-    for (index_t n = n_points - w + 1; n <= n_points; n++)
+    /* the last (incomplete) window */
+    *view_ptr(out, n_points - w + halfw) = SumPoints / w;
+}
+
+data_t
+smooth_derivative_gain(index_t w, index_t level, data_t *variance)
+{
+    if (w < 2) level = 0;
+    *variance = level * ((data_t)w * w - 1) / 12;
+
+    /* kernel of level passes of the moving average, with a zero on both sides */
+    const size_t length = (size_t)level * (w - 1) + 1;
+    data_t *h = MEM_calloc_arrayN(length + 2, sizeof(data_t), "smooth_derivative_gain: h");
+    data_t *t = MEM_calloc_arrayN(length + 2, sizeof(data_t), "smooth_derivative_gain: t");
+    h[1] = 1;
+    for (index_t pass = 0; pass < level; pass++)
     {
-        if(y[n] >= 0 || y[n] < 0) s[n_points - w + halfw] += y[n];
+        const size_t n = (size_t)pass * (w - 1) + 1;
+        for (size_t k = 0; k < n + w - 1; k++) t[1 + k] = 0;
+        for (size_t k = 0; k < n; k++)
+        {
+            for (index_t j = 0; j < w; j++) t[1 + k + j] += h[1 + k] / w;
+        }
+        for (size_t k = 0; k < n + w - 1; k++) h[1 + k] = t[1 + k];
     }
 
-    for (index_t i = 0; i < n_points; i++)
+    /* deriv() is the central difference, one point beyond the kernel on both sides */
+    data_t gain = 0;
+    for (size_t k = 0; k < length + 2; k++)
     {
-        y[i] = s[i]/w;
+        const data_t d = (((k + 1 < length + 2) ? h[k + 1] : 0) - ((k > 0) ? h[k - 1] : 0)) / 2;
+        gain += d * d;
     }
-    
-    MEM_freeN(s);
+    MEM_freeN(h);
+    MEM_freeN(t);
+    return sqrt(gain);
 }
 
+/* value of sum of the window ('nan' is skipped as in smooth_view()) */
+static inline data_t
+_smooth_finite(data_t v)
+{
+    return (v >= 0 || v < 0) ? v : 0;
+}
 
-index_t
-val2ind(data_t *x, index_t n_points, data_t val)
+#ifdef __SSE2__
+/* _smooth_finite() of two values: 'nan' is not equal to itself, its mask clears it */
+static inline __m128d
+_smooth_finite_pd(__m128d v)
 {
-    data_t diff[n_points];
-    index_t i, index = 0;
-    
-    for (i = 0; i < n_points; i++)
+    return _mm_and_pd(v, _mm_cmpeq_pd(v, v));
+}
+#endif
+
+/* values of lanes enter the window */
+static inline void
+_smooth_lanes_add(data_t *restrict sum, const data_t *restrict v, index_t nl)
+{
+    index_t l = 0;
+#ifdef __SSE2__
+    for (; l + 2 <= nl; l += 2)
     {
-        diff[i] = x[i] - val;
-        if (diff[i] < 0) diff[i] = diff[i] * (-1);
+        _mm_storeu_pd(sum + l, _mm_add_pd(_mm_loadu_pd(sum + l), _smooth_finite_pd(_mm_loadu_pd(v + l))));
     }
-    
-    data_t min_val = min(diff, n_points);
-    
-    for (i = 0; i < n_points; i++)
+#endif
+    for (; l < nl; l++) sum[l] += _smooth_finite(v[l]);
+}
+
+/* mean of the window of lanes, then their first values leave the window */
+static inline void
+_smooth_lanes_step(data_t *restrict o, data_t *restrict sum, const data_t *restrict v, index_t nl, index_t w)
+{
+    index_t l = 0;
+#ifdef __SSE2__
+    const __m128d vw = _mm_set1_pd(w);
+    for (; l + 2 <= nl; l += 2)
     {
-        if (fabs(diff[i] - min_val) <= 1.0e-14) index = i; /* solved warning: comparing floating-point with ‘==’ or ‘!=’ is unsafe */
+        const __m128d s = _mm_loadu_pd(sum + l);
+        _mm_storeu_pd(o + l, _mm_div_pd(s, vw));
+        _mm_storeu_pd(sum + l, _mm_sub_pd(s, _smooth_finite_pd(_mm_loadu_pd(v + l))));
     }
-    
-    return index;
+#endif
+    for (; l < nl; l++)
+    {
+        o[l] = sum[l] / w;
+        sum[l] -= _smooth_finite(v[l]);
+    }
+}
+
+void
+smooth_lanes(data_t *restrict out, const data_t *restrict in, index_t n_points, index_t n_lanes, index_t w)
+{
+    const size_t m = n_lanes;
+    const size_t total = (size_t)n_points * m;
+    index_t i, k, l;
+
+    if ((w < 2) || (w > n_points))
+    {
+        for (size_t j = 0; j < total; j++) out[j] = in[j];
+        return;
+    }
+
+    for (size_t j = 0; j < total; j++) out[j] = 0;
+
+    /* the running sums of a group of lanes stay in L1, lanes of a point are contiguous (two per SSE2 step) */
+    const index_t halfw = w/2;
+    for (index_t first = 0; first < n_lanes; first += SMOOTH_LANES_GROUP)
+    {
+        const index_t nl = (n_lanes - first < SMOOTH_LANES_GROUP) ? n_lanes - first : SMOOTH_LANES_GROUP;
+        data_t sum[SMOOTH_LANES_GROUP];
+
+        for (l = 0; l < nl; l++) sum[l] = 0.0;
+        for (i = 0; i < w; i++) _smooth_lanes_add(sum, in + (size_t)i * m + first, nl);
+
+        for (k = 0; k <= (n_points - w); k++)
+        {
+            _smooth_lanes_step(out + (size_t)(k + halfw - 1) * m + first, sum, in + (size_t)k * m + first, nl, w);
+            if (k + w < n_points) _smooth_lanes_add(sum, in + (size_t)(k + w) * m + first, nl);
+        }
+
+        /* the last (incomplete) window */
+        data_t *o = out + (size_t)(n_points - w + halfw) * m + first;
+        for (l = 0; l < nl; l++) o[l] = sum[l] / w;
+    }
+}
+
+/// @brief Index of the array value nearest to val
+/// @param x Array of ascending values (grid)
+/// @param n_points Number of points in array (array size)
+/// @param val Value to look for
+/// @return Index of the nearest value (binary search, see grid_val2ind())
+index_t
+val2ind(const data_t *x, index_t n_points, data_t val)
+{
+    Grid grid;
+    grid_calibrated_set(&grid, x, n_points);
+    return grid_val2ind(&grid, val);
 }
 
 /// @brief Find minimal value in array
@@ -194,10 +238,10 @@ val2ind(data_t *x, index_t n_points, data_t val)
 /// @param n_points Number of points in array (array size)
 /// @return Minimal value in array
 data_t
-min(data_t *x, index_t n_points)
+min(const data_t *x, index_t n_points)
 {
     data_t min = x[0];
-    for (index_t i = 0; i < n_points; i++)
+    for (index_t i = 1; i < n_points; i++)
     {
         if (min > x[i]) min = x[i];
     }
@@ -205,18 +249,16 @@ min(data_t *x, index_t n_points)
 }
 
 /// @brief Find minimal value in array (unsigned or absolute)
-/// @param x Array
+/// @param x Array (not modified)
 /// @param n_points Number of points in array (array size)
 /// @return Minimal absulute value in array
 data_t
-min_abs(data_t *x, index_t n_points)
+min_abs(const data_t *x, index_t n_points)
 {
-    data_t min = x[1];
-    if (min < 0) { min = min * (-1); }    
+    data_t min = fabs(x[0]);
     for (index_t i = 1; i < n_points; i++)
     {
-        if (x[i] < 0) x[i] = x[i] * (-1);
-        if (min > x[i]) min = x[i];
+        if (min > fabs(x[i])) min = fabs(x[i]);
     }
     return min;
 }
@@ -226,10 +268,10 @@ min_abs(data_t *x, index_t n_points)
 /// @param n_points Number of points in array (array size)
 /// @return Maximum value in array
 data_t
-max(data_t *x, index_t n_points)
+max(const data_t *x, index_t n_points)
 {
     data_t max = x[0];
-    for (index_t i = 0; i < n_points; i++)
+    for (index_t i = 1; i < n_points; i++)
     {
         if (max < x[i]) max = x[i];
     }
@@ -237,17 +279,16 @@ max(data_t *x, index_t n_points)
 }
 
 /// @brief Find maximum value in array (unsigned or absolute)
-/// @param x Array
+/// @param x Array (not modified)
 /// @param n_points Number of points in array (array size)
 /// @return Maximum absolute value in array
 data_t
-max_abs(data_t *x, index_t n_points)
+max_abs(const data_t *x, index_t n_points)
 {
-    data_t max = x[0];
-    for (index_t i = 0; i < n_points; i++)
+    data_t max = fabs(x[0]);
+    for (index_t i = 1; i < n_points; i++)
     {
-        if (x[i] < 0) x[i] = x[i] * (-1);
-        if (max < x[i]) max = x[i];
+        if (max < fabs(x[i])) max = fabs(x[i]);
     }
     return max;
 }
@@ -257,9 +298,9 @@ max_abs(data_t *x, index_t n_points)
 /// @param n_points Number of points in array (array size)
 /// @return Find sum of all values in array
 data_t
-sum(data_t *x, index_t n_points)
+sum(const data_t *x, index_t n_points)
 {
-    data_t sum = x[0];
+    data_t sum = 0;
     for (index_t i = 0; i < n_points; i++)
     {
         sum += x[i];
@@ -267,140 +308,186 @@ sum(data_t *x, index_t n_points)
     return sum;
 }
 
-
 /**
     @brief Isolate desired dataset segment (window) for curvefiting
     @param p Pointer to the array of points (x and y)
     @param n_points Total number of points
-    @param smoothwidth Width of the smooth window (number of points)
+    @param center Center of the window (x units)
+    @param window_size Width of the window (x units), 0 - the whole range of x
+    @param segment Output array of points (copy of the window, see points_view_window() to avoid it)
 **/
 void
 data_window_get(Point (*p)[], index_t n_points, data_t center, data_t window_size, Point (*segment)[])
 {
-    data_t xoffset = 0.0;
-    index_t n1 = 0, n2 = 0, n = 0, i = 0;
-    data_t xx[n_points], yy[n_points];
-
-    for (n = 0; n < n_points; n++)
-    {
-        xx[n] = (*p)[n].x;
-        yy[n] = (*p)[n].y;
-    }
-    
-    if (fabs(center) <= 1.0e-14 || fabs(window_size) <= 1.0e-14) /* solved warning: comparing floating-point with ‘==’ or ‘!=’ is unsafe */
-    {
-        window_size = max(xx, n_points) - min(xx, n_points);
-        center = window_size/2;
-    }
+    Points_View pv = points_view_aos(p, n_points);
 
-    n1 = val2ind(xx, n_points, center - (window_size / 2));
-    n2 = val2ind(xx, n_points, center + (window_size / 2));
-
-    if (fabs(window_size) <= 1.0e-14) /* solved warning: comparing floating-point with ‘==’ or ‘!=’ is unsafe */
-    {
-        n1 = 1; n2 = n_points;
-    }
+    if (fabs(center) > 1.0e-14) pv = points_view_window(pv, center, window_size);
 
-    index_t s = n1;
-    for (i = 0; i < (n2 - n1); i++)
+    for (index_t i = 0; i < pv.x.length; i++)
     {
-        (*segment)[i].x = xx[s] - xoffset;
-        (*segment)[i].y = yy[s];
-        s = s + 1;
+        (*segment)[i].x = *view_ptr(pv.x, i);
+        (*segment)[i].y = *view_ptr(pv.y, i);
     }
 }
 
 /// @brief First derivative of vector using 2-point central difference.
+/// One-sided differences are used at the ends.
 /// @param size Size of input and output data array
 /// @param in Input data array
 /// @param out Output data array
 void
-deriv(index_t size, data_t * in, data_t * out)
+deriv(index_t size, const data_t * in, data_t * out)
 {
-    out[1] = in[2] - in[1];
-    out[size] = in[size] - in[size - 1];
-    
-    for (index_t i = 2; i < size - 1; i++)
+    deriv_view(view_array(out, size), view_array((data_t *)in, size));
+}
+
+void
+deriv_points(index_t size, const Points * in, data_t * out)
+{
+    deriv(size, (*in).y, out);
+}
+
+void
+deriv_view(View out, View in)
+{
+    const index_t size = in.length;
+    if (size < 2) return;
+
+    *view_ptr(out, 0) = *view_ptr(in, 1) - *view_ptr(in, 0);
+    *view_ptr(out, size - 1) = *view_ptr(in, size - 1) - *view_ptr(in, size - 2);
+
+    for (index_t i = 1; i < size - 1; i++)
     {
-        out[i] = (in[i + 1] - in[i - 1])/2;
+        *view_ptr(out, i) = (*view_ptr(in, i + 1) - *view_ptr(in, i - 1))/2;
     }
 }
 
-void
-deriv_points(index_t size, Points * in, data_t * out)
+/*
+ * Candidate test of the derivative zero-crossing for the block of
+ * positions [base, base + len), len <= 64. The central difference is
+ * computed on the fly from the window y[i - 1] .. y[i + 2]; bit k of
+ * the result is set if the position base + k passes _peak_candidate().
+ */
+static uint64_t
+_peaks_candidates(const data_t * y, index_t base, index_t len, data_t amp_min, data_t slope_min, data_t d_max)
 {
-    out[1] = (*in).y[2] - (*in).y[1];
-    out[size] = (*in).y[size] - (*in).y[size - 1];
-    
-    for (index_t i = 2; i < size - 1; i++)
+    uint64_t mask = 0;
+    index_t k = 0;
+
+#ifdef __SSE2__
+    const __m128d zero  = _mm_setzero_pd();
+    const __m128d half  = _mm_set1_pd(0.5);
+    const __m128d vamp  = _mm_set1_pd(amp_min);
+    const __m128d vslp  = _mm_set1_pd(slope_min);
+    const __m128d vdmax = _mm_set1_pd(d_max);
+
+    for (; k + 2 <= len; k += 2)
+    {
+        const data_t * w = y + base + k;
+        __m128d ym = _mm_loadu_pd(w - 1);
+        __m128d y0 = _mm_loadu_pd(w);
+        __m128d yp = _mm_loadu_pd(w + 1);
+        __m128d yq = _mm_loadu_pd(w + 2);
+        __m128d d0 = _mm_mul_pd(_mm_sub_pd(yp, ym), half);
+        __m128d d1 = _mm_mul_pd(_mm_sub_pd(yq, y0), half);
+
+        __m128d c = _mm_and_pd(_mm_cmpge_pd(d0, zero), _mm_cmplt_pd(d1, zero));
+        c = _mm_and_pd(c, _mm_cmple_pd(d0, vdmax));
+        c = _mm_and_pd(c, _mm_cmpgt_pd(y0, vamp));
+        c = _mm_and_pd(c, _mm_cmpgt_pd(_mm_sub_pd(d0, d1), vslp));
+
+        mask |= (uint64_t)_mm_movemask_pd(c) << k;
+    }
+#endif
+
+    for (; k < len; k++)
     {
-        out[i] = ((*in).y[i + 1] - (*in).y[i - 1])/2;
+        const index_t i = base + k;
+        const uint64_t c = _peak_candidate(y[i - 1], y[i], y[i + 1], y[i + 2], amp_min, slope_min, d_max);
+        mask |= c << k;
     }
+
+    return mask;
 }
 
 index_t
-findpeak(index_t size, data_t * input)
+findpeak(index_t size, const data_t * input)
 {
-    data_t d[size];
-    deriv(size, input, d);
     index_t peak_pos = 0;
 
-    for (index_t i = 0; i < size-1; i++)
+    if (size < 4) return 0;
+
+    /* the last zero-crossing of derivative */
+    for (index_t base = 1; base < size - 2; base += 64)
     {
-        if ((d[i] >= 0) & (d[i + 1] < 0)) // Detects zero-crossing of derivative
-        {
-            peak_pos = i + 1;
-        }
+        index_t len = (size - 2 - base < 64) ? size - 2 - base : 64;
+        uint64_t mask = _peaks_candidates(input, base, len, -HUGE_VAL, -HUGE_VAL, HUGE_VAL);
+        if (mask) peak_pos = base + (63 - __builtin_clzll(mask)) + 1;
     }
     return peak_pos;
 }
 
 data_t
-findpeaks(data_t * y, Peaks * p, Signal_Parameters * conf)
+findpeak_refine(const data_t * y, index_t n_points, index_t position, index_t half)
 {
-    double start_time = get_run_time();
-    data_t dy[(*conf).n_points];
+    data_t x[2 * PEAK_REFINE_HALF_MAX + 1];
+    Polyfit_Workspace ws;
 
-    deriv((*conf).n_points, y, dy);
-    
+    if (half > PEAK_REFINE_HALF_MAX) half = PEAK_REFINE_HALF_MAX;
+    if ((half < 1) || (position < half) || (position + half >= n_points)) return position;
+
+    for (index_t k = 0; k <= 2 * half; k++) x[k] = (data_t)k - half;
+    if (polyfit(&ws, x, y + position - half, 2 * half + 1, 2) != 0) return position;
+
+    const data_t vertex = polyfit_vertex(&ws);
+    return (fabs(vertex) <= half) ? position + vertex : position;
+}
+
+data_t
+findpeaks(const data_t * y, Peaks * p, const Signal_Parameters * conf)
+{
+    Profile_Mark mark;
+    profile_begin(&mark);
+    const index_t n_points = (*conf).n_points;
     index_t num_of_peaks = 0;
-    data_t diff = 0.f;
+
     (*p).total_number = 0;
-    for (index_t i = 0; i < ((*conf).n_points - 1); i++)
+    if (n_points < 4) return profile_end(&mark, "findpeaks");
+
+    /* Derivative is never stored: the candidates are tested in blocks of 64 points */
+    for (index_t base = 1; base < n_points - 2; base += 64)
     {
-        if ((dy[i] >= 0) & (dy[i + 1] < 0) & (dy[i] <= 1)) // Detects zero-crossing of derivative
+        index_t len = (n_points - 2 - base < 64) ? n_points - 2 - base : 64;
+        uint64_t mask = _peaks_candidates(y, base, len,
+                                          (*conf).search.threshold_amp,
+                                          (*conf).search.threshold_slope,
+                                          1);
+        while (mask)
         {
-            if (y[i] > (*conf).search.threshold_amp) // Try to find peak above certain value of amplitude
+            index_t i = base + __builtin_ctzll(mask);
+            mask &= mask - 1;
+
+            /*
+             * avoid peak duplication
+             * if we find peak close to the existing one -
+             * save only the previous
+            */
+            if ((num_of_peaks != 0) && ((data_t)(i - (*p).peak[num_of_peaks - 1].position)/n_points < PEAK_DUPLICATE_DISTANCE))
             {
-                if ((dy[i] - dy[i + 1]) > (*conf).search.threshold_slope) // Try to find real peak (not fluctuations)
-                {
-                    if (num_of_peaks >= (*conf).search.peaks_array_number) // out of peaks array size
-                    {
-                        printf("Warning: Found too many peaks. Out of array size. \n");
-                        double end_time = get_run_time();
-                        return end_time - start_time;
-                    }
-                    
-                    (*p).peak[num_of_peaks].position = i;
-                    ++num_of_peaks;
-                    (*p).total_number = num_of_peaks;
-                    
-                    /* 
-                     * avoid peak duplication
-                     * if we find peak close to the existing one - 
-                     * save only the previous (set number of peaks minus 1) 
-                    */
-                    if (num_of_peaks != 1) diff = (data_t)((*p).peak[num_of_peaks-1].position-(*p).peak[num_of_peaks-2].position)/(*conf).n_points;
-                    if ((num_of_peaks != 1) & (diff < 0.05)) // diff threshold
-                    {
-                        (*p).peak[num_of_peaks-1].position = (*p).peak[num_of_peaks-2].position;
-                        num_of_peaks = num_of_peaks - 1;
-                        (*p).total_number = num_of_peaks;
-                    }
-                }
+                continue;
             }
+
+            if (num_of_peaks >= (*conf).search.peaks_array_number) // out of peaks array size
+            {
+                printf("Warning: Found too many peaks. Out of array size. \n");
+                return profile_end(&mark, "findpeaks");
+            }
+
+            (*p).peak[num_of_peaks].position = i;
+            ++num_of_peaks;
+            (*p).total_number = num_of_peaks;
         }
     }
-    double end_time = get_run_time();
-    return end_time - start_time;
+
+    return profile_end(&mark, "findpeaks");
 }
@@ -9,7 +9,8 @@ signal_generate(Points *points,
                 index_t n_points)
 {
     index_t i = 0;
-    double start_time = get_run_time();
+    Profile_Mark mark;
+    profile_begin(&mark);
 
     for (i = 0; i < n_points; i++)
     {
@@ -29,7 +30,6 @@ signal_generate(Points *points,
         }
     }
 
-    double end_time = get_run_time();
-    return end_time - start_time;
+    return profile_end(&mark, "signal_generate");
 }
 
@@ -0,0 +1,72 @@
+#include <math.h>
+
+#include "ensen_private.h"
+#include "ensen_signal_grid.h"
+
+void
+grid_uniform_set(Grid *grid, data_t start, data_t end, index_t count)
+{
+    grid->start  = start;
+    grid->step   = (count > 0) ? (end - start) / count : 0;
+    grid->count  = count;
+    grid->values = NULL;
+}
+
+void
+grid_calibrated_set(Grid *grid, const data_t *values, index_t count)
+{
+    grid->start  = (count > 0) ? values[0] : 0;
+    grid->step   = (count > 1) ? (values[count - 1] - values[0]) / (count - 1) : 0;
+    grid->count  = count;
+    grid->values = values;
+}
+
+index_t
+grid_val2ind(const Grid *grid, data_t val)
+{
+    if (grid->count == 0) return 0;
+
+    if (grid->values == NULL)
+    {
+        if (!(grid->step > 0)) return 0;
+        data_t pos = floor((val - grid->start) / grid->step + 0.5);
+        if (pos < 0) return 0;
+        if (pos > grid->count - 1) return grid->count - 1;
+        return (index_t)pos;
+    }
+
+    /* Binary search of the first value which is not less than val */
+    index_t lo = 0, hi = grid->count;
+    while (lo < hi)
+    {
+        index_t mid = lo + (hi - lo) / 2;
+        if (grid->values[mid] < val) lo = mid + 1;
+        else hi = mid;
+    }
+
+    if (lo == 0) return 0;
+    if (lo == grid->count) return grid->count - 1;
+    return (val - grid->values[lo - 1] < grid->values[lo] - val) ? lo - 1 : lo;
+}
+
+data_t
+grid_ind2val(const Grid *grid, data_t index)
+{
+    if ((grid->values == NULL) || (grid->count == 0)) return grid->start + index * grid->step;
+
+    if (!(index > 0)) return grid->values[0];
+    if (!(index < grid->count - 1)) return grid->values[grid->count - 1];
+
+    index_t i = (index_t)index;
+    data_t frac = index - i;
+    return grid->values[i] + frac * (grid->values[i + 1] - grid->values[i]);
+}
+
+void
+grid_fill(const Grid *grid, data_t *x)
+{
+    for (index_t i = 0; i < grid->count; i++)
+    {
+        x[i] = grid_ind2val(grid, i);
+    }
+}
@@ -0,0 +1,27 @@
+/** \file
+ * \brief Internal helpers shared by the peak search implementations.
+ */
+
+#ifndef __SIGNAL_INTERN_H__
+#define __SIGNAL_INTERN_H__
+
+#include "ensen_private.h"
+
+/*
+ * Zero-crossing test of the central difference at position i, given the
+ * window ym = y[i - 1], y0 = y[i], yp = y[i + 1], yq = y[i + 2]:
+ *   d(i) >= 0, d(i + 1) < 0, d(i) <= d_max,
+ *   y[i] > amp_min and d(i) - d(i + 1) > slope_min
+ */
+static inline bool
+_peak_candidate(data_t ym, data_t y0, data_t yp, data_t yq, data_t amp_min, data_t slope_min, data_t d_max)
+{
+    const data_t d0 = (yp - ym)/2;
+    const data_t d1 = (yq - y0)/2;
+    return (d0 >= 0) & (d1 < 0) & (d0 <= d_max) & (y0 > amp_min) & ((d0 - d1) > slope_min);
+}
+
+/* Minimal relative distance (fraction of frame) between two found peaks */
+#define PEAK_DUPLICATE_DISTANCE 0.05
+
+#endif /* __SIGNAL_INTERN_H__ */
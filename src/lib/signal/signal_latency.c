@@ -0,0 +1,94 @@
+#include <math.h>
+#include <string.h>
+
+#include "signal/ensen_signal_latency.h"
+
+/* Percentiles printed by latency_print() */
+static const double latency_print_p[] = { 50, 90, 99, 99.9 };
+static const char  *latency_print_key[] = { "p50", "p90", "p99", "p99.9" };
+#define LATENCY_PRINT_P (sizeof(latency_print_p) / sizeof(latency_print_p[0]))
+
+void
+latency_reset(Latency_Histogram *h)
+{
+    memset(h, 0, sizeof(Latency_Histogram));
+    h->min = UINT64_MAX;
+}
+
+void
+latency_merge(Latency_Histogram *dst, const Latency_Histogram *src)
+{
+    for (index_t i = 0; i < LATENCY_BUCKETS; i++) dst->bucket[i] += src->bucket[i];
+    dst->count += src->count;
+    dst->sum   += src->sum;
+    if (src->min < dst->min) dst->min = src->min;
+    if (src->max > dst->max) dst->max = src->max;
+}
+
+uint64_t
+latency_bucket_value(index_t bucket)
+{
+    if (bucket < 2 * LATENCY_SUB_COUNT) return bucket;
+
+    const index_t shift = bucket / LATENCY_SUB_COUNT - 1;
+    const uint64_t sub = bucket - shift * LATENCY_SUB_COUNT;
+    return ((sub + 1) << shift) - 1;
+}
+
+uint64_t
+latency_percentile(const Latency_Histogram *h, double p)
+{
+    if (h->count == 0) return 0;
+
+    uint64_t rank = (uint64_t)ceil(p / 100.0 * h->count);
+    if (rank == 0) rank = 1;
+
+    uint64_t seen = 0;
+    for (index_t i = 0; i < LATENCY_BUCKETS; i++)
+    {
+        seen += h->bucket[i];
+        if (seen >= rank)
+        {
+            const uint64_t value = latency_bucket_value(i);
+            return (value < h->max) ? value : h->max;
+        }
+    }
+    return h->max;
+}
+
+void
+latency_print(FILE *f, const char *const name[], const Latency_Histogram h[], index_t n, bool json)
+{
+    bool first = true;
+
+    if (json) fprintf(f, "{");
+    else fprintf(f, "%-12s %10s %10s %10s %10s %10s %10s %10s\n", "stage, us", "count", "mean", "p50", "p90", "p99", "p99.9", "max");
+
+    for (index_t s = 0; s < n; s++)
+    {
+        if (h[s].count == 0) continue;
+
+        const double mean = 1e-3 * h[s].sum / h[s].count;
+        if (json)
+        {
+            fprintf(f, "%s\n  \"%s\": { \"count\": %llu, \"mean\": %.3f", first ? "" : ",", name[s], (unsigned long long)h[s].count, mean);
+            for (index_t k = 0; k < LATENCY_PRINT_P; k++)
+            {
+                fprintf(f, ", \"%s\": %.3f", latency_print_key[k], 1e-3 * latency_percentile(&h[s], latency_print_p[k]));
+            }
+            fprintf(f, ", \"max\": %.3f }", 1e-3 * h[s].max);
+        }
+        else
+        {
+            fprintf(f, "%-12s %10llu %10.2f", name[s], (unsigned long long)h[s].count, mean);
+            for (index_t k = 0; k < LATENCY_PRINT_P; k++)
+            {
+                fprintf(f, " %10.2f", 1e-3 * latency_percentile(&h[s], latency_print_p[k]));
+            }
+            fprintf(f, " %10.2f\n", 1e-3 * h[s].max);
+        }
+        first = false;
+    }
+
+    if (json) fprintf(f, "%s}\n", first ? "" : "\n");
+}
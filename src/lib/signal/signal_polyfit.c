@@ -0,0 +1,141 @@
+#include <math.h>
+
+#include "ensen_private.h"
+#include "ensen_signal_polyfit.h"
+#include "ensen_signal_view.h"
+
+/* Fit in the scaled abscissa u = (x - x_center) * x_scale */
+int
+polyfit_view(Polyfit_Workspace *ws, Points_View pv, index_t order)
+{
+    index_t i, j, k;
+    const index_t m = order + 1;
+    const index_t n_points = (pv.x.length < pv.y.length) ? pv.x.length : pv.y.length;
+    const data_t *x = view_ptr(pv.x, 0), *y = view_ptr(pv.y, 0);
+    const index_t x_stride = pv.x.stride, y_stride = pv.y.stride;
+
+    if ((order > POLYFIT_ORDER_MAX) || (n_points < m)) return -1;
+
+    /* Centre and scale abscissa */
+    data_t x_min = x[0], x_max = x[0];
+    for (i = 1; i < n_points; i++)
+    {
+        data_t xi = x[(size_t)i * x_stride];
+        if (xi < x_min) x_min = xi;
+        if (xi > x_max) x_max = xi;
+    }
+    ws->x_center = (x_max + x_min) / 2;
+    ws->x_scale = (x_max - x_min > 0) ? 2 / (x_max - x_min) : 1;
+    if ((order > 0) & !(x_max - x_min > 0)) return -1;
+
+    /* Power sums: running product u^k instead of pow(x, k) */
+    for (k = 0; k < 2 * m - 1; k++) ws->moment[k] = 0;
+    for (k = 0; k < m; k++) ws->rhs[k] = 0;
+
+    for (i = 0; i < n_points; i++)
+    {
+        const data_t u = (x[(size_t)i * x_stride] - ws->x_center) * ws->x_scale;
+        const data_t yi = y[(size_t)i * y_stride];
+        data_t p = 1;
+        for (k = 0; k < m; k++)
+        {
+            ws->moment[k] += p;
+            ws->rhs[k] += p * yi;
+            p *= u;
+        }
+        for (; k < 2 * m - 1; k++)
+        {
+            ws->moment[k] += p;
+            p *= u;
+        }
+    }
+
+    /* Cholesky decomposition of the normal (Hankel) matrix A[i][j] = moment[i + j] */
+    for (j = 0; j < m; j++)
+    {
+        data_t d = ws->moment[2 * j];
+        for (k = 0; k < j; k++) d -= ws->chol[j][k] * ws->chol[j][k];
+        if (!(d > 0)) return -1;
+        ws->chol[j][j] = sqrt(d);
+
+        for (i = j + 1; i < m; i++)
+        {
+            data_t s = ws->moment[i + j];
+            for (k = 0; k < j; k++) s -= ws->chol[i][k] * ws->chol[j][k];
+            ws->chol[i][j] = s / ws->chol[j][j];
+        }
+    }
+
+    /* Forward (L z = rhs) and backward (L^T c = z) substitution */
+    for (i = 0; i < m; i++)
+    {
+        data_t s = ws->rhs[i];
+        for (k = 0; k < i; k++) s -= ws->chol[i][k] * ws->coeff[k];
+        ws->coeff[i] = s / ws->chol[i][i];
+    }
+    for (i = m; i-- > 0;)
+    {
+        data_t s = ws->coeff[i];
+        for (k = i + 1; k < m; k++) s -= ws->chol[k][i] * ws->coeff[k];
+        ws->coeff[i] = s / ws->chol[i][i];
+    }
+
+    ws->order = order;
+    return 0;
+}
+
+int
+polyfit(Polyfit_Workspace *ws, const data_t *x, const data_t *y, index_t n_points, index_t order)
+{
+    Points_View pv = { view_array((data_t *)x, n_points), view_array((data_t *)y, n_points) };
+    return polyfit_view(ws, pv, order);
+}
+
+int
+polyfit_points(Polyfit_Workspace *ws, Point (*p)[], index_t n_points, index_t order)
+{
+    return polyfit_view(ws, points_view_aos(p, n_points), order);
+}
+
+data_t
+polyfit_eval(const Polyfit_Workspace *ws, data_t x)
+{
+    const data_t u = (x - ws->x_center) * ws->x_scale;
+    data_t value = ws->coeff[ws->order];
+    for (index_t k = ws->order; k-- > 0;)
+    {
+        value = value * u + ws->coeff[k];
+    }
+    return value;
+}
+
+data_t
+polyfit_vertex(const Polyfit_Workspace *ws)
+{
+    if ((ws->order != 2) || !(fabs(ws->coeff[2]) > 0)) return ws->x_center;
+    return ws->x_center - ws->coeff[1] / (2 * ws->coeff[2] * ws->x_scale);
+}
+
+void
+polyfit_coefficients(const Polyfit_Workspace *ws, data_t *c)
+{
+    index_t i, j;
+    const index_t m = ws->order;
+
+    /* Undo scaling: polynomial in t = x - x_center */
+    data_t s = 1;
+    for (i = 0; i <= m; i++)
+    {
+        c[i] = ws->coeff[i] * s;
+        s *= ws->x_scale;
+    }
+
+    /* Undo centering: Taylor shift by -x_center */
+    for (i = 0; i < m; i++)
+    {
+        for (j = m; j > i; j--)
+        {
+            c[j - 1] -= ws->x_center * c[j];
+        }
+    }
+}
@@ -0,0 +1,44 @@
+#include <string.h>
+
+#include "ensen_private.h"
+#include "ensen_signal_ring.h"
+#include "mem/ensen_mem_guarded.h"
+
+int
+ring_init(Ring *r, index_t capacity)
+{
+    (*r).data     = NULL;
+    (*r).capacity = capacity;
+    (*r).head     = 0;
+    (*r).count    = 0;
+
+    if (capacity == 0) return -1;
+
+    (*r).data = MEM_calloc_arrayN(capacity, sizeof(data_t), "ring_init: data");
+    return 0;
+}
+
+void
+ring_free(Ring *r)
+{
+    if ((*r).data != NULL) MEM_freeN((*r).data);
+    (*r).data = NULL;
+}
+
+index_t
+ring_copy(const Ring *r, data_t *out)
+{
+    const index_t n = ring_length(r);
+
+    if (n < (*r).capacity)
+    {
+        memcpy(out, (*r).data, sizeof(data_t) * n);
+        return n;
+    }
+
+    /* full: the oldest value is at head */
+    const index_t tail = (*r).capacity - (*r).head;
+    memcpy(out, (*r).data + (*r).head, sizeof(data_t) * tail);
+    memcpy(out + tail, (*r).data, sizeof(data_t) * (*r).head);
+    return n;
+}
@@ -0,0 +1,159 @@
+#include <math.h>
+
+#include "ensen_private.h"
+#include "ensen_signal_sensor.h"
+#include "ensen_signal_grid.h"
+#include "mem/ensen_mem_guarded.h"
+
+/* Number of per-sensor arrays besides history */
+#define SENSOR_BANK_ARRAYS 10
+
+int
+sensor_bank_init(Sensor_Bank *bank, index_t n_sensors, index_t capacity, data_t temperature)
+{
+    (*bank).n_sensors = n_sensors;
+    (*bank).capacity  = capacity;
+    (*bank).head      = 0;
+    (*bank).count     = 0;
+    (*bank).dev_count = 0;
+    (*bank).started   = false;
+    (*bank).calibration = NULL;
+    (*bank).position  = NULL;
+
+    if ((n_sensors == 0) || (capacity == 0)) return -1;
+
+    /* all arrays in one block */
+    const size_t n = n_sensors;
+    data_t *block = MEM_malloc_arrayN(n * (SENSOR_BANK_ARRAYS + (size_t)capacity), sizeof(data_t), "sensor_bank_init: block");
+
+    (*bank).position    = block;
+    (*bank).reference   = block + n;
+    (*bank).temperature = block + 2 * n;
+    (*bank).dev_mean    = block + 3 * n;
+    (*bank).dev_m2      = block + 4 * n;
+    (*bank).dev_min     = block + 5 * n;
+    (*bank).dev_max     = block + 6 * n;
+    (*bank).dev_abs_min = block + 7 * n;
+    (*bank).origin      = block + 8 * n;
+    (*bank).shift       = block + 9 * n;
+    (*bank).history     = block + SENSOR_BANK_ARRAYS * n;
+
+    for (index_t s = 0; s < n_sensors; s++)
+    {
+        (*bank).position[s] = (*bank).reference[s] = (*bank).origin[s] = (*bank).shift[s] = 0;
+        (*bank).temperature[s] = temperature;
+        (*bank).history[(size_t)s * capacity] = temperature;
+        (*bank).dev_mean[s] = (*bank).dev_m2[s] = 0;
+        (*bank).dev_min[s] = (*bank).dev_max[s] = (*bank).dev_abs_min[s] = 0;
+    }
+    (*bank).head  = (capacity > 1) ? 1 : 0;
+    (*bank).count = 1;
+
+    return 0;
+}
+
+void
+sensor_bank_free(Sensor_Bank *bank)
+{
+    if ((*bank).position != NULL) MEM_freeN((*bank).position);
+    (*bank).position = NULL;
+}
+
+int
+sensor_bank_calibrate(Sensor_Bank *bank, const Calibration *c)
+{
+    if ((c != NULL) && (c->n_sensors != (*bank).n_sensors)) return -1;
+
+    (*bank).calibration = c;
+    return 0;
+}
+
+void
+sensor_bank_update(Sensor_Bank *bank, const Peaks *p, const Grid *grid, data_t coefficient)
+{
+    const index_t n = (*bank).n_sensors;
+    const index_t n_found = ((*p).total_number < n) ? (*p).total_number : n;
+    data_t *restrict position    = (*bank).position;
+    data_t *restrict reference   = (*bank).reference;
+    data_t *restrict temperature = (*bank).temperature;
+
+    /* gather peak positions (array of structures) */
+    for (index_t s = 0; s < n_found; s++)
+    {
+        position[s] = grid_ind2val(grid, (*p).peak[s].position);
+    }
+
+    if (!(*bank).started)
+    {
+        for (index_t s = 0; s < n; s++) reference[s] = (*bank).origin[s] = position[s];
+        (*bank).started = true;
+        return;
+    }
+
+    if ((*bank).calibration != NULL)
+    {
+        data_t *restrict shift = (*bank).shift;
+        const data_t *restrict origin = (*bank).origin;
+        for (index_t s = 0; s < n; s++)
+        {
+            shift[s] = position[s] - origin[s];
+            reference[s] = position[s];
+        }
+        calibration_eval((*bank).calibration, shift, temperature);
+    }
+    else
+    {
+        const data_t scale = 1.0 / coefficient;
+        for (index_t s = 0; s < n; s++)
+        {
+            temperature[s] += (position[s] - reference[s]) * scale;
+            reference[s] = position[s];
+        }
+    }
+
+    /* the same slot of every sensor's ring */
+    const index_t head = (*bank).head;
+    for (index_t s = 0; s < n; s++)
+    {
+        (*bank).history[(size_t)s * (*bank).capacity + head] = temperature[s];
+    }
+    (*bank).head = (head + 1 == (*bank).capacity) ? 0 : head + 1;
+    (*bank).count++;
+}
+
+void
+sensor_bank_deviation(Sensor_Bank *bank, data_t temperature)
+{
+    const index_t n = (*bank).n_sensors;
+    const data_t *restrict t = (*bank).temperature;
+    data_t *restrict mean    = (*bank).dev_mean;
+    data_t *restrict m2      = (*bank).dev_m2;
+    data_t *restrict dmin    = (*bank).dev_min;
+    data_t *restrict dmax    = (*bank).dev_max;
+    data_t *restrict abs_min = (*bank).dev_abs_min;
+
+    if ((*bank).dev_count++ == 0)
+    {
+        for (index_t s = 0; s < n; s++)
+        {
+            const data_t d = t[s] - temperature;
+            mean[s] = d;
+            m2[s] = 0;
+            dmin[s] = dmax[s] = d;
+            abs_min[s] = fabs(d);
+        }
+        return;
+    }
+
+    const data_t inv_count = 1.0 / (*bank).dev_count;
+    for (index_t s = 0; s < n; s++)
+    {
+        const data_t d = t[s] - temperature;
+        const data_t delta = d - mean[s];
+        mean[s] += delta * inv_count;
+        m2[s] += delta * (d - mean[s]);
+        dmin[s] = fmin(dmin[s], d);
+        dmax[s] = fmax(dmax[s], d);
+        abs_min[s] = fmin(abs_min[s], fabs(d));
+    }
+}
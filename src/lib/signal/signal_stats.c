@@ -0,0 +1,176 @@
+#include <math.h>
+
+#ifdef __SSE2__
+  #include <emmintrin.h>
+#endif
+
+#include "ensen_private.h"
+#include "ensen_signal_stats.h"
+#include "ensen_signal_view.h"
+
+#ifdef __SSE2__
+/* Select a where mask is set, b otherwise */
+static inline __m128d
+_stats_select(__m128d mask, __m128d a, __m128d b)
+{
+    return _mm_or_pd(_mm_and_pd(mask, a), _mm_andnot_pd(mask, b));
+}
+#endif
+
+void
+stats_reduce(const data_t *x, index_t n_points, Stats *stats)
+{
+    stats_reduce_view(view_array((data_t *)x, n_points), stats);
+}
+
+void
+stats_reduce_view(View view, Stats *stats)
+{
+    Stats s = { 0 };
+    const index_t n_points = view.length;
+    const size_t stride = view.stride;
+    const data_t *x = view_ptr(view, 0);
+
+    if (n_points == 0)
+    {
+        *stats = s;
+        return;
+    }
+
+    const data_t shift = x[0];
+    data_t dsum = 0, dsq = 0;
+    index_t i = 0;
+
+    s.min = s.max = x[0];
+    s.abs_min = s.abs_max = fabs(x[0]);
+
+#ifdef __SSE2__
+    if ((n_points >= 4) && (stride == 1))
+    {
+        const __m128d sign  = _mm_set1_pd(-0.0);
+        const __m128d two   = _mm_set1_pd(2.0);
+        const __m128d vshft = _mm_set1_pd(shift);
+
+        __m128d v    = _mm_loadu_pd(x);
+        __m128d idx  = _mm_set_pd(1.0, 0.0);
+        __m128d vmin = v, imin = idx;
+        __m128d vmax = v, imax = idx;
+        __m128d amin = _mm_andnot_pd(sign, v), amax = amin;
+        __m128d vsum = v;
+        __m128d d    = _mm_sub_pd(v, vshft);
+        __m128d vds  = d, vdq = _mm_mul_pd(d, d);
+
+        for (i = 2; i + 2 <= n_points; i += 2)
+        {
+            v   = _mm_loadu_pd(x + i);
+            idx = _mm_add_pd(idx, two);
+
+            imin = _stats_select(_mm_cmplt_pd(v, vmin), idx, imin);
+            vmin = _mm_min_pd(v, vmin);
+            imax = _stats_select(_mm_cmpgt_pd(v, vmax), idx, imax);
+            vmax = _mm_max_pd(v, vmax);
+
+            __m128d a = _mm_andnot_pd(sign, v);
+            amin = _mm_min_pd(a, amin);
+            amax = _mm_max_pd(a, amax);
+
+            vsum = _mm_add_pd(vsum, v);
+            d    = _mm_sub_pd(v, vshft);
+            vds  = _mm_add_pd(vds, d);
+            vdq  = _mm_add_pd(vdq, _mm_mul_pd(d, d));
+        }
+
+        /* Reduce two lanes (on a tie keep the first index) */
+        double lmin[2], lmax[2], limin[2], limax[2], lamin[2], lamax[2], lsum[2], lds[2], ldq[2];
+        _mm_storeu_pd(lmin, vmin);  _mm_storeu_pd(limin, imin);
+        _mm_storeu_pd(lmax, vmax);  _mm_storeu_pd(limax, imax);
+        _mm_storeu_pd(lamin, amin); _mm_storeu_pd(lamax, amax);
+        _mm_storeu_pd(lsum, vsum);  _mm_storeu_pd(lds, vds); _mm_storeu_pd(ldq, vdq);
+
+        index_t l = ((lmin[1] < lmin[0]) || (!(lmin[1] > lmin[0]) && (limin[1] < limin[0]))) ? 1 : 0;
+        s.min = lmin[l]; s.argmin = (index_t)limin[l];
+        l = ((lmax[1] > lmax[0]) || (!(lmax[1] < lmax[0]) && (limax[1] < limax[0]))) ? 1 : 0;
+        s.max = lmax[l]; s.argmax = (index_t)limax[l];
+        s.abs_min = (lamin[1] < lamin[0]) ? lamin[1] : lamin[0];
+        s.abs_max = (lamax[1] > lamax[0]) ? lamax[1] : lamax[0];
+        s.sum = lsum[0] + lsum[1];
+        dsum  = lds[0] + lds[1];
+        dsq   = ldq[0] + ldq[1];
+    }
+#endif
+
+    for (; i < n_points; i++)
+    {
+        const data_t xi = x[i * stride];
+        const data_t a = fabs(xi);
+        const data_t d = xi - shift;
+
+        if (xi < s.min) { s.min = xi; s.argmin = i; }
+        if (xi > s.max) { s.max = xi; s.argmax = i; }
+        if (a < s.abs_min) s.abs_min = a;
+        if (a > s.abs_max) s.abs_max = a;
+        s.sum += xi;
+        dsum  += d;
+        dsq   += d * d;
+    }
+
+    s.mean = s.sum / n_points;
+    s.variance = (dsq - dsum * dsum / n_points) / n_points;
+    if (s.variance < 0) s.variance = 0;
+
+    *stats = s;
+}
+
+/* k-th smallest value of x (x is reordered), Wirth's selection */
+static data_t
+_stats_nth(data_t *x, int32_t n, int32_t k)
+{
+    int32_t left = 0, right = n - 1;
+    while (left < right)
+    {
+        const data_t pivot = x[k];
+        int32_t i = left, j = right;
+        do
+        {
+            while (x[i] < pivot) i++;
+            while (pivot < x[j]) j--;
+            if (i <= j)
+            {
+                const data_t t = x[i];
+                x[i++] = x[j];
+                x[j--] = t;
+            }
+        } while (i <= j);
+        if (j < k) left = i;
+        if (k < i) right = j;
+    }
+    return x[k];
+}
+
+data_t
+stats_noise(const data_t *y, index_t n_points, index_t block, data_t threshold, data_t *scratch)
+{
+    if (block < 1) block = 1;
+    const index_t n_blocks = n_points / block;
+    if (n_blocks < 2) return 0;
+
+    /* differences of neighbour blocks below threshold, of all blocks if the peak-free part is too short */
+    index_t n = 0;
+    for (index_t pass = 0; (pass < 2) && (n < STATS_NOISE_POINTS_MIN); pass++)
+    {
+        const data_t limit = (pass == 0) ? threshold * block : INFINITY;
+        data_t previous = 0;
+        n = 0;
+        for (index_t j = 0; j < n_blocks; j++)
+        {
+            data_t sum = 0;
+            for (index_t i = j * block; i < (j + 1) * block; i++) sum += y[i];
+            if ((j > 0) && (sum < limit) && (previous < limit)) scratch[n++] = fabs(sum - previous) / block;
+            previous = sum;
+        }
+    }
+    if (n == 0) return 0;
+
+    /* MAD of differences of white noise of sigma / sqrt(block): 0.6745 * sqrt(2 / block) * sigma */
+    return _stats_nth(scratch, n, n / 2) * 1.4826 * sqrt(block / 2.0);
+}
@@ -0,0 +1,154 @@
+#include <stdio.h>
+
+#include "ensen_private.h"
+#include "ensen_signal_stream.h"
+#include "signal_intern.h"
+#include "mem/ensen_mem_guarded.h"
+
+struct _peak_stream
+{
+    index_t   width;           /* smoothing window (points) */
+    index_t   level;           /* number of smoothing passes */
+    index_t   n_points;        /* frame size (duplicate suppression rule) */
+    index_t   peaks_max;       /* size of output peaks array */
+    data_t    threshold_amp;
+    data_t    threshold_slope;
+
+    data_t  * ring;            /* last `width` input samples of every pass */
+    data_t  * sum;             /* running sum of every pass */
+    uint32_t* count;           /* number of samples received by every pass */
+
+    data_t    window[4];       /* last smoothed samples: y[i - 1] .. y[i + 2] */
+    uint32_t  n_smooth;        /* number of smoothed samples */
+    uint32_t  first;           /* raw index of the first smoothed sample */
+    data_t    last_peak;       /* position of the last reported peak */
+    bool      has_peak;
+    bool      overflow;
+};
+
+Peak_Stream *
+peak_stream_new(const Signal_Parameters *conf)
+{
+    Peak_Stream *ps = MEM_callocN(sizeof(Peak_Stream), "peak_stream_new: stream");
+
+    ps->width           = ((*conf).smooth.width > 0) ? (*conf).smooth.width : 1;
+    ps->level           = (*conf).smooth.level;
+    ps->n_points        = (*conf).n_points;
+    ps->peaks_max       = (*conf).search.peaks_array_number;
+    ps->threshold_amp   = (*conf).search.threshold_amp;
+    ps->threshold_slope = (*conf).search.threshold_slope;
+
+    if (ps->level > 0)
+    {
+        ps->ring  = MEM_malloc_arrayN((size_t)ps->level * ps->width, sizeof(data_t), "peak_stream_new: ring");
+        ps->sum   = MEM_malloc_arrayN(ps->level, sizeof(data_t), "peak_stream_new: sum");
+        ps->count = MEM_malloc_arrayN(ps->level, sizeof(uint32_t), "peak_stream_new: count");
+    }
+
+    /* every pass outputs the centered mean of smooth(): the first one at index width/2 - 1 */
+    ps->first = (uint32_t)ps->level * (ps->width / 2 - ((ps->width > 1) ? 1 : 0));
+
+    peak_stream_reset(ps);
+    return ps;
+}
+
+void
+peak_stream_free(Peak_Stream *ps)
+{
+    if (ps == NULL) return;
+    if (ps->level > 0)
+    {
+        MEM_freeN(ps->ring);
+        MEM_freeN(ps->sum);
+        MEM_freeN(ps->count);
+    }
+    MEM_freeN(ps);
+}
+
+void
+peak_stream_reset(Peak_Stream *ps)
+{
+    for (index_t l = 0; l < ps->level; l++)
+    {
+        ps->sum[l] = 0;
+        ps->count[l] = 0;
+    }
+    ps->n_smooth = 0;
+    ps->has_peak = false;
+    ps->overflow = false;
+}
+
+index_t
+peak_stream_latency(const Peak_Stream *ps)
+{
+    return ps->level * (ps->width - ps->width / 2) + 2;
+}
+
+/* One moving average pass, returns true when output is available */
+static inline bool
+_stream_smooth(Peak_Stream *ps, index_t l, data_t *v)
+{
+    data_t *ring = ps->ring + (size_t)l * ps->width;
+    uint32_t slot = ps->count[l] % ps->width;
+
+    if (ps->count[l] >= ps->width) ps->sum[l] -= ring[slot];
+    ring[slot] = *v;
+    ps->sum[l] += *v;
+    ps->count[l]++;
+
+    if (ps->count[l] < ps->width) return false;
+    *v = ps->sum[l] / ps->width;
+    return true;
+}
+
+static inline index_t
+_stream_detect(Peak_Stream *ps, data_t v, Peaks *p)
+{
+    ps->window[0] = ps->window[1];
+    ps->window[1] = ps->window[2];
+    ps->window[2] = ps->window[3];
+    ps->window[3] = v;
+    if (++ps->n_smooth < 4) return 0;
+
+    if (!_peak_candidate(ps->window[0], ps->window[1], ps->window[2], ps->window[3],
+                         ps->threshold_amp, ps->threshold_slope, 1)) return 0;
+
+    /* raw index of window[1] */
+    const data_t position = ps->first + ps->n_smooth - 3;
+
+    /* avoid peak duplication (see findpeaks()) */
+    if (ps->has_peak && ((position - ps->last_peak)/ps->n_points < PEAK_DUPLICATE_DISTANCE)) return 0;
+
+    if ((*p).total_number >= ps->peaks_max)
+    {
+        if (!ps->overflow) printf("Warning: Found too many peaks. Out of array size. \n");
+        ps->overflow = true;
+        return 0;
+    }
+
+    (*p).peak[(*p).total_number].position = position;
+    (*p).total_number++;
+    ps->last_peak = position;
+    ps->has_peak = true;
+    return 1;
+}
+
+index_t
+peak_stream_push(Peak_Stream *ps, const data_t *chunk, index_t n, Peaks *p)
+{
+    index_t found = 0;
+
+    for (index_t i = 0; i < n; i++)
+    {
+        data_t v = chunk[i];
+        /* hack to avoid appearing of 'nan' in data (as in smooth()) */
+        if (!(v >= 0 || v < 0)) v = 0;
+
+        index_t l = 0;
+        while ((l < ps->level) && _stream_smooth(ps, l, &v)) l++;
+        if (l < ps->level) continue;
+
+        found += _stream_detect(ps, v, p);
+    }
+    return found;
+}
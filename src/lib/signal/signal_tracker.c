@@ -0,0 +1,153 @@
+#include <math.h>
+
+#include "ensen_private.h"
+#include "ensen_signal_tracker.h"
+#include "ensen_signal_fit.h"
+
+void
+tracker_init(Tracker *t, data_t process_noise, data_t measurement_noise, data_t gate)
+{
+    t->position = t->velocity = 0;
+    t->p[0][0] = t->p[0][1] = t->p[1][0] = t->p[1][1] = 0;
+    t->process_noise     = process_noise;
+    t->measurement_noise = measurement_noise;
+    t->gate              = gate;
+    t->misses            = 0;
+    t->started           = false;
+}
+
+static void
+_tracker_start(Tracker *t, data_t measurement)
+{
+    t->position = measurement;
+    t->velocity = 0;
+    t->p[0][0] = t->measurement_noise;
+    t->p[1][1] = t->measurement_noise; /* unknown drift */
+    t->p[0][1] = t->p[1][0] = 0;
+    t->misses  = 0;
+    t->started = true;
+}
+
+void
+tracker_predict(Tracker *t)
+{
+    if (!t->started) return;
+
+    /* x = F x, P = F P F^T + Q with F = [1 1; 0 1], Q = q [1/4 1/2; 1/2 1] (one frame) */
+    const data_t q = t->process_noise;
+    t->position += t->velocity;
+
+    const data_t p00 = t->p[0][0] + 2 * t->p[0][1] + t->p[1][1] + q / 4;
+    const data_t p01 = t->p[0][1] + t->p[1][1] + q / 2;
+    const data_t p11 = t->p[1][1] + q;
+
+    t->p[0][0] = p00;
+    t->p[0][1] = t->p[1][0] = p01;
+    t->p[1][1] = p11;
+}
+
+void
+tracker_window(const Tracker *t, data_t *from, data_t *to)
+{
+    if (!t->started)
+    {
+        *from = -HUGE_VAL;
+        *to = HUGE_VAL;
+        return;
+    }
+
+    const data_t half = t->gate * sqrt(t->p[0][0] + t->measurement_noise);
+    *from = t->position - half;
+    *to = t->position + half;
+}
+
+int
+tracker_update(Tracker *t, data_t measurement)
+{
+    if (!t->started || (t->misses >= TRACKER_MISSES_MAX))
+    {
+        _tracker_start(t, measurement);
+        return 0;
+    }
+
+    const data_t s = t->p[0][0] + t->measurement_noise;
+    const data_t innovation = measurement - t->position;
+
+    if (fabs(innovation) > t->gate * sqrt(s))
+    {
+        t->misses++;
+        return -1;
+    }
+
+    const data_t k0 = t->p[0][0] / s;
+    const data_t k1 = t->p[0][1] / s;
+
+    t->position += k0 * innovation;
+    t->velocity += k1 * innovation;
+
+    const data_t p00 = (1 - k0) * t->p[0][0];
+    const data_t p01 = (1 - k0) * t->p[0][1];
+    const data_t p11 = t->p[1][1] - k1 * t->p[0][1];
+
+    t->p[0][0] = p00;
+    t->p[0][1] = t->p[1][0] = p01;
+    t->p[1][1] = p11;
+    t->misses = 0;
+    return 0;
+}
+
+void
+tracker_peaks(Tracker *t, index_t n_trackers, Peaks *p, const data_t *y, index_t n_points, index_t refine)
+{
+    /* all sensors are associated with the found peaks before they are replaced */
+    for (index_t s = 0; s < n_trackers; s++)
+    {
+        data_t from, to;
+        index_t best = UINT16_MAX;
+
+        tracker_predict(&t[s]);
+        tracker_window(&t[s], &from, &to);
+
+        if (t[s].started && (t[s].misses < TRACKER_MISSES_MAX))
+        {
+            /* the nearest peak to the prediction inside the window */
+            data_t best_distance = HUGE_VAL;
+            for (index_t i = 0; i < (*p).total_number; i++)
+            {
+                const data_t distance = fabs((*p).peak[i].position - t[s].position);
+                if (((*p).peak[i].position < from) || ((*p).peak[i].position > to)) continue;
+                if (distance < best_distance)
+                {
+                    best_distance = distance;
+                    best = i;
+                }
+            }
+            if ((best == UINT16_MAX) && ((*p).total_number != n_trackers))
+            {
+                t[s].misses++; /* keep prediction */
+                continue;
+            }
+            if (best == UINT16_MAX)
+            {
+                /* a peak per sensor, but not in the window: all peaks jumped */
+                t[s].misses = TRACKER_MISSES_MAX;
+                best = s;
+            }
+        }
+        else if (s < (*p).total_number)
+        {
+            /* new or lost track: peaks are taken by order */
+            best = s;
+        }
+        else continue;
+
+        data_t measurement = (*p).peak[best].position;
+        if (refine > 0) measurement = findpeak_refine(y, n_points, (index_t)round(measurement), refine);
+        tracker_update(&t[s], measurement);
+    }
+
+    for (index_t s = 0; s < n_trackers; s++)
+    {
+        if (t[s].started) (*p).peak[s].position = t[s].position;
+    }
+}
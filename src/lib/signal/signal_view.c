@@ -0,0 +1,34 @@
+#include <math.h>
+
+#include "ensen_private.h"
+#include "ensen_signal_view.h"
+
+index_t
+view_val2ind(View x, data_t val)
+{
+    if (x.length == 0) return 0;
+
+    /* Binary search of the first value which is not less than val (as grid_val2ind()) */
+    index_t lo = 0, hi = x.length;
+    while (lo < hi)
+    {
+        index_t mid = lo + (hi - lo) / 2;
+        if (*view_ptr(x, mid) < val) lo = mid + 1;
+        else hi = mid;
+    }
+
+    if (lo == 0) return 0;
+    if (lo == x.length) return x.length - 1;
+    return (val - *view_ptr(x, lo - 1) < *view_ptr(x, lo) - val) ? lo - 1 : lo;
+}
+
+Points_View
+points_view_window(Points_View pv, data_t center, data_t window)
+{
+    if (!(fabs(window) > 1.0e-14) || (pv.x.length == 0)) return pv;
+
+    const index_t n1 = view_val2ind(pv.x, center - (window / 2));
+    const index_t n2 = view_val2ind(pv.x, center + (window / 2));
+
+    return points_view_slice(pv, n1, n2 - n1);
+}
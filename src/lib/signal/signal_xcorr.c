@@ -0,0 +1,247 @@
+#include <math.h>
+#include <string.h>
+#include <complex.h>
+#include <fftw3.h>
+
+#include "ensen_private.h"
+#include "ensen_signal_xcorr.h"
+#include "ensen_signal_polyfit.h"
+#include "ensen_benchmark.h"
+#include "mem/ensen_mem_guarded.h"
+
+/* Normalized correlation below this value means the peak is lost */
+#define XCORR_CORRELATION_MIN 0.25
+
+struct _xcorr_tracker
+{
+    index_t        window;
+    index_t        range;
+    index_t        n_sensors;
+    uint32_t       segment;      /* searched part of frame: window + 2 x range */
+    int            n_fft;
+    bool           started;
+
+    fftw_plan      forward;
+    fftw_plan      backward;
+    double       * in;           /* frame segment */
+    fftw_complex * spectrum;     /* spectrum of segment (destroyed by c2r) */
+    double       * corr;         /* correlation for every lag */
+    fftw_complex * reference;    /* conjugated spectra of references (n_sensors x n_fft/2 + 1), 1/n_fft included */
+
+    data_t       * prefix;       /* running sums of segment (segment + 1) */
+    data_t       * prefix_sq;    /* running sums of squares of segment (segment + 1) */
+
+    data_t       * norm;         /* reference norm */
+    uint32_t     * ref_start;    /* first point of the reference window */
+    data_t       * ref_position; /* peak position in the reference frame */
+    data_t       * shift;        /* displacement from the reference position */
+
+    index_t        fit_half;     /* lags on each side of the maximum used for refinement */
+    data_t       * fit_x;
+    data_t       * fit_y;
+    Polyfit_Workspace fit;
+};
+
+Xcorr_Tracker *
+xcorr_tracker_new(index_t window, index_t range, index_t n_sensors)
+{
+    if ((window < 8) || (n_sensors == 0)) return NULL;
+
+    Xcorr_Tracker *tr = MEM_callocN(sizeof(Xcorr_Tracker), "xcorr_tracker_new: tracker");
+
+    tr->window    = window;
+    tr->range     = range;
+    tr->n_sensors = n_sensors;
+    tr->segment   = (uint32_t)window + 2 * (uint32_t)range;
+    tr->n_fft     = 1;
+    while ((uint32_t)tr->n_fft < tr->segment) tr->n_fft <<= 1;
+
+    const int n_freq = tr->n_fft/2 + 1;
+
+    /* FFT buffers are aligned by fftw (SIMD codelets) */
+    tr->in        = fftw_malloc(sizeof(double) * tr->n_fft);
+    tr->corr      = fftw_malloc(sizeof(double) * tr->n_fft);
+    tr->spectrum  = fftw_malloc(sizeof(fftw_complex) * n_freq);
+    tr->reference = fftw_malloc(sizeof(fftw_complex) * n_freq * n_sensors);
+
+    tr->forward  = fftw_plan_dft_r2c_1d(tr->n_fft, tr->in, tr->spectrum, FFTW_MEASURE);
+    tr->backward = fftw_plan_dft_c2r_1d(tr->n_fft, tr->spectrum, tr->corr, FFTW_MEASURE);
+
+    tr->prefix       = MEM_malloc_arrayN(tr->segment + 1, sizeof(data_t), "xcorr_tracker_new: prefix");
+    tr->prefix_sq    = MEM_malloc_arrayN(tr->segment + 1, sizeof(data_t), "xcorr_tracker_new: prefix_sq");
+    tr->norm         = MEM_malloc_arrayN(n_sensors, sizeof(data_t), "xcorr_tracker_new: norm");
+    tr->ref_start    = MEM_malloc_arrayN(n_sensors, sizeof(uint32_t), "xcorr_tracker_new: ref_start");
+    tr->ref_position = MEM_malloc_arrayN(n_sensors, sizeof(data_t), "xcorr_tracker_new: ref_position");
+    tr->shift        = MEM_malloc_arrayN(n_sensors, sizeof(data_t), "xcorr_tracker_new: shift");
+
+    /* the correlation maximum is as wide as the peak: fit a part of the window, not three lags */
+    tr->fit_half = window/16;
+    tr->fit_x    = MEM_malloc_arrayN(2 * tr->fit_half + 1, sizeof(data_t), "xcorr_tracker_new: fit_x");
+    tr->fit_y    = MEM_malloc_arrayN(2 * tr->fit_half + 1, sizeof(data_t), "xcorr_tracker_new: fit_y");
+
+    return tr;
+}
+
+void
+xcorr_tracker_free(Xcorr_Tracker *tr)
+{
+    if (tr == NULL) return;
+
+    fftw_destroy_plan(tr->forward);
+    fftw_destroy_plan(tr->backward);
+    fftw_free(tr->in);
+    fftw_free(tr->corr);
+    fftw_free(tr->spectrum);
+    fftw_free(tr->reference);
+
+    MEM_freeN(tr->prefix);
+    MEM_freeN(tr->prefix_sq);
+    MEM_freeN(tr->norm);
+    MEM_freeN(tr->ref_start);
+    MEM_freeN(tr->ref_position);
+    MEM_freeN(tr->shift);
+    MEM_freeN(tr->fit_x);
+    MEM_freeN(tr->fit_y);
+    MEM_freeN(tr);
+}
+
+/* First point of a window of `len` points started at `start`, kept inside the frame */
+static uint32_t
+_xcorr_clamp(data_t start, uint32_t len, index_t n_points)
+{
+    if ((start < 0) || (len >= n_points)) return 0;
+    if (start > n_points - len) return n_points - len;
+    return (uint32_t)start;
+}
+
+int
+xcorr_tracker_start(Xcorr_Tracker *tr, const data_t *y, index_t n_points, const Peaks *p)
+{
+    const int n_freq = tr->n_fft/2 + 1;
+    const index_t w = tr->window;
+
+    if (((*p).total_number < tr->n_sensors) || (n_points < w)) return -1;
+
+    for (index_t s = 0; s < tr->n_sensors; s++)
+    {
+        const data_t position = (*p).peak[s].position;
+        const uint32_t start = _xcorr_clamp(round(position) - w/2, w, n_points);
+
+        /*
+         * zero-mean reference: the correlation with the raw segment equals
+         * the correlation with the zero-mean segment (Pearson coefficient)
+         */
+        data_t mean = 0, norm = 0;
+        for (index_t k = 0; k < w; k++) mean += y[start + k];
+        mean /= w;
+        for (index_t k = 0; k < w; k++)
+        {
+            tr->in[k] = y[start + k] - mean;
+            norm += tr->in[k] * tr->in[k];
+        }
+        memset(tr->in + w, 0, sizeof(double) * (tr->n_fft - w));
+
+        fftw_execute(tr->forward);
+        for (int k = 0; k < n_freq; k++)
+        {
+            tr->reference[(size_t)s * n_freq + k] = conj(tr->spectrum[k]) / tr->n_fft;
+        }
+
+        tr->norm[s]         = sqrt(norm);
+        tr->ref_start[s]    = start;
+        tr->ref_position[s] = position;
+        tr->shift[s]        = 0;
+    }
+
+    tr->started = true;
+    return 0;
+}
+
+/* Normalized correlation of the reference with the segment at lag */
+static inline data_t
+_xcorr_normalized(const Xcorr_Tracker *tr, index_t s, uint32_t lag)
+{
+    const index_t w = tr->window;
+    const data_t sum = tr->prefix[lag + w] - tr->prefix[lag];
+    const data_t energy = (tr->prefix_sq[lag + w] - tr->prefix_sq[lag]) - sum * sum / w;
+
+    if (!(energy > 0) || !(tr->norm[s] > 0)) return 0;
+    return tr->corr[lag] / (tr->norm[s] * sqrt(energy));
+}
+
+data_t
+xcorr_track(Xcorr_Tracker *tr, const data_t *y, index_t n_points, Peaks *p)
+{
+    double start_time = get_run_time();
+    const int n_freq = tr->n_fft/2 + 1;
+    const index_t w = tr->window;
+
+    if (!tr->started || (n_points < w)) return get_run_time() - start_time;
+
+    const uint32_t len = (tr->segment < n_points) ? tr->segment : n_points;
+
+    for (index_t s = 0; s < tr->n_sensors; s++)
+    {
+        /* segment around the expected position of the reference window */
+        const uint32_t seg_start = _xcorr_clamp(tr->ref_start[s] + round(tr->shift[s]) - tr->range, len, n_points);
+
+        tr->prefix[0] = tr->prefix_sq[0] = 0;
+        for (uint32_t k = 0; k < len; k++)
+        {
+            const data_t v = y[seg_start + k];
+            tr->in[k] = v;
+            tr->prefix[k + 1] = tr->prefix[k] + v;
+            tr->prefix_sq[k + 1] = tr->prefix_sq[k] + v * v;
+        }
+        memset(tr->in + len, 0, sizeof(double) * (tr->n_fft - len));
+
+        fftw_execute(tr->forward);
+        const fftw_complex *ref = tr->reference + (size_t)s * n_freq;
+        for (int k = 0; k < n_freq; k++) tr->spectrum[k] *= ref[k];
+        fftw_execute(tr->backward);
+
+        /* best lag */
+        const uint32_t n_lags = len - w + 1;
+        uint32_t best = 0;
+        data_t best_value = _xcorr_normalized(tr, s, 0);
+        for (uint32_t lag = 1; lag < n_lags; lag++)
+        {
+            const data_t v = _xcorr_normalized(tr, s, lag);
+            if (v > best_value) { best_value = v; best = lag; }
+        }
+        if (best_value < XCORR_CORRELATION_MIN) continue; // lost: keep the previous position
+
+        /* sub-sample maximum: vertex of least-squares parabola around the best lag */
+        data_t delta = 0;
+        const index_t h = tr->fit_half;
+        if ((best >= h) && (best + h < n_lags))
+        {
+            for (index_t k = 0; k <= 2 * h; k++)
+            {
+                tr->fit_x[k] = (data_t)k - h;
+                tr->fit_y[k] = _xcorr_normalized(tr, s, best + k - h);
+            }
+            if (polyfit(&tr->fit, tr->fit_x, tr->fit_y, 2 * h + 1, 2) == 0)
+            {
+                const data_t vertex = polyfit_vertex(&tr->fit);
+                if (fabs(vertex) <= h) delta = vertex;
+            }
+        }
+
+        tr->shift[s] = (data_t)seg_start + best + delta - tr->ref_start[s];
+    }
+
+    for (index_t s = 0; s < tr->n_sensors; s++)
+    {
+        (*p).peak[s].position = tr->ref_position[s] + tr->shift[s];
+    }
+    (*p).total_number = tr->n_sensors;
+
+    return get_run_time() - start_time;
+}
+
+data_t
+xcorr_shift(const Xcorr_Tracker *tr, index_t sensor)
+{
+    return tr->shift[sensor];
+}
@@ -0,0 +1,53 @@
+#ifndef ENSEN_THREAD_PIPELINE_H
+#define ENSEN_THREAD_PIPELINE_H
+
+#ifndef ENSEN_PRIVATE_H
+    #include "ensen_private.h"
+#endif
+
+typedef struct _pipeline Pipeline;
+
+/**
+    @brief Stage of the pipeline
+    @param frame Frame buffer
+    @param number Number of frame (0, 1, ... in order of the first stage)
+    @param data User data of the stage
+    @return 0 to continue, -1 to stop the pipeline
+**/
+typedef int (*Pipeline_Stage)(void *frame, uint32_t number, void *data);
+
+/**
+    @brief Create pipeline
+    @param n_stages Number of stages
+    @param stage Stage functions (n_stages)
+    @param data User data of every stage (n_stages)
+    @param frame Preallocated frame buffers (n_frames), owned by the caller
+    @param n_frames Number of frame buffers (frames in flight)
+    @return Pipeline (free with pipeline_free()), NULL if there are no stages or frames
+
+    Every stage runs on its own thread and takes frames in order from a
+    lock-free single-producer/single-consumer queue filled by the previous
+    stage; the last stage returns buffers to the first one. The first
+    stage produces frame N + 1 while frame N is in the next stage, so the
+    throughput is set by the slowest stage.
+**/
+Pipeline *pipeline_new(index_t n_stages, const Pipeline_Stage *stage, void *const *data, void *const *frame, index_t n_frames);
+
+/**
+    @brief Free pipeline
+    @param pl Pipeline
+**/
+void pipeline_free(Pipeline *pl);
+
+/**
+    @brief Pass frames through all stages
+    @param pl Pipeline
+    @param n_frames Number of frames to produce by the first stage
+    @return Number of frames finished by the last stage (less than n_frames if a stage stopped the pipeline)
+
+    The last stage runs on the calling thread (it may use non thread-safe
+    output), the other ones on threads started for the run.
+**/
+uint32_t pipeline_run(Pipeline *pl, uint32_t n_frames);
+
+#endif
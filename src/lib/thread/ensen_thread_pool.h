@@ -0,0 +1,59 @@
+#ifndef ENSEN_THREAD_POOL_H
+#define ENSEN_THREAD_POOL_H
+
+#ifndef ENSEN_PRIVATE_H
+    #include "ensen_private.h"
+#endif
+
+typedef struct _thread_pool Thread_Pool;
+
+/**
+    @brief Task of the pool
+    @param data User data passed to thread_pool_run()
+    @param task Task index (0 .. n_tasks - 1)
+    @param worker Index of the worker running the task (0 .. thread_pool_size() - 1),
+                  to select per-worker scratch memory
+**/
+typedef void (*Thread_Task)(void *data, uint32_t task, index_t worker);
+
+/**
+    @brief Number of online processors
+    @return Number of processors (at least 1)
+**/
+index_t thread_count(void);
+
+/**
+    @brief Create pool of worker threads
+    @param n_workers Number of workers including the calling thread (0 - thread_count())
+    @return Pool (free with thread_pool_free()), NULL if threads cannot be started
+**/
+Thread_Pool *thread_pool_new(index_t n_workers);
+
+/**
+    @brief Stop worker threads and free pool
+    @param pool Pool
+**/
+void thread_pool_free(Thread_Pool *pool);
+
+/**
+    @brief Number of workers of the pool
+    @param pool Pool
+    @return Number of workers including the calling thread
+**/
+index_t thread_pool_size(const Thread_Pool *pool);
+
+/**
+    @brief Run tasks on all workers and wait for them
+    @param pool Pool
+    @param n_tasks Number of tasks
+    @param task Task function
+    @param data User data of tasks
+
+    Workers (and the calling thread as worker 0) take the next task index
+    from a shared atomic counter, so a worker which finished its task
+    immediately takes the next one and uneven tasks are balanced without
+    queues. The result of a task must depend only on its index.
+**/
+void thread_pool_run(Thread_Pool *pool, uint32_t n_tasks, Thread_Task task, void *data);
+
+#endif
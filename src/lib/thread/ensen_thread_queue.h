@@ -0,0 +1,42 @@
+#ifndef ENSEN_THREAD_QUEUE_H
+#define ENSEN_THREAD_QUEUE_H
+
+#ifndef ENSEN_PRIVATE_H
+    #include "ensen_private.h"
+#endif
+
+typedef struct _thread_queue Thread_Queue;
+
+/**
+    @brief Create lock-free queue of one producer and one consumer thread
+    @param capacity Maximal number of items (rounded up to a power of two)
+    @return Queue (free with thread_queue_free())
+
+    Producer owns the tail and consumer owns the head, each on its own
+    cache line; an item is published by the atomic store of the tail, so
+    neither side ever blocks or takes a lock.
+**/
+Thread_Queue *thread_queue_new(uint32_t capacity);
+
+/**
+    @brief Free queue
+    @param q Queue (no thread uses it)
+**/
+void thread_queue_free(Thread_Queue *q);
+
+/**
+    @brief Append item (producer thread only)
+    @param q Queue
+    @param item Item (not NULL)
+    @return 0 on success, -1 if queue is full
+**/
+int thread_queue_push(Thread_Queue *q, void *item);
+
+/**
+    @brief Take the oldest item (consumer thread only)
+    @param q Queue
+    @return Item, NULL if queue is empty
+**/
+void *thread_queue_pop(Thread_Queue *q);
+
+#endif
@@ -0,0 +1,53 @@
+#ifndef ENSEN_THREAD_RT_H
+#define ENSEN_THREAD_RT_H
+
+#ifndef ENSEN_PRIVATE_H
+    #include "ensen_private.h"
+#endif
+
+/*
+ * Real-time execution profile of the calling thread: memory is locked
+ * (no page faults in the frame loop), the thread is scheduled by
+ * SCHED_FIFO and pinned to one core. Every step needs privileges
+ * (CAP_IPC_LOCK, CAP_SYS_NICE or rlimits), a failed step is reported
+ * and the others are still applied.
+ */
+
+/* Stack touched after locking memory, so the frame loop does not fault on it */
+#define REALTIME_STACK_PREFAULT (64 * 1024)
+
+/**
+    @brief Lock current and future memory of the process
+    @return 0 on success, -1 on failure (see errno)
+**/
+int realtime_lock_memory(void);
+
+/**
+    @brief Schedule the calling thread by SCHED_FIFO
+    @param priority Priority (1 .. 99, 0 - keep the default scheduler)
+    @return 0 on success, -1 on failure (see errno)
+**/
+int realtime_set_priority(index_t priority);
+
+/**
+    @brief Pin the calling thread to the core
+    @param cpu Core number (-1 - no pinning)
+    @return 0 on success, -1 on failure (see errno)
+**/
+int realtime_pin_cpu(int cpu);
+
+/**
+    @brief Apply real-time profile to the calling thread
+    @param rt Real-time parameters (nothing is done if rt.apply is 0)
+    @param pin Pin the thread to rt.cpu (pipeline stages pin themselves)
+    @return 0 if every requested step succeeded, -1 otherwise (failures are printed to stderr)
+**/
+int realtime_enter(const Realtime *rt, bool pin);
+
+/**
+    @brief Unlock memory locked by realtime_enter()
+    @param rt Real-time parameters
+**/
+void realtime_leave(const Realtime *rt);
+
+#endif
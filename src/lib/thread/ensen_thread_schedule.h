@@ -0,0 +1,50 @@
+#ifndef ENSEN_THREAD_SCHEDULE_H
+#define ENSEN_THREAD_SCHEDULE_H
+
+#ifndef ENSEN_PRIVATE_H
+    #include "ensen_private.h"
+#endif
+
+/*
+ * Frame clock: frames are started at absolute deadlines t0 + k * period,
+ * so the period does not depend on the work done in a frame. The state
+ * is kept by value: no memory is allocated.
+ */
+typedef struct _schedule Schedule;
+struct _schedule
+{
+    int64_t         deadline;   /* start of the next frame (CLOCK_MONOTONIC, nsec) */
+    int64_t         period;     /* nsec */
+    uint32_t        missed;     /* deadlines passed before the wait */
+    double          wake;       /* time of the last wakeup (sec.) */
+
+    /* deviation of the measured period from the nominal one (Welford, sec.) */
+    uint64_t        n_periods;
+    data_t          jitter_mean;
+    data_t          jitter_m2;
+    data_t          jitter_max;  /* maximal absolute deviation */
+};
+
+/**
+    @brief Start frame clock (the first deadline is one period from now)
+    @param s Schedule
+    @param frequency Frames per second (> 0)
+**/
+void schedule_init(Schedule *s, data_t frequency);
+
+/**
+    @brief Sleep until the deadline of the next frame
+    @param s Schedule
+    @return 0 if the deadline is met, -1 if it has passed (the missed
+            periods are counted and skipped, the clock keeps its phase)
+**/
+int schedule_wait(Schedule *s);
+
+/**
+    @brief Period jitter
+    @param s Schedule
+    @return Standard deviation of the measured period (sec.), the mean offset from the nominal one is in jitter_mean
+**/
+data_t schedule_jitter(const Schedule *s);
+
+#endif
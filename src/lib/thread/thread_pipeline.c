@@ -0,0 +1,196 @@
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+
+#include "ensen_private.h"
+#include "ensen_thread_pipeline.h"
+#include "ensen_thread_queue.h"
+#include "mem/ensen_mem_guarded.h"
+#include "mem/atomic_ops.h"
+
+/* Yields of an idle stage before it starts to sleep */
+#define PIPELINE_SPINS 64
+/* Sleep of an idle stage (nsec) */
+#define PIPELINE_SLEEP 50000
+
+typedef struct _pipeline_slot Pipeline_Slot;
+struct _pipeline_slot
+{
+    void     * frame;
+    uint32_t   number;
+};
+
+typedef struct _pipeline_worker Pipeline_Worker;
+struct _pipeline_worker
+{
+    Pipeline * pl;
+    index_t    stage;
+    pthread_t  thread;
+};
+
+struct _pipeline
+{
+    index_t           n_stages;
+    Pipeline_Stage  * stage;
+    void           ** data;
+    index_t           n_frames;
+    Pipeline_Slot   * slot;
+    Thread_Queue   ** queue;     /* input of every stage, queue[0] holds free buffers */
+    Pipeline_Worker * worker;    /* stages 0 .. n_stages - 2 */
+    uint32_t        * done;      /* stage finished the run (atomic) */
+
+    /* current run */
+    uint32_t          n_total;   /* frames to produce */
+    uint32_t          stop;      /* a stage failed (atomic) */
+    uint32_t          finished;  /* frames finished by the last stage */
+};
+
+Pipeline *
+pipeline_new(index_t n_stages, const Pipeline_Stage *stage, void *const *data, void *const *frame, index_t n_frames)
+{
+    if ((n_stages == 0) || (n_frames == 0)) return NULL;
+
+    Pipeline *pl = MEM_callocN(sizeof(Pipeline), "pipeline_new: pipeline");
+
+    pl->n_stages = n_stages;
+    pl->n_frames = n_frames;
+    pl->stage    = MEM_malloc_arrayN(n_stages, sizeof(Pipeline_Stage), "pipeline_new: stage");
+    pl->data     = MEM_malloc_arrayN(n_stages, sizeof(void *), "pipeline_new: data");
+    pl->queue    = MEM_malloc_arrayN(n_stages, sizeof(Thread_Queue *), "pipeline_new: queue");
+    pl->done     = MEM_calloc_arrayN(n_stages, sizeof(uint32_t), "pipeline_new: done");
+    pl->slot     = MEM_malloc_arrayN(n_frames, sizeof(Pipeline_Slot), "pipeline_new: slot");
+    pl->worker   = MEM_calloc_arrayN(n_stages, sizeof(Pipeline_Worker), "pipeline_new: worker");
+
+    for (index_t i = 0; i < n_stages; i++)
+    {
+        pl->stage[i] = stage[i];
+        pl->data[i]  = data[i];
+        /* every queue can hold all frames: push never fails */
+        pl->queue[i] = thread_queue_new(n_frames);
+    }
+    for (index_t i = 0; i < n_frames; i++)
+    {
+        pl->slot[i].frame  = frame[i];
+        pl->slot[i].number = 0;
+    }
+
+    return pl;
+}
+
+void
+pipeline_free(Pipeline *pl)
+{
+    if (pl == NULL) return;
+
+    for (index_t i = 0; i < pl->n_stages; i++) thread_queue_free(pl->queue[i]);
+    MEM_freeN(pl->stage);
+    MEM_freeN(pl->data);
+    MEM_freeN(pl->queue);
+    MEM_freeN(pl->done);
+    MEM_freeN(pl->slot);
+    MEM_freeN(pl->worker);
+    MEM_freeN(pl);
+}
+
+/* Idle stage: give the processor away, sleep if the wait is long */
+static void
+_pipeline_wait(uint32_t *spins)
+{
+    if (++(*spins) < PIPELINE_SPINS)
+    {
+        sched_yield();
+    }
+    else
+    {
+        struct timespec ts = { 0, PIPELINE_SLEEP };
+        nanosleep(&ts, NULL);
+    }
+}
+
+static void
+_pipeline_stage(Pipeline *pl, index_t s)
+{
+    Thread_Queue *in  = pl->queue[s];
+    Thread_Queue *out = pl->queue[(s + 1) % pl->n_stages];
+    const bool first = (s == 0);
+    const bool last  = (s == pl->n_stages - 1);
+    uint32_t number = 0, spins = 0;
+
+    for (;;)
+    {
+        if (first && (number == pl->n_total)) break;
+        if (atomic_load_uint32(&pl->stop)) break;
+
+        Pipeline_Slot *slot = thread_queue_pop(in);
+        if (slot == NULL)
+        {
+            /* the previous stage may have pushed its last frame just before it finished */
+            if (!first && atomic_load_uint32(&pl->done[s - 1]))
+            {
+                if ((slot = thread_queue_pop(in)) == NULL) break;
+            }
+            else
+            {
+                _pipeline_wait(&spins);
+                continue;
+            }
+        }
+        spins = 0;
+
+        if (first) slot->number = number++;
+        if (pl->stage[s](slot->frame, slot->number, pl->data[s]) != 0)
+        {
+            atomic_store_uint32(&pl->stop, 1);
+            break;
+        }
+        if (last) pl->finished++;
+
+        thread_queue_push(out, slot);
+    }
+
+    atomic_store_uint32(&pl->done[s], 1);
+}
+
+static void *
+_pipeline_main(void *arg)
+{
+    Pipeline_Worker *w = arg;
+    _pipeline_stage(w->pl, w->stage);
+    return NULL;
+}
+
+uint32_t
+pipeline_run(Pipeline *pl, uint32_t n_frames)
+{
+    index_t i, n_started;
+
+    /* no thread is running: queues are reset by the caller */
+    for (i = 0; i < pl->n_stages; i++)
+    {
+        while (thread_queue_pop(pl->queue[i]) != NULL) {}
+        pl->done[i] = 0;
+    }
+    for (i = 0; i < pl->n_frames; i++) thread_queue_push(pl->queue[0], &pl->slot[i]);
+
+    pl->n_total  = n_frames;
+    pl->stop     = 0;
+    pl->finished = 0;
+
+    for (n_started = 0; n_started < pl->n_stages - 1; n_started++)
+    {
+        Pipeline_Worker *w = &pl->worker[n_started];
+        w->pl = pl;
+        w->stage = n_started;
+        if (pthread_create(&w->thread, NULL, _pipeline_main, w) != 0)
+        {
+            atomic_store_uint32(&pl->stop, 1);
+            break;
+        }
+    }
+
+    if (n_started == pl->n_stages - 1) _pipeline_stage(pl, pl->n_stages - 1);
+
+    for (i = 0; i < n_started; i++) pthread_join(pl->worker[i].thread, NULL);
+
+    return pl->finished;
+}
@@ -0,0 +1,156 @@
+#include <pthread.h>
+#include <unistd.h>
+
+#include "ensen_private.h"
+#include "ensen_thread_pool.h"
+#include "mem/ensen_mem_guarded.h"
+#include "mem/atomic_ops.h"
+
+typedef struct _thread_worker Thread_Worker;
+struct _thread_worker
+{
+    Thread_Pool * pool;
+    index_t       index;
+    pthread_t     thread;
+};
+
+struct _thread_pool
+{
+    index_t         n_workers;
+    Thread_Worker * worker;      /* n_workers - 1 threads (worker 0 is the caller) */
+
+    pthread_mutex_t lock;
+    pthread_cond_t  start;       /* new run or stop */
+    pthread_cond_t  done;        /* all workers finished the run */
+    uint32_t        generation;  /* number of runs */
+    index_t         n_busy;      /* threads which did not finish the run */
+    bool            stop;
+
+    /* current run */
+    Thread_Task     task;
+    void          * data;
+    uint32_t        n_tasks;
+    uint32_t        next;        /* next task index (atomic) */
+};
+
+index_t
+thread_count(void)
+{
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    if (n < 1) return 1;
+    return (n > UINT16_MAX) ? UINT16_MAX : (index_t)n;
+}
+
+/* Take tasks until the counter runs out */
+static void
+_thread_pool_work(Thread_Pool *pool, index_t worker)
+{
+    uint32_t t;
+    while ((t = atomic_fetch_and_add_uint32(&pool->next, 1)) < pool->n_tasks)
+    {
+        pool->task(pool->data, t, worker);
+    }
+}
+
+static void *
+_thread_pool_main(void *arg)
+{
+    Thread_Worker *w = arg;
+    Thread_Pool *pool = w->pool;
+    uint32_t generation = 0;
+
+    pthread_mutex_lock(&pool->lock);
+    for (;;)
+    {
+        while (!pool->stop && (pool->generation == generation)) pthread_cond_wait(&pool->start, &pool->lock);
+        if (pool->stop) break;
+        generation = pool->generation;
+        pthread_mutex_unlock(&pool->lock);
+
+        _thread_pool_work(pool, w->index);
+
+        pthread_mutex_lock(&pool->lock);
+        if (--pool->n_busy == 0) pthread_cond_signal(&pool->done);
+    }
+    pthread_mutex_unlock(&pool->lock);
+    return NULL;
+}
+
+Thread_Pool *
+thread_pool_new(index_t n_workers)
+{
+    Thread_Pool *pool = MEM_callocN(sizeof(Thread_Pool), "thread_pool_new: pool");
+
+    pool->n_workers = (n_workers > 0) ? n_workers : thread_count();
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->start, NULL);
+    pthread_cond_init(&pool->done, NULL);
+
+    if (pool->n_workers > 1)
+    {
+        pool->worker = MEM_calloc_arrayN(pool->n_workers - 1, sizeof(Thread_Worker), "thread_pool_new: worker");
+    }
+
+    for (index_t i = 1; i < pool->n_workers; i++)
+    {
+        Thread_Worker *w = &pool->worker[i - 1];
+        w->pool = pool;
+        w->index = i;
+        if (pthread_create(&w->thread, NULL, _thread_pool_main, w) != 0)
+        {
+            /* run with the threads started so far */
+            pool->n_workers = i;
+            break;
+        }
+    }
+
+    return pool;
+}
+
+void
+thread_pool_free(Thread_Pool *pool)
+{
+    if (pool == NULL) return;
+
+    pthread_mutex_lock(&pool->lock);
+    pool->stop = true;
+    pthread_cond_broadcast(&pool->start);
+    pthread_mutex_unlock(&pool->lock);
+
+    for (index_t i = 1; i < pool->n_workers; i++) pthread_join(pool->worker[i - 1].thread, NULL);
+
+    pthread_cond_destroy(&pool->done);
+    pthread_cond_destroy(&pool->start);
+    pthread_mutex_destroy(&pool->lock);
+
+    if (pool->worker != NULL) MEM_freeN(pool->worker);
+    MEM_freeN(pool);
+}
+
+index_t
+thread_pool_size(const Thread_Pool *pool)
+{
+    return pool->n_workers;
+}
+
+void
+thread_pool_run(Thread_Pool *pool, uint32_t n_tasks, Thread_Task task, void *data)
+{
+    if (n_tasks == 0) return;
+
+    pthread_mutex_lock(&pool->lock);
+    pool->task    = task;
+    pool->data    = data;
+    pool->n_tasks = n_tasks;
+    pool->next    = 0;
+    pool->n_busy  = pool->n_workers - 1;
+    pool->generation++;
+    pthread_cond_broadcast(&pool->start);
+    pthread_mutex_unlock(&pool->lock);
+
+    _thread_pool_work(pool, 0);
+
+    pthread_mutex_lock(&pool->lock);
+    while (pool->n_busy > 0) pthread_cond_wait(&pool->done, &pool->lock);
+    pthread_mutex_unlock(&pool->lock);
+}
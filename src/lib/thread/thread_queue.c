@@ -0,0 +1,64 @@
+#include "ensen_private.h"
+#include "ensen_thread_queue.h"
+#include "mem/ensen_mem_guarded.h"
+#include "mem/atomic_ops.h"
+
+/* Head and tail are kept apart to avoid false sharing */
+#define THREAD_CACHE_LINE 64
+
+struct _thread_queue
+{
+    uint32_t   mask;
+    void    ** item;
+    char       pad_0[THREAD_CACHE_LINE];
+    uint32_t   tail;    /* next item to write (producer) */
+    char       pad_1[THREAD_CACHE_LINE];
+    uint32_t   head;    /* next item to read (consumer) */
+    char       pad_2[THREAD_CACHE_LINE];
+};
+
+Thread_Queue *
+thread_queue_new(uint32_t capacity)
+{
+    Thread_Queue *q = MEM_callocN(sizeof(Thread_Queue), "thread_queue_new: queue");
+
+    uint32_t n = 1;
+    while (n < capacity) n <<= 1;
+
+    q->mask = n - 1;
+    q->item = MEM_calloc_arrayN(n, sizeof(void *), "thread_queue_new: item");
+    return q;
+}
+
+void
+thread_queue_free(Thread_Queue *q)
+{
+    if (q == NULL) return;
+    MEM_freeN(q->item);
+    MEM_freeN(q);
+}
+
+int
+thread_queue_push(Thread_Queue *q, void *item)
+{
+    const uint32_t tail = q->tail;
+
+    /* counters run freely, their difference is the number of items */
+    if (tail - atomic_load_uint32(&q->head) > q->mask) return -1;
+
+    q->item[tail & q->mask] = item;
+    atomic_store_uint32(&q->tail, tail + 1);
+    return 0;
+}
+
+void *
+thread_queue_pop(Thread_Queue *q)
+{
+    const uint32_t head = q->head;
+
+    if (head == atomic_load_uint32(&q->tail)) return NULL;
+
+    void *item = q->item[head & q->mask];
+    atomic_store_uint32(&q->head, head + 1);
+    return item;
+}
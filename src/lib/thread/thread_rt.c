@@ -0,0 +1,95 @@
+#define _GNU_SOURCE /* CPU_SET(), pthread_setaffinity_np() */
+
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+
+#include "ensen_private.h"
+#include "ensen_thread_rt.h"
+
+/* Touch the stack, so its pages are mapped (and locked) before the frame loop */
+static void
+_realtime_prefault_stack(void)
+{
+    volatile unsigned char stack[REALTIME_STACK_PREFAULT];
+    for (size_t i = 0; i < sizeof(stack); i += 4096) stack[i] = 0;
+}
+
+int
+realtime_lock_memory(void)
+{
+    if (mlockall(MCL_CURRENT | MCL_FUTURE) != 0) return -1;
+    _realtime_prefault_stack();
+    return 0;
+}
+
+int
+realtime_set_priority(index_t priority)
+{
+    if (priority == 0) return 0;
+
+    struct sched_param param;
+    memset(&param, 0, sizeof(param));
+    param.sched_priority = priority;
+
+    const int err = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+    if (err != 0)
+    {
+        errno = err;
+        return -1;
+    }
+    return 0;
+}
+
+int
+realtime_pin_cpu(int cpu)
+{
+    if (cpu < 0) return 0;
+
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+
+    const int err = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    if (err != 0)
+    {
+        errno = err;
+        return -1;
+    }
+    return 0;
+}
+
+int
+realtime_enter(const Realtime *rt, bool pin)
+{
+    int ret = 0;
+
+    if (!(*rt).apply) return 0;
+
+    if (realtime_lock_memory() != 0)
+    {
+        fprintf(stderr, "realtime: cannot lock memory: %s\n", strerror(errno));
+        ret = -1;
+    }
+    if (realtime_set_priority((*rt).priority) != 0)
+    {
+        fprintf(stderr, "realtime: cannot set SCHED_FIFO priority %d: %s\n", (*rt).priority, strerror(errno));
+        ret = -1;
+    }
+    if (pin && (realtime_pin_cpu((*rt).cpu) != 0))
+    {
+        fprintf(stderr, "realtime: cannot pin thread to CPU %d: %s\n", (*rt).cpu, strerror(errno));
+        ret = -1;
+    }
+
+    return ret;
+}
+
+void
+realtime_leave(const Realtime *rt)
+{
+    if ((*rt).apply) munlockall();
+}
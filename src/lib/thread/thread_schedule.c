@@ -0,0 +1,70 @@
+#include <errno.h>
+#include <math.h>
+#include <time.h>
+
+#include "ensen_private.h"
+#include "ensen_thread_schedule.h"
+
+#define NSEC_PER_SEC 1000000000LL
+
+static inline int64_t
+_schedule_now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * NSEC_PER_SEC + ts.tv_nsec;
+}
+
+void
+schedule_init(Schedule *s, data_t frequency)
+{
+    s->period      = (frequency > 0) ? (int64_t)(NSEC_PER_SEC / frequency) : 0;
+    s->missed      = 0;
+    s->n_periods   = 0;
+    s->jitter_mean = s->jitter_m2 = s->jitter_max = 0;
+
+    const int64_t now = _schedule_now();
+    s->wake     = now * 1e-9;
+    s->deadline = now + s->period;
+}
+
+int
+schedule_wait(Schedule *s)
+{
+    int ret = 0;
+    const int64_t now = _schedule_now();
+
+    if (now > s->deadline)
+    {
+        /* overrun: skip the passed deadlines */
+        const int64_t skip = (s->period > 0) ? (now - s->deadline) / s->period + 1 : 0;
+        s->missed += (uint32_t)skip;
+        s->deadline += skip * s->period;
+        ret = -1;
+    }
+
+    struct timespec ts = { s->deadline / NSEC_PER_SEC, s->deadline % NSEC_PER_SEC };
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR) {}
+
+    /* measured period, an overrun is not a jitter of the clock */
+    const double wake = _schedule_now() * 1e-9;
+    if (ret == 0)
+    {
+        const data_t d = (wake - s->wake) - s->period * 1e-9;
+        const data_t delta = d - s->jitter_mean;
+        s->n_periods++;
+        s->jitter_mean += delta / s->n_periods;
+        s->jitter_m2 += delta * (d - s->jitter_mean);
+        if (fabs(d) > s->jitter_max) s->jitter_max = fabs(d);
+    }
+    s->wake = wake;
+
+    s->deadline += s->period;
+    return ret;
+}
+
+data_t
+schedule_jitter(const Schedule *s)
+{
+    return (s->n_periods > 0) ? sqrt(s->jitter_m2 / s->n_periods) : 0;
+}
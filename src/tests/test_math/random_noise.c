@@ -17,7 +17,7 @@ DIMMUS_START_TEST (noise_color_test_white_rnd)
     init_rnd();
     data_t wn1 = genWhiteNoise();
     data_t wn2 = genWhiteNoise();
-    if (wn1 - wn2 <= 1.0e-14) /* solved warning: comparing floating-point with ‘==’ or ‘!=’ is unsafe */
+    if (fabs(wn1 - wn2) <= 1.0e-14) /* solved warning: comparing floating-point with ‘==’ or ‘!=’ is unsafe */
     {
         ck_abort_msg("genWhiteNoise failure: generated two equal values (not a random)");
     }
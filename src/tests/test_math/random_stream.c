@@ -0,0 +1,80 @@
+#include <math.h>
+
+#include "test_math.h"
+#include "math/random/ensen_math_random.h"
+#include "math/random/ensen_math_random_noise.h"
+
+#define N_SAMPLES 100000
+
+DIMMUS_START_TEST (random_stream_test_sequence)
+{
+    Random_Stream a, b, c;
+
+    /* the same seed and stream repeat the sequence */
+    random_stream_init(&a, 1, 7);
+    random_stream_init(&b, 1, 7);
+    random_stream_init(&c, 1, 8);
+    index_t same = 0;
+    for (index_t i = 0; i < 1000; i++)
+    {
+        const uint64_t x = random_stream_next(&a);
+        ck_assert(x == random_stream_next(&b));
+        if (x == random_stream_next(&c)) same++;
+    }
+    ck_assert_int_eq(same, 0);
+
+    /* neighbour streams do not correlate */
+    random_stream_init(&a, 1, 0);
+    random_stream_init(&b, 1, 1);
+    data_t sum_ab = 0, sum_a = 0, sum_aa = 0;
+    for (uint32_t i = 0; i < N_SAMPLES; i++)
+    {
+        const data_t u = random_stream_pm_one(&a), v = random_stream_pm_one(&b);
+        ck_assert((u >= -1.0) && (u < 1.0));
+        sum_a += u;
+        sum_aa += u * u;
+        sum_ab += u * v;
+    }
+    ck_assert_double_eq_tol(sum_a / N_SAMPLES, 0.0, 0.01);
+    ck_assert_double_eq_tol(sum_aa / N_SAMPLES, 1.0 / 3.0, 0.01);
+    ck_assert_double_eq_tol(sum_ab / N_SAMPLES, 0.0, 0.01);
+}
+DIMMUS_END_TEST
+
+DIMMUS_START_TEST (random_stream_test_noise)
+{
+    Random_Stream rs;
+    const index_t colors[] = { NOISE_RANDOM, NOISE_WHITE, NOISE_BROWN, NOISE_VIOLET };
+    data_t lag[4];
+
+    for (index_t k = 0; k < 4; k++)
+    {
+        random_stream_init(&rs, 2, k);
+        data_t state = random_stream_noise_start(&rs, colors[k]);
+        data_t prev = 0, sum = 0, sum2 = 0, sum_lag = 0;
+        for (uint32_t i = 0; i < N_SAMPLES; i++)
+        {
+            const data_t x = random_stream_noise(&rs, colors[k], &state);
+            sum += x;
+            sum2 += x * x;
+            sum_lag += x * prev;
+            prev = x;
+        }
+        /* the same power for all colors */
+        ck_assert_double_eq_tol(sum2 / N_SAMPLES, 1.0 / 3.0, 0.03);
+        lag[k] = sum_lag / sum2;
+    }
+
+    /* correlation of neighbour values: none, positive (brown), negative (violet) */
+    ck_assert_double_eq_tol(lag[0], 0.0, 0.02);
+    ck_assert_double_eq_tol(lag[1], 0.0, 0.02);
+    ck_assert(lag[2] > 0.9);
+    ck_assert_double_eq_tol(lag[3], -0.5, 0.02);
+}
+DIMMUS_END_TEST
+
+void random_stream_test(TCase *tc)
+{
+    tcase_add_test(tc, random_stream_test_sequence);
+    tcase_add_test(tc, random_stream_test_noise);
+}
@@ -4,6 +4,7 @@
 
 static const Dimmus_Test_Case etc[] = {
   { "Noise color", random_noise_test },
+  { "Random streams", random_stream_test },
   { NULL, NULL }
 };
 
@@ -6,3 +6,4 @@
 #include "ensen_private.h"
 
 void random_noise_test(TCase *tc);
+void random_stream_test(TCase *tc);
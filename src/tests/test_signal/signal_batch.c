@@ -0,0 +1,133 @@
+#include "test_signal.h"
+#include "signal/ensen_signal.h"
+
+#define N_POINTS 2000
+#define N_FRAMES 37
+#define N_WORKERS_MAX 5
+
+static void
+_signal_batch_frames(data_t (*y)[N_POINTS], data_t **frame)
+{
+    for (uint32_t f = 0; f < N_FRAMES; f++)
+    {
+        for (index_t i = 0; i < N_POINTS; i++)
+        {
+            y[f][i] = gaussian(i, 300.0 + 7 * f, 60.0) + 0.7 * gaussian(i, 1400.0 - 11 * f, 60.0)
+                    + 0.05 * sin(1.3 * i + f);
+        }
+        frame[f] = y[f];
+    }
+}
+
+DIMMUS_START_TEST (signal_batch_test_deterministic)
+{
+    static data_t y[N_FRAMES][N_POINTS], ref[N_POINTS], scratch[N_WORKERS_MAX * N_POINTS];
+    static Peak peak[2][N_FRAMES][10];
+    data_t *frame[N_FRAMES];
+    const Signal_Parameters *confs[N_FRAMES];
+    Peaks peaks[2][N_FRAMES];
+    Signal_Parameters conf;
+
+    conf.n_points = N_POINTS;
+    conf.smooth.width = 40;
+    conf.smooth.level = 3;
+    conf.search.threshold_amp = 0.35;
+    conf.search.threshold_slope = 0.000001;
+    conf.search.peaks_array_number = 10;
+
+    for (uint32_t f = 0; f < N_FRAMES; f++)
+    {
+        confs[f] = &conf;
+        peaks[0][f].peak = peak[0][f];
+        peaks[1][f].peak = peak[1][f];
+    }
+
+    /* one worker and many workers give the same result */
+    index_t workers[2] = { 1, N_WORKERS_MAX };
+    for (index_t r = 0; r < 2; r++)
+    {
+        Thread_Pool *pool = thread_pool_new(workers[r]);
+        ck_assert_int_eq(thread_pool_size(pool), workers[r]);
+
+        _signal_batch_frames(y, frame);
+        Peak_Batch batch = { N_FRAMES, frame, confs, peaks[r], NULL, scratch };
+        findpeaks_batch(pool, &batch);
+        thread_pool_free(pool);
+    }
+
+    for (uint32_t f = 0; f < N_FRAMES; f++)
+    {
+        ck_assert_int_eq(peaks[0][f].total_number, 2);
+        ck_assert_int_eq(peaks[1][f].total_number, 2);
+        ck_assert_int_eq(memcmp(peak[0][f], peak[1][f], 2 * sizeof(Peak)), 0);
+    }
+
+    /* the same as the sequential smooth() and findpeaks() */
+    Peak peak_ref[10];
+    Peaks p = { peak_ref, 0 };
+    _signal_batch_frames(y, frame);
+    memcpy(ref, y[N_FRAMES - 1], sizeof(ref));
+    for (index_t l = 0; l < conf.smooth.level; l++) smooth(ref, N_POINTS, conf.smooth.width);
+    findpeaks(ref, &p, &conf);
+    ck_assert_int_eq(p.total_number, 2);
+    ck_assert_double_eq_tol(p.peak[0].position, peaks[1][N_FRAMES - 1].peak[0].position, 1e-12);
+    ck_assert_double_eq_tol(p.peak[1].position, peaks[1][N_FRAMES - 1].peak[1].position, 1e-12);
+}
+DIMMUS_END_TEST
+
+DIMMUS_START_TEST (signal_batch_test_source)
+{
+    static data_t y[N_FRAMES][N_POINTS], out[N_FRAMES][N_POINTS], copy[N_POINTS], scratch[N_WORKERS_MAX * N_POINTS];
+    static Peak peak[2][N_FRAMES][10];
+    data_t *frame[N_FRAMES], *result[N_FRAMES];
+    const data_t *source[N_FRAMES];
+    const Signal_Parameters *confs[N_FRAMES];
+    Peaks peaks[2][N_FRAMES];
+    Signal_Parameters conf;
+
+    conf.n_points = N_POINTS;
+    conf.smooth.width = 40;
+    conf.search.threshold_amp = 0.35;
+    conf.search.threshold_slope = 0.000001;
+    conf.search.peaks_array_number = 10;
+
+    for (uint32_t f = 0; f < N_FRAMES; f++)
+    {
+        confs[f] = &conf;
+        result[f] = out[f];
+        peaks[0][f].peak = peak[0][f];
+        peaks[1][f].peak = peak[1][f];
+    }
+
+    /* smoothing from read only frames gives the same result as in place (odd and even number of passes) */
+    Thread_Pool *pool = thread_pool_new(3);
+    for (index_t level = 0; level <= 3; level++)
+    {
+        conf.smooth.level = level;
+
+        _signal_batch_frames(y, frame);
+        for (uint32_t f = 0; f < N_FRAMES; f++) source[f] = y[f];
+        memcpy(copy, y[N_FRAMES - 1], sizeof(copy));
+        Peak_Batch from_source = { N_FRAMES, result, confs, peaks[1], source, scratch };
+        findpeaks_batch(pool, &from_source);
+        ck_assert_int_eq(memcmp(copy, y[N_FRAMES - 1], sizeof(copy)), 0);
+
+        Peak_Batch in_place = { N_FRAMES, frame, confs, peaks[0], NULL, scratch };
+        findpeaks_batch(pool, &in_place);
+
+        for (uint32_t f = 0; f < N_FRAMES; f++)
+        {
+            ck_assert_int_eq(memcmp(out[f], y[f], sizeof(copy)), 0);
+            ck_assert_int_eq(peaks[0][f].total_number, peaks[1][f].total_number);
+            ck_assert_int_eq(memcmp(peak[0][f], peak[1][f], peaks[0][f].total_number * sizeof(Peak)), 0);
+        }
+    }
+    thread_pool_free(pool);
+}
+DIMMUS_END_TEST
+
+void signal_batch_test(TCase *tc)
+{
+   tcase_add_test(tc, signal_batch_test_deterministic);
+   tcase_add_test(tc, signal_batch_test_source);
+}
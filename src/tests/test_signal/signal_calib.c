@@ -0,0 +1,134 @@
+#include "test_signal.h"
+#include "signal/ensen_signal.h"
+
+/* odd, so the scalar tail of the vector loop is run */
+#define N_SENSORS 5
+
+DIMMUS_START_TEST (signal_calib_test_polynomial)
+{
+    data_t shift[N_SENSORS] = { -2.0, -0.5, 0.0, 0.75, 3.0 };
+    data_t t[N_SENSORS];
+
+    ck_assert(calibration_new(0, 20, 0.02) == NULL);
+    ck_assert(calibration_new(N_SENSORS, 20, 0) == NULL);
+
+    /* linear: temperature + shift / coefficient */
+    Calibration *c = calibration_new(N_SENSORS, 20, 0.02);
+    ck_assert_int_eq(c->order, 1);
+    calibration_eval(c, shift, t);
+    for (index_t s = 0; s < N_SENSORS; s++) ck_assert_double_eq_tol(t[s], 20 + shift[s] / 0.02, 1e-9);
+
+    /* polynomials of different orders, the others stay linear */
+    const data_t cubic[4] = { 20, 48, -1.5, 0.25 };
+    const data_t full[CALIB_ORDER_MAX + 1] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+    const data_t constant = 300;
+    ck_assert_int_eq(calibration_set_polynomial(c, 1, cubic, 4), 0);
+    ck_assert_int_eq(c->order, 3);
+    ck_assert_int_eq(calibration_set_polynomial(c, 4, full, CALIB_ORDER_MAX + 1), 0);
+    ck_assert_int_eq(c->order, CALIB_ORDER_MAX);
+    ck_assert_int_eq(calibration_set_polynomial(c, 2, &constant, 1), 0);
+    calibration_eval(c, shift, t);
+
+    data_t x = shift[1];
+    ck_assert_double_eq_tol(t[1], 20 + 48 * x - 1.5 * x * x + 0.25 * x * x * x, 1e-9);
+    x = shift[4];
+    data_t ref = 0;
+    for (index_t k = 0; k <= CALIB_ORDER_MAX; k++) ref += full[k] * pow(x, k);
+    ck_assert_double_eq_tol(t[4], ref, 1e-9 * ref);
+    ck_assert_double_eq_tol(t[2], 300, 1e-12);
+    ck_assert_double_eq_tol(t[0], 20 + shift[0] / 0.02, 1e-9);
+    ck_assert_double_eq_tol(t[3], 20 + shift[3] / 0.02, 1e-9);
+
+    /* the order drops with the highest polynomial */
+    ck_assert_int_eq(calibration_set_polynomial(c, 4, cubic, 2), 0);
+    ck_assert_int_eq(c->order, 3);
+
+    ck_assert_int_eq(calibration_set_polynomial(c, N_SENSORS, cubic, 2), -1);
+    ck_assert_int_eq(calibration_set_polynomial(c, 0, cubic, 0), -1);
+    ck_assert_int_eq(calibration_set_polynomial(c, 0, full, CALIB_ORDER_MAX + 2), -1);
+
+    calibration_free(c);
+}
+DIMMUS_END_TEST
+
+DIMMUS_START_TEST (signal_calib_test_table)
+{
+    const data_t knot[4] = { -1, 0, 1, 3 };
+    const data_t temperature[4] = { -40, 20, 70, 150 };
+    const data_t wrong[3] = { 0, 1, 1 };
+    data_t shift[N_SENSORS], t[N_SENSORS];
+
+    Calibration *c = calibration_new(N_SENSORS, 20, 0.02);
+    ck_assert_int_eq(calibration_set_table(c, 0, wrong, temperature, 3), -1);
+    ck_assert_int_eq(calibration_set_table(c, 0, knot, temperature, 1), -1);
+    ck_assert_int_eq(calibration_set_table(c, N_SENSORS, knot, temperature, 4), -1);
+    ck_assert_int_eq(c->n_tables, 0);
+
+    for (index_t s = 0; s < N_SENSORS; s++)
+    {
+        ck_assert_int_eq(calibration_set_table(c, s, knot, temperature, 4), 0);
+    }
+    ck_assert_int_eq(c->n_tables, N_SENSORS);
+    ck_assert_int_eq(c->order, 0);
+
+    /* knots, inside of segments and the extended end segments */
+    const data_t x[N_SENSORS] = { -3, 0, 0.5, 2, 4 };
+    const data_t ref[N_SENSORS] = { -160, 20, 45, 110, 190 };
+    for (index_t s = 0; s < N_SENSORS; s++) shift[s] = x[s];
+    calibration_eval(c, shift, t);
+    for (index_t s = 0; s < N_SENSORS; s++) ck_assert_double_eq_tol(t[s], ref[s], 1e-9);
+
+    /* a polynomial replaces the table of sensor */
+    const data_t linear[2] = { 0, 1 };
+    ck_assert_int_eq(calibration_set_polynomial(c, 2, linear, 2), 0);
+    ck_assert_int_eq(c->n_tables, N_SENSORS - 1);
+    calibration_eval(c, shift, t);
+    ck_assert_double_eq_tol(t[2], 0.5, 1e-12);
+    ck_assert_double_eq_tol(t[3], 110, 1e-9);
+
+    calibration_free(c);
+}
+DIMMUS_END_TEST
+
+DIMMUS_START_TEST (signal_calib_test_bank)
+{
+    Sensor_Bank bank;
+    Grid grid;
+    Peak peak[N_SENSORS];
+    Peaks p = { peak, N_SENSORS };
+    const data_t quadratic[3] = { 20, 4, 0.5 };
+
+    ck_assert_int_eq(sensor_bank_init(&bank, N_SENSORS, 4, 20), 0);
+    grid_uniform_set(&grid, 0, 2000, 4000);
+
+    Calibration *c = calibration_new(N_SENSORS, 20, 0.25);
+    ck_assert_int_eq(calibration_set_polynomial(c, 0, quadratic, 3), 0);
+    Calibration *other = calibration_new(N_SENSORS + 1, 20, 0.25);
+    ck_assert_int_eq(sensor_bank_calibrate(&bank, other), -1);
+    ck_assert_int_eq(sensor_bank_calibrate(&bank, c), 0);
+
+    /* temperature is that of the shift from the first frame */
+    for (index_t f = 0; f < 4; f++)
+    {
+        for (index_t s = 0; s < N_SENSORS; s++) peak[s].position = 100 * s + 3 * f;
+        sensor_bank_update(&bank, &p, &grid, 0.25);
+    }
+    for (index_t s = 0; s < N_SENSORS; s++)
+    {
+        const data_t d = grid_ind2val(&grid, 100 * s + 9) - grid_ind2val(&grid, 100 * s);
+        const data_t ref = (s == 0) ? 20 + 4 * d + 0.5 * d * d : 20 + d / 0.25;
+        ck_assert_double_eq_tol(bank.temperature[s], ref, 1e-9);
+    }
+
+    sensor_bank_free(&bank);
+    calibration_free(c);
+    calibration_free(other);
+}
+DIMMUS_END_TEST
+
+void signal_calib_test(TCase *tc)
+{
+   tcase_add_test(tc, signal_calib_test_polynomial);
+   tcase_add_test(tc, signal_calib_test_table);
+   tcase_add_test(tc, signal_calib_test_bank);
+}
@@ -0,0 +1,146 @@
+#include <stdio.h>
+
+#include "test_signal.h"
+#include "io/ensen_io_capture.h"
+#include "signal/ensen_signal_grid.h"
+#include "mem/ensen_mem_guarded.h"
+
+#define N_POINTS 100
+#define CAPTURE_FILE TESTS_BUILD_DIR "/capture.bin"
+
+static void
+_frame_fill(data_t *y, index_t frame)
+{
+    for (index_t i = 0; i < N_POINTS; i++) y[i] = frame + i * 0.25;
+}
+
+DIMMUS_START_TEST (signal_capture_test_float64)
+{
+    Grid grid;
+    data_t y[N_POINTS];
+    grid_uniform_set(&grid, 1500.0, 1600.0, N_POINTS);
+    remove(CAPTURE_FILE);
+
+    /* three frames, then two more appended by the next writer */
+    Capture_Writer *w = capture_writer_open(CAPTURE_FILE, &grid, CAPTURE_FLOAT64);
+    ck_assert(w != NULL);
+    for (index_t f = 0; f < 3; f++)
+    {
+        _frame_fill(y, f);
+        ck_assert_int_eq(capture_writer_append(w, y), 0);
+    }
+    ck_assert_int_eq(capture_writer_close(w), 0);
+
+    w = capture_writer_open(CAPTURE_FILE, &grid, CAPTURE_FLOAT64);
+    ck_assert(w != NULL);
+    ck_assert(capture_writer_frames(w) == 3);
+    for (index_t f = 3; f < 5; f++)
+    {
+        _frame_fill(y, f);
+        ck_assert_int_eq(capture_writer_append(w, y), 0);
+    }
+    ck_assert_int_eq(capture_writer_close(w), 0);
+
+    /* another data type cannot be appended */
+    ck_assert(capture_writer_open(CAPTURE_FILE, &grid, CAPTURE_FLOAT32) == NULL);
+
+    Capture *c = capture_open(CAPTURE_FILE);
+    ck_assert(c != NULL);
+    ck_assert(capture_frames(c) == 5);
+    ck_assert(capture_header(c)->n_frames == 5);
+
+    Grid g;
+    capture_grid(c, &g);
+    ck_assert_int_eq(g.count, N_POINTS);
+    ck_assert(g.values == NULL);
+    ck_assert_double_eq_tol(g.start, grid.start, 1e-12);
+    ck_assert_double_eq_tol(g.step, grid.step, 1e-12);
+
+    for (index_t f = 0; f < 5; f++)
+    {
+        /* frames are aligned and read without copy */
+        const data_t *frame = capture_frame(c, f, NULL);
+        ck_assert((uintptr_t)frame % CAPTURE_ALIGN == 0);
+        _frame_fill(y, f);
+        for (index_t i = 0; i < N_POINTS; i++) ck_assert_double_eq_tol(frame[i], y[i], 1e-12);
+    }
+    capture_close(c);
+    remove(CAPTURE_FILE);
+}
+DIMMUS_END_TEST
+
+DIMMUS_START_TEST (signal_capture_test_float32)
+{
+    data_t x[N_POINTS], y[N_POINTS], scratch[N_POINTS];
+    Grid grid;
+    for (index_t i = 0; i < N_POINTS; i++) x[i] = 1500.0 + i + 0.001 * i * i;
+    grid_calibrated_set(&grid, x, N_POINTS);
+    remove(CAPTURE_FILE);
+
+    Capture_Writer *w = capture_writer_open(CAPTURE_FILE, &grid, CAPTURE_FLOAT32);
+    ck_assert(w != NULL);
+    _frame_fill(y, 7);
+    ck_assert_int_eq(capture_writer_append(w, y), 0);
+    ck_assert_int_eq(capture_writer_append(w, y), 0);
+    ck_assert_int_eq(capture_writer_close(w), 0);
+
+    /* unfinished frame (the recording was interrupted) is not read */
+    FILE *f = fopen(CAPTURE_FILE, "ab");
+    ck_assert(f != NULL);
+    fwrite(y, sizeof(data_t), 3, f);
+    fclose(f);
+
+    Capture *c = capture_open(CAPTURE_FILE);
+    ck_assert(c != NULL);
+    ck_assert(capture_frames(c) == 2);
+
+    Grid g;
+    capture_grid(c, &g);
+    ck_assert(g.values != NULL);
+    for (index_t i = 0; i < N_POINTS; i++) ck_assert_double_eq_tol(g.values[i], x[i], 1e-12);
+
+    const data_t *frame = capture_frame(c, 1, scratch);
+    ck_assert(frame == scratch);
+    for (index_t i = 0; i < N_POINTS; i++) ck_assert_double_eq_tol(frame[i], y[i], 1e-5);
+    capture_close(c);
+
+    /* the next writer overwrites the unfinished frame */
+    w = capture_writer_open(CAPTURE_FILE, &grid, CAPTURE_FLOAT32);
+    ck_assert(w != NULL);
+    ck_assert(capture_writer_frames(w) == 2);
+    ck_assert_int_eq(capture_writer_append(w, y), 0);
+    ck_assert_int_eq(capture_writer_close(w), 0);
+
+    c = capture_open(CAPTURE_FILE);
+    ck_assert(c != NULL);
+    ck_assert(capture_frames(c) == 3);
+    capture_close(c);
+
+    /* more points than index_t holds (the header is consistent otherwise) */
+    Capture_Header h;
+    f = fopen(CAPTURE_FILE, "r+b");
+    ck_assert(f != NULL);
+    ck_assert(fread(&h, sizeof(h), 1, f) == 1);
+    h.n_points = UINT16_MAX + 1;
+    h.calibrated = 0;
+    h.frame_stride = (uint64_t)h.n_points * sizeof(float);
+    rewind(f);
+    fwrite(&h, sizeof(h), 1, f);
+    fclose(f);
+    ck_assert(capture_open(CAPTURE_FILE) == NULL);
+
+    /* not a capture */
+    f = fopen(CAPTURE_FILE, "wb");
+    ck_assert(f != NULL);
+    fwrite(x, sizeof(data_t), N_POINTS, f);
+    fclose(f);
+    ck_assert(capture_open(CAPTURE_FILE) == NULL);
+    remove(CAPTURE_FILE);
+}
+DIMMUS_END_TEST
+
+void signal_capture_test(TCase *tc)
+{
+   tcase_add_test(tc, signal_capture_test_float64);
+   tcase_add_test(tc, signal_capture_test_float32);
+}
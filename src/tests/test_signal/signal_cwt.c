@@ -0,0 +1,71 @@
+#include "test_signal.h"
+#include "signal/ensen_signal.h"
+
+#define N_POINTS 2000
+
+/* Reproducible uniform noise in [-amplitude, amplitude] */
+static data_t
+_signal_noise(uint32_t *state, data_t amplitude)
+{
+    *state = *state * 1664525u + 1013904223u;
+    return amplitude * (2.0 * (*state >> 8) / (1u << 24) - 1.0);
+}
+
+DIMMUS_START_TEST (signal_cwt_test_noisy)
+{
+    data_t y[N_POINTS];
+    data_t pos[4] = { 301.0, 700.0, 1203.0, 1650.0 };
+    data_t amp[4] = { 1.0, 0.8, 0.6, 0.2 };
+    data_t scales[6] = { 24, 4, 6, 8, 12, 16 };
+    uint32_t state = 1;
+    Peak peak[10];
+    Peaks peaks = { peak, 0 };
+    Signal_Parameters conf;
+
+    conf.n_points = N_POINTS;
+    conf.search.threshold_amp = 0.35;
+    conf.search.peaks_array_number = 10;
+    conf.search.cwt_snr = 3.0;
+
+    for (index_t i = 0; i < N_POINTS; i++)
+    {
+        y[i] = 0.1 + _signal_noise(&state, 0.3);
+        for (index_t j = 0; j < 4; j++) y[i] += amp[j] * gaussian(i, pos[j], 40.0);
+    }
+
+    Cwt_Plan *plan = cwt_plan_new(N_POINTS, scales, 6);
+    ck_assert_ptr_nonnull(plan);
+
+    /* the last peak is below amplitude threshold, no peaks from noise */
+    cwt_findpeaks(plan, y, &peaks, &conf);
+    ck_assert_int_eq(peaks.total_number, 3);
+    for (index_t j = 0; j < 3; j++)
+    {
+        ck_assert_double_eq_tol(peaks.peak[j].position, pos[j], 4.0);
+    }
+
+    /* plan is reused for the next frame */
+    for (index_t i = 0; i < N_POINTS; i++) y[i] = gaussian(i, 1000.0, 40.0);
+    cwt_findpeaks(plan, y, &peaks, &conf);
+    ck_assert_int_eq(peaks.total_number, 1);
+    ck_assert_double_eq_tol(peaks.peak[0].position, 1000.0, 1.0);
+
+    cwt_plan_free(plan);
+}
+DIMMUS_END_TEST
+
+DIMMUS_START_TEST (signal_cwt_test_scales)
+{
+    data_t scales[2] = { 0.5, 8 };
+
+    ck_assert_ptr_null(cwt_plan_new(N_POINTS, scales, 2));
+    ck_assert_ptr_null(cwt_plan_new(N_POINTS, scales, 0));
+    ck_assert_ptr_null(cwt_plan_new(N_POINTS, scales + 1, CWT_SCALES_MAX + 1));
+}
+DIMMUS_END_TEST
+
+void signal_cwt_test(TCase *tc)
+{
+   tcase_add_test(tc, signal_cwt_test_noisy);
+   tcase_add_test(tc, signal_cwt_test_scales);
+}
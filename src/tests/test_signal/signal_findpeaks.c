@@ -0,0 +1,78 @@
+#include "test_signal.h"
+#include "signal/ensen_signal.h"
+
+#define N_POINTS 2000
+
+static void
+_signal_peaks_generate(data_t *y, const data_t *pos, const data_t *amp, index_t n_peaks)
+{
+    for (index_t i = 0; i < N_POINTS; i++)
+    {
+        y[i] = 0.01 * sin(0.05 * i);
+        for (index_t j = 0; j < n_peaks; j++) y[i] += amp[j] * gaussian(i, pos[j], 40.0);
+    }
+}
+
+DIMMUS_START_TEST (signal_findpeaks_test_positions)
+{
+    data_t y[N_POINTS], dy[N_POINTS];
+    data_t pos[4] = { 301.0, 700.0, 1203.0, 1650.0 };
+    data_t amp[4] = { 1.0, 0.8, 0.6, 0.2 };
+    Peak peak[10];
+    Peaks peaks = { peak, 0 };
+    Signal_Parameters conf;
+
+    conf.n_points = N_POINTS;
+    conf.search.threshold_amp = 0.35;
+    conf.search.threshold_slope = 0.000001;
+    conf.search.peaks_array_number = 10;
+
+    _signal_peaks_generate(y, pos, amp, 4);
+    findpeaks(y, &peaks, &conf);
+
+    /* the last peak is below amplitude threshold */
+    ck_assert_int_eq(peaks.total_number, 3);
+    for (index_t j = 0; j < 3; j++)
+    {
+        ck_assert_double_eq_tol(peaks.peak[j].position, pos[j], 1.5);
+
+        /* the same zero-crossing as in the stored derivative */
+        deriv(N_POINTS, y, dy);
+        index_t i = (index_t)peaks.peak[j].position;
+        ck_assert(dy[i] >= 0);
+        ck_assert(dy[i + 1] < 0);
+    }
+
+    /* single peak: position next to the zero-crossing */
+    for (index_t i = 0; i < N_POINTS; i++) y[i] = gaussian(i, 1203.0, 40.0);
+    ck_assert_int_eq(findpeak(N_POINTS, y), 1204);
+}
+DIMMUS_END_TEST
+
+DIMMUS_START_TEST (signal_findpeaks_test_overflow)
+{
+    data_t y[N_POINTS];
+    data_t pos[4] = { 200.0, 600.0, 1000.0, 1400.0 };
+    data_t amp[4] = { 1.0, 1.0, 1.0, 1.0 };
+    Peak peak[2];
+    Peaks peaks = { peak, 0 };
+    Signal_Parameters conf;
+
+    conf.n_points = N_POINTS;
+    conf.search.threshold_amp = 0.35;
+    conf.search.threshold_slope = 0.000001;
+    conf.search.peaks_array_number = 2;
+
+    _signal_peaks_generate(y, pos, amp, 4);
+    findpeaks(y, &peaks, &conf);
+
+    ck_assert_int_eq(peaks.total_number, 2);
+    ck_assert_double_eq_tol(peaks.peak[1].position, 600.0, 1.5);
+}
+DIMMUS_END_TEST
+
+void signal_findpeaks_test(TCase *tc)
+{
+   tcase_add_test(tc, signal_findpeaks_test_positions);
+   tcase_add_test(tc, signal_findpeaks_test_overflow);
+}
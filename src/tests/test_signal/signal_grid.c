@@ -0,0 +1,66 @@
+#include "test_signal.h"
+#include "signal/ensen_signal.h"
+
+/* Reference: nearest value by full scan (the upper index on a tie) */
+static index_t
+_val2ind_scan(const data_t *x, index_t n, data_t val)
+{
+    index_t index = 0;
+    for (index_t i = 1; i < n; i++)
+    {
+        if (fabs(x[i] - val) <= fabs(x[index] - val)) index = i;
+    }
+    return index;
+}
+
+DIMMUS_START_TEST (signal_grid_test_uniform)
+{
+    Grid grid;
+    data_t x[1000];
+
+    grid_uniform_set(&grid, 1500.0, 1600.0, 1000);
+    grid_fill(&grid, x);
+
+    ck_assert_double_eq_tol(x[0], 1500.0, 1.0e-12);
+    ck_assert_double_eq_tol(x[999], 1500.0 + 999 * 0.1, 1.0e-9);
+
+    for (data_t val = 1490.0; val < 1610.0; val += 0.037)
+    {
+        ck_assert_int_eq(grid_val2ind(&grid, val), _val2ind_scan(x, 1000, val));
+    }
+    ck_assert_double_eq_tol(grid_ind2val(&grid, 10.5), 1501.05, 1.0e-9);
+}
+DIMMUS_END_TEST
+
+DIMMUS_START_TEST (signal_grid_test_calibrated)
+{
+    Grid grid;
+    data_t x[500];
+
+    for (index_t i = 0; i < 500; i++)
+    {
+        x[i] = 1500.0 + 0.2 * i + 1.0e-4 * i * i;
+    }
+    grid_calibrated_set(&grid, x, 500);
+
+    for (data_t val = 1490.0; val < 1640.0; val += 0.041)
+    {
+        ck_assert_int_eq(grid_val2ind(&grid, val), _val2ind_scan(x, 500, val));
+        ck_assert_int_eq(val2ind(x, 500, val), _val2ind_scan(x, 500, val));
+    }
+    ck_assert_double_eq_tol(grid_ind2val(&grid, 7), x[7], 1.0e-12);
+    ck_assert_double_eq_tol(grid_ind2val(&grid, 7.25), 0.75 * x[7] + 0.25 * x[8], 1.0e-12);
+    ck_assert_double_eq_tol(grid_ind2val(&grid, 600), x[499], 1.0e-12);
+
+    /* values of an empty grid are not read */
+    grid_calibrated_set(&grid, x, 0);
+    ck_assert_double_eq_tol(grid_ind2val(&grid, 0), 0, 1.0e-12);
+    ck_assert_double_eq_tol(grid_ind2val(&grid, 3), 0, 1.0e-12);
+}
+DIMMUS_END_TEST
+
+void signal_grid_test(TCase *tc)
+{
+   tcase_add_test(tc, signal_grid_test_uniform);
+   tcase_add_test(tc, signal_grid_test_calibrated);
+}
@@ -0,0 +1,76 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "test_signal.h"
+#include "signal/ensen_signal_latency.h"
+
+DIMMUS_START_TEST (signal_latency_test_buckets)
+{
+    /* small values are exact, the others are within one bucket (1/32) */
+    ck_assert_int_eq(latency_bucket(0), 0);
+    ck_assert_int_eq(latency_bucket(63), 63);
+    ck_assert(latency_bucket_value(latency_bucket(63)) == 63);
+    ck_assert_int_eq(latency_bucket((uint64_t)1 << 50), LATENCY_BUCKETS - 1);
+
+    index_t prev = 0;
+    for (uint64_t v = 1; v < ((uint64_t)1 << 39); v = v * 3 / 2 + 1)
+    {
+        const index_t b = latency_bucket(v);
+        const uint64_t high = latency_bucket_value(b);
+        ck_assert(b >= prev);
+        ck_assert(high >= v);
+        ck_assert(high - v <= v / LATENCY_SUB_COUNT);
+        ck_assert(latency_bucket(high) == b);
+        ck_assert(latency_bucket(high + 1) == b + 1);
+        prev = b;
+    }
+}
+DIMMUS_END_TEST
+
+DIMMUS_START_TEST (signal_latency_test_percentile)
+{
+    Latency_Histogram h, g;
+    latency_reset(&h);
+    latency_reset(&g);
+    ck_assert(latency_percentile(&h, 50) == 0);
+
+    /* 1 .. 1000 us */
+    for (uint64_t i = 1; i <= 1000; i++) latency_record(&h, i * 1000);
+    ck_assert(h.count == 1000);
+    ck_assert(h.min == 1000);
+    ck_assert(h.max == 1000000);
+    ck_assert_double_eq_tol(latency_percentile(&h, 50), 500000, 500000.0 / LATENCY_SUB_COUNT);
+    ck_assert_double_eq_tol(latency_percentile(&h, 99), 990000, 990000.0 / LATENCY_SUB_COUNT);
+    ck_assert(latency_percentile(&h, 100) == 1000000);
+
+    /* a tail of the merged histogram */
+    latency_record_sec(&g, 0.5);
+    latency_merge(&h, &g);
+    ck_assert(h.count == 1001);
+    ck_assert(h.max == 500000000);
+    ck_assert(latency_percentile(&h, 99.9) <= 1000000 + 1000000 / LATENCY_SUB_COUNT);
+    ck_assert(latency_percentile(&h, 100) == 500000000);
+
+    /* empty histograms are not printed */
+    char buffer[1024] = { 0 };
+    const char *name[2] = { "stage", "empty" };
+    Latency_Histogram both[2];
+    both[0] = h;
+    latency_reset(&both[1]);
+    FILE *f = tmpfile();
+    ck_assert(f != NULL);
+    latency_print(f, name, both, 2, true);
+    rewind(f);
+    ck_assert(fread(buffer, 1, sizeof(buffer) - 1, f) > 0);
+    fclose(f);
+    ck_assert(strstr(buffer, "\"stage\": { \"count\": 1001") != NULL);
+    ck_assert(strstr(buffer, "\"max\": 500000.000") != NULL);
+    ck_assert(strstr(buffer, "empty") == NULL);
+}
+DIMMUS_END_TEST
+
+void signal_latency_test(TCase *tc)
+{
+    tcase_add_test(tc, signal_latency_test_buckets);
+    tcase_add_test(tc, signal_latency_test_percentile);
+}
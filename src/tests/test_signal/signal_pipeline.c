@@ -0,0 +1,108 @@
+#include "test_signal.h"
+#include "thread/ensen_thread_queue.h"
+#include "thread/ensen_thread_pipeline.h"
+
+#define N_FRAMES 1000
+#define N_BUFFERS 3
+
+typedef struct {
+    uint32_t number;
+    uint32_t value;
+} Test_Frame;
+
+typedef struct {
+    uint32_t expected;  /* next frame number */
+    uint32_t sum;
+    uint32_t stop_at;   /* stop the pipeline at this frame */
+} Test_Output;
+
+static int
+_test_produce(void *frame, uint32_t number, void *data __UNUSED__)
+{
+    Test_Frame *f = frame;
+    f->number = number;
+    f->value = number;
+    return 0;
+}
+
+static int
+_test_process(void *frame, uint32_t number, void *data __UNUSED__)
+{
+    Test_Frame *f = frame;
+    if (f->number != number) return -1;
+    f->value *= 2;
+    return 0;
+}
+
+static int
+_test_consume(void *frame, uint32_t number, void *data)
+{
+    Test_Frame *f = frame;
+    Test_Output *out = data;
+
+    if ((number != out->expected) || (f->number != number) || (number == out->stop_at)) return -1;
+    out->sum += f->value;
+    out->expected++;
+    return 0;
+}
+
+DIMMUS_START_TEST (signal_pipeline_test_queue)
+{
+    Thread_Queue *q = thread_queue_new(3);
+    uint32_t item[4];
+
+    /* capacity is rounded up to 4 */
+    for (uint32_t i = 0; i < 4; i++) ck_assert_int_eq(thread_queue_push(q, &item[i]), 0);
+    ck_assert_int_eq(thread_queue_push(q, &item[0]), -1);
+
+    for (uint32_t i = 0; i < 4; i++) ck_assert_ptr_eq(thread_queue_pop(q), &item[i]);
+    ck_assert_ptr_eq(thread_queue_pop(q), NULL);
+
+    /* counters wrap around the buffer */
+    for (uint32_t i = 0; i < 10; i++)
+    {
+        ck_assert_int_eq(thread_queue_push(q, &item[i % 4]), 0);
+        ck_assert_ptr_eq(thread_queue_pop(q), &item[i % 4]);
+    }
+
+    thread_queue_free(q);
+}
+DIMMUS_END_TEST
+
+DIMMUS_START_TEST (signal_pipeline_test_run)
+{
+    Test_Frame frame[N_BUFFERS];
+    void *frame_ptr[N_BUFFERS] = { &frame[0], &frame[1], &frame[2] };
+    Test_Output out = { 0, 0, UINT32_MAX };
+    const Pipeline_Stage stage[3] = { _test_produce, _test_process, _test_consume };
+    void *const data[3] = { NULL, NULL, &out };
+
+    ck_assert_ptr_eq(pipeline_new(0, stage, data, frame_ptr, N_BUFFERS), NULL);
+
+    Pipeline *pl = pipeline_new(3, stage, data, frame_ptr, N_BUFFERS);
+    ck_assert(pl != NULL);
+
+    /* every frame passes all stages in order */
+    ck_assert_uint_eq(pipeline_run(pl, N_FRAMES), N_FRAMES);
+    ck_assert_uint_eq(out.expected, N_FRAMES);
+    ck_assert_uint_eq(out.sum, N_FRAMES * (N_FRAMES - 1));
+
+    /* a stage stops the pipeline, the next run starts again */
+    out.expected = out.sum = 0;
+    out.stop_at = 10;
+    ck_assert_uint_eq(pipeline_run(pl, N_FRAMES), 10);
+
+    out.expected = out.sum = 0;
+    out.stop_at = UINT32_MAX;
+    ck_assert_uint_eq(pipeline_run(pl, 5), 5);
+    ck_assert_uint_eq(out.sum, 20);
+
+    pipeline_free(pl);
+}
+DIMMUS_END_TEST
+
+void signal_pipeline_test(TCase *tc)
+{
+   tcase_add_test(tc, signal_pipeline_test_queue);
+   tcase_add_test(tc, signal_pipeline_test_run);
+}
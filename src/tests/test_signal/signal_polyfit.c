@@ -0,0 +1,84 @@
+#include "test_signal.h"
+#include "signal/ensen_signal.h"
+
+DIMMUS_START_TEST (signal_polyfit_test_cubic)
+{
+    Polyfit_Workspace ws;
+    data_t x[50], y[50], c[4];
+
+    /* Wavelength-like abscissa: pow(x, k) based normal equations fail here */
+    for (index_t i = 0; i < 50; i++)
+    {
+        x[i] = 1500.0 + 0.1 * i;
+        y[i] = 2.0 - 0.5 * (x[i] - 1502.0) + 0.25 * pow(x[i] - 1502.0, 3);
+    }
+
+    ck_assert_int_eq(polyfit(&ws, x, y, 50, 3), 0);
+    for (index_t i = 0; i < 50; i++)
+    {
+        ck_assert_double_eq_tol(polyfit_eval(&ws, x[i]), y[i], 1.0e-9);
+    }
+
+    polyfit_coefficients(&ws, c);
+    ck_assert_double_eq_tol(c[0] + c[1] * 1502.0 + c[2] * 1502.0 * 1502.0 + c[3] * pow(1502.0, 3), 2.0, 1.0e-3);
+}
+DIMMUS_END_TEST
+
+DIMMUS_START_TEST (signal_polyfit_test_vertex)
+{
+    Polyfit_Workspace ws;
+    data_t x[21], y[21];
+
+    for (index_t i = 0; i < 21; i++)
+    {
+        x[i] = 1520.0 + 0.05 * i;
+        y[i] = 0.8 - 3.0 * (x[i] - 1520.37) * (x[i] - 1520.37);
+    }
+
+    ck_assert_int_eq(polyfit(&ws, x, y, 21, 2), 0);
+    ck_assert_double_eq_tol(polyfit_vertex(&ws), 1520.37, 1.0e-9);
+
+    /* Workspace is reused for another window */
+    ck_assert_int_eq(polyfit(&ws, x + 5, y + 5, 10, 2), 0);
+    ck_assert_double_eq_tol(polyfit_vertex(&ws), 1520.37, 1.0e-9);
+}
+DIMMUS_END_TEST
+
+DIMMUS_START_TEST (signal_polyfit_test_degenerate)
+{
+    Polyfit_Workspace ws;
+    data_t x[3] = { 1.0, 1.0, 1.0 };
+    data_t y[3] = { 1.0, 2.0, 3.0 };
+
+    ck_assert_int_eq(polyfit(&ws, x, y, 3, 1), -1);
+    ck_assert_int_eq(polyfit(&ws, x, y, 2, 2), -1);
+    ck_assert_int_eq(polyfit(&ws, x, y, 3, POLYFIT_ORDER_MAX + 1), -1);
+}
+DIMMUS_END_TEST
+
+DIMMUS_START_TEST (signal_polyfit_test_points)
+{
+    Point p[10];
+
+    for (index_t i = 0; i < 10; i++)
+    {
+        p[i].x = i;
+        p[i].y = 1.0 + 2.0 * i + ((i % 2) ? 0.1 : -0.1);
+    }
+
+    ck_assert_int_eq(signal_fit(&p, 10, 1), 0);
+    for (index_t i = 0; i < 10; i++)
+    {
+        ck_assert_double_eq_tol(p[i].x, i, 1.0e-12);
+        ck_assert_double_eq_tol(p[i].y, 1.0 + 2.0 * i, 0.05);
+    }
+}
+DIMMUS_END_TEST
+
+void signal_polyfit_test(TCase *tc)
+{
+   tcase_add_test(tc, signal_polyfit_test_cubic);
+   tcase_add_test(tc, signal_polyfit_test_vertex);
+   tcase_add_test(tc, signal_polyfit_test_degenerate);
+   tcase_add_test(tc, signal_polyfit_test_points);
+}
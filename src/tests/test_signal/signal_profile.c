@@ -0,0 +1,58 @@
+#include "test_signal.h"
+#include "signal/ensen_benchmark.h"
+
+static volatile data_t sink;
+
+static double
+_profile_work(index_t n)
+{
+    Profile_Mark mark;
+    profile_begin(&mark);
+    data_t sum = 0;
+    for (uint32_t i = 0; i < 1000u * n; i++) sum += 1.0 / (i + 1);
+    sink = sum;
+    return profile_end(&mark, "work");
+}
+
+DIMMUS_START_TEST (signal_profile_test_regions)
+{
+    index_t n = 0;
+
+    /* regions are timed, not kept, before profiling is enabled */
+    ck_assert(_profile_work(1) >= 0);
+    profile_regions(&n);
+    ck_assert_int_eq(n, 0);
+
+    /* counters may be not permitted: regions are timed anyway */
+    const unsigned mask = profile_enable();
+    Profile_Mark outer;
+    profile_begin(&outer);
+    for (index_t k = 1; k <= 3; k++) _profile_work(k);
+    const double time = profile_end(&outer, "outer");
+
+    const Profile_Region *region = profile_regions(&n);
+    ck_assert_int_eq(n, 2);
+    ck_assert_str_eq(region[0].name, "work");
+    ck_assert_str_eq(region[1].name, "outer");
+    ck_assert(region[0].calls == 3);
+    ck_assert(region[1].calls == 1);
+    ck_assert(region[0].time <= region[1].time);
+    ck_assert_double_eq_tol(1e-9 * region[1].time, time, 1e-6);
+
+    if (mask & (1u << PROFILE_INSTRUCTIONS))
+    {
+        ck_assert(region[0].counted == 3);
+        ck_assert(region[0].counter[PROFILE_INSTRUCTIONS] > 6000);
+        ck_assert(region[0].counter[PROFILE_INSTRUCTIONS] <= region[1].counter[PROFILE_INSTRUCTIONS]);
+    }
+    else
+    {
+        ck_assert(region[0].counted == 0);
+    }
+}
+DIMMUS_END_TEST
+
+void signal_profile_test(TCase *tc)
+{
+    tcase_add_test(tc, signal_profile_test_regions);
+}
@@ -0,0 +1,73 @@
+#include <stdio.h>
+#include <unistd.h>
+
+#include "test_signal.h"
+#include "io/ensen_io_publish.h"
+
+#define N_SENSORS 3
+
+static void
+_publish(Publisher *p, uint64_t frame)
+{
+    Publish_Reading *r = publisher_begin(p);
+    for (index_t s = 0; s < N_SENSORS; s++)
+    {
+        r[s].position = 1500.0 + s;
+        r[s].temperature = frame + 0.5 * s;
+        r[s].quality = 1.0;
+    }
+    publisher_commit(p, frame);
+}
+
+DIMMUS_START_TEST (signal_publish_test_ring)
+{
+    char name[64];
+    Publish_Record rec;
+    Publish_Reading reading[N_SENSORS];
+    snprintf(name, sizeof(name), "/ensen_test_%d", (int)getpid());
+
+    /* capacity is rounded up to 4 */
+    Publisher *p = publisher_open(name, N_SENSORS, 3);
+    ck_assert(p != NULL);
+    Publish_Reader *r = publish_reader_open(name);
+    ck_assert(r != NULL);
+    ck_assert_int_eq(publish_reader_sensors(r), N_SENSORS);
+    ck_assert(publish_reader_head(r) == 0);
+    ck_assert_int_eq(publish_read(r, 0, &rec, reading), -1);
+
+    const int64_t start = publish_now();
+    for (uint64_t f = 10; f < 16; f++) _publish(p, f);
+    ck_assert(publish_reader_head(r) == 6);
+
+    /* the last record */
+    ck_assert_int_eq(publish_read(r, 5, &rec, reading), 0);
+    ck_assert(rec.number == 5);
+    ck_assert(rec.frame == 15);
+    ck_assert(rec.timestamp >= start);
+    ck_assert_double_eq_tol(reading[2].temperature, 16.0, 1e-12);
+    ck_assert_double_eq_tol(reading[1].position, 1501.0, 1e-12);
+
+    /* records 0 and 1 are overwritten, 6 is not written */
+    ck_assert_int_eq(publish_read(r, 1, &rec, reading), -1);
+    ck_assert_int_eq(publish_read(r, 2, &rec, reading), 0);
+    ck_assert(rec.frame == 12);
+    ck_assert_int_eq(publish_read(r, 6, &rec, reading), -1);
+
+    /* a record being written is not read, the reader does not wait for it */
+    publisher_begin(p);
+    ck_assert_int_eq(publish_read(r, 6, &rec, reading), -1);
+    ck_assert_int_eq(publish_read(r, 2, &rec, reading), -1);
+    publisher_commit(p, 16);
+    ck_assert_int_eq(publish_read(r, 6, &rec, reading), 0);
+    ck_assert(rec.frame == 16);
+
+    publish_reader_close(r);
+    publisher_close(p, true);
+    ck_assert(publish_reader_open(name) == NULL);
+}
+DIMMUS_END_TEST
+
+void signal_publish_test(TCase *tc)
+{
+    tcase_add_test(tc, signal_publish_test_ring);
+}
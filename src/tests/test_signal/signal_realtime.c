@@ -0,0 +1,37 @@
+#include "test_signal.h"
+#include "thread/ensen_thread_rt.h"
+#include "mem/ensen_mem_guarded.h"
+
+DIMMUS_START_TEST (signal_realtime_test_allocations)
+{
+    /* every allocation is counted, free does not change the counter */
+    const size_t start = MEM_get_memory_allocations();
+    data_t *a = MEM_malloc_arrayN(16, sizeof(data_t), "signal_realtime_test: a");
+    data_t *b = MEM_calloc_arrayN(16, sizeof(data_t), "signal_realtime_test: b");
+    MEM_freeN(a);
+    ck_assert(MEM_get_memory_allocations() - start == 2);
+
+    /* the same work without allocations */
+    const size_t steady = MEM_get_memory_allocations();
+    for (index_t i = 0; i < 16; i++) b[i] = i;
+    ck_assert(MEM_get_memory_allocations() == steady);
+    MEM_freeN(b);
+}
+DIMMUS_END_TEST
+
+DIMMUS_START_TEST (signal_realtime_test_disabled)
+{
+    /* nothing is requested: no privileges are needed */
+    Realtime rt = { 0, 50, 0 };
+    ck_assert_int_eq(realtime_enter(&rt, true), 0);
+    ck_assert_int_eq(realtime_set_priority(0), 0);
+    ck_assert_int_eq(realtime_pin_cpu(-1), 0);
+    realtime_leave(&rt);
+}
+DIMMUS_END_TEST
+
+void signal_realtime_test(TCase *tc)
+{
+   tcase_add_test(tc, signal_realtime_test_allocations);
+   tcase_add_test(tc, signal_realtime_test_disabled);
+}
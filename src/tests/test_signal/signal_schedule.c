@@ -0,0 +1,33 @@
+#include "test_signal.h"
+#include "signal/ensen_benchmark.h"
+#include "thread/ensen_thread_schedule.h"
+
+#define FREQUENCY 1000.0
+#define N_FRAMES 20
+
+DIMMUS_START_TEST (signal_schedule_test_deadline)
+{
+    Schedule s;
+    const double start = get_run_time();
+
+    /* frames start at deadlines: the run takes N_FRAMES periods */
+    schedule_init(&s, FREQUENCY);
+    for (int i = 0; i < N_FRAMES; i++) schedule_wait(&s);
+    ck_assert(get_run_time() - start >= (N_FRAMES - 0.5) / FREQUENCY);
+
+    /* work of five periods: the passed deadlines are counted and skipped */
+    const uint32_t missed = s.missed;
+    const double work = get_run_time();
+    while (get_run_time() - work < 5.0 / FREQUENCY) {}
+    ck_assert_int_eq(schedule_wait(&s), -1);
+    ck_assert(s.missed - missed >= 4);
+
+    ck_assert(schedule_jitter(&s) >= 0);
+    ck_assert(s.jitter_max >= 0);
+}
+DIMMUS_END_TEST
+
+void signal_schedule_test(TCase *tc)
+{
+   tcase_add_test(tc, signal_schedule_test_deadline);
+}
@@ -0,0 +1,101 @@
+#include "test_signal.h"
+#include "signal/ensen_signal.h"
+
+#define N_SENSORS 40
+#define N_FRAMES 8
+#define CAPACITY 5
+
+DIMMUS_START_TEST (signal_sensor_test_ring)
+{
+    Ring r;
+    data_t out[CAPACITY];
+
+    ck_assert_int_eq(ring_init(&r, 0), -1);
+    ck_assert_int_eq(ring_init(&r, CAPACITY), 0);
+
+    ring_push(&r, 1);
+    ring_push(&r, 2);
+    ck_assert_int_eq(ring_copy(&r, out), 2);
+    ck_assert_double_eq_tol(out[0], 1, 1e-12);
+    ck_assert_double_eq_tol(ring_last(&r), 2, 1e-12);
+
+    /* wrapped: the last CAPACITY values in order of arrival */
+    for (index_t i = 3; i <= 12; i++) ring_push(&r, i);
+    ck_assert_int_eq(ring_length(&r), CAPACITY);
+    ck_assert_int_eq(ring_copy(&r, out), CAPACITY);
+    for (index_t i = 0; i < CAPACITY; i++) ck_assert_double_eq_tol(out[i], 8 + i, 1e-12);
+    ck_assert_double_eq_tol(ring_last(&r), 12, 1e-12);
+    ck_assert_uint_eq(r.count, 12);
+
+    ring_free(&r);
+}
+DIMMUS_END_TEST
+
+DIMMUS_START_TEST (signal_sensor_test_bank)
+{
+    Sensor_Bank bank;
+    Grid grid;
+    Peak peak[N_SENSORS];
+    Peaks p = { peak, N_SENSORS };
+    data_t out[CAPACITY];
+    data_t deviation[N_FRAMES - 1];
+
+    ck_assert_int_eq(sensor_bank_init(&bank, 0, CAPACITY, 20), -1);
+    ck_assert_int_eq(sensor_bank_init(&bank, N_SENSORS, CAPACITY, 20), 0);
+
+    /* one point of grid is 0.5, one degree shifts peak by 0.25 */
+    grid_uniform_set(&grid, 0, 2000, 4000);
+
+    for (index_t f = 0; f < N_FRAMES; f++)
+    {
+        for (index_t s = 0; s < N_SENSORS; s++)
+        {
+            /* sensor s is heated by s degrees per frame */
+            peak[s].position = 100 * s + 0.5 * s * f;
+        }
+        /* the last sensor is lost in the last frame: it keeps its temperature */
+        p.total_number = (f == N_FRAMES - 1) ? N_SENSORS - 1 : N_SENSORS;
+        sensor_bank_update(&bank, &p, &grid, 0.25);
+
+        /* reference is heated by 3 degrees per frame */
+        if (f > 0)
+        {
+            sensor_bank_deviation(&bank, 20 + 3 * f);
+            deviation[f - 1] = bank.temperature[N_SENSORS/2] - (20 + 3 * f);
+        }
+    }
+
+    for (index_t s = 0; s < N_SENSORS - 1; s++)
+    {
+        ck_assert_double_eq_tol(bank.temperature[s], 20 + s * (N_FRAMES - 1), 1e-9);
+
+        /* only the last CAPACITY frames are kept */
+        Ring history = sensor_bank_history(&bank, s);
+        ck_assert_int_eq(ring_copy(&history, out), CAPACITY);
+        for (index_t k = 0; k < CAPACITY; k++)
+        {
+            ck_assert_double_eq_tol(out[k], 20 + s * (N_FRAMES - CAPACITY + k), 1e-9);
+        }
+    }
+    ck_assert_double_eq_tol(bank.temperature[N_SENSORS - 1], 20 + (N_SENSORS - 1) * (N_FRAMES - 2), 1e-9);
+
+    /* online deviation statistics equal the statistics of the whole series */
+    Stats dev;
+    stats_reduce(deviation, N_FRAMES - 1, &dev);
+    ck_assert_uint_eq(bank.dev_count, N_FRAMES - 1);
+    ck_assert_double_eq_tol(bank.dev_mean[N_SENSORS/2], dev.mean, 1e-9);
+    ck_assert_double_eq_tol(sensor_bank_deviation_variance(&bank, N_SENSORS/2), dev.variance, 1e-9);
+    ck_assert_double_eq_tol(bank.dev_min[N_SENSORS/2], dev.min, 1e-9);
+    ck_assert_double_eq_tol(bank.dev_max[N_SENSORS/2], dev.max, 1e-9);
+    ck_assert_double_eq_tol(bank.dev_abs_min[N_SENSORS/2], dev.abs_min, 1e-9);
+
+    sensor_bank_free(&bank);
+    ck_assert_ptr_eq(bank.position, NULL);
+}
+DIMMUS_END_TEST
+
+void signal_sensor_test(TCase *tc)
+{
+   tcase_add_test(tc, signal_sensor_test_ring);
+   tcase_add_test(tc, signal_sensor_test_bank);
+}
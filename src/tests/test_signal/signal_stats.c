@@ -0,0 +1,88 @@
+#include "test_signal.h"
+#include "signal/ensen_signal.h"
+#include "math/random/ensen_math_random.h"
+
+#define N_NOISE 20000
+
+DIMMUS_START_TEST (signal_stats_test_reduce)
+{
+    data_t x[101], copy[101];
+    Stats s;
+
+    for (index_t n = 1; n <= 101; n += 25)
+    {
+        data_t ref_sum = 0, ref_sq = 0;
+        for (index_t i = 0; i < n; i++)
+        {
+            x[i] = copy[i] = 1500.0 + sin(0.37 * i) - ((i == n / 2) ? 1600.0 : 0.0);
+            ref_sum += x[i];
+        }
+        for (index_t i = 0; i < n; i++) ref_sq += (x[i] - ref_sum / n) * (x[i] - ref_sum / n);
+
+        stats_reduce(x, n, &s);
+
+        ck_assert_double_eq_tol(s.min, min(x, n), 1.0e-12);
+        ck_assert_double_eq_tol(s.max, max(x, n), 1.0e-12);
+        ck_assert_double_eq_tol(s.abs_min, min_abs(x, n), 1.0e-12);
+        ck_assert_double_eq_tol(s.abs_max, max_abs(x, n), 1.0e-12);
+        ck_assert_double_eq_tol(s.sum, sum(x, n), 1.0e-9);
+        ck_assert_double_eq_tol(s.sum, ref_sum, 1.0e-9);
+        ck_assert_double_eq_tol(s.mean, ref_sum / n, 1.0e-9);
+        ck_assert_double_eq_tol(s.variance, ref_sq / n, 1.0e-6);
+        ck_assert_int_eq(s.argmin, n / 2);
+        ck_assert_double_eq_tol(x[s.argmax], s.max, 1.0e-12);
+
+        /* input is not modified */
+        ck_assert_int_eq(memcmp(x, copy, sizeof(data_t) * n), 0);
+    }
+}
+DIMMUS_END_TEST
+
+DIMMUS_START_TEST (signal_stats_test_ties)
+{
+    data_t x[9] = { 3.0, -1.0, 5.0, -1.0, 5.0, 2.0, -1.0, 5.0, 0.5 };
+    Stats s;
+
+    stats_reduce(x, 9, &s);
+    ck_assert_int_eq(s.argmin, 1);
+    ck_assert_int_eq(s.argmax, 2);
+    ck_assert_double_eq_tol(s.abs_min, 0.5, 1.0e-12);
+}
+DIMMUS_END_TEST
+
+DIMMUS_START_TEST (signal_stats_test_noise)
+{
+    static data_t y[N_NOISE], w[N_NOISE + 1], scratch[N_NOISE];
+    Random_Stream rs;
+    random_stream_init(&rs, 3, 0);
+    for (index_t i = 0; i <= N_NOISE; i++) w[i] = 0.1 * random_stream_normal(&rs);
+
+    /* white noise under two peaks: the peaks are skipped, the estimate does not depend on scale */
+    for (index_t i = 0; i < N_NOISE; i++)
+    {
+        y[i] = w[i] + exp(-0.5 * pow((i - 5000.0) / 300.0, 2)) + 0.8 * exp(-0.5 * pow((i - 12000.0) / 300.0, 2));
+    }
+    ck_assert_double_eq_tol(stats_noise(y, N_NOISE, 1, 0.5, scratch), 0.1, 0.005);
+    ck_assert_double_eq_tol(stats_noise(y, N_NOISE, 16, 0.5, scratch), 0.1, 0.01);
+
+    /* violet noise (difference of white) is removed by smoothing, brown (sum) is not */
+    for (index_t i = 0; i < N_NOISE; i++) y[i] = w[i + 1] - w[i];
+    const data_t violet = stats_noise(y, N_NOISE, 16, 0.5, scratch);
+    ck_assert(violet < 0.5 * stats_noise(y, N_NOISE, 1, 0.5, scratch));
+    ck_assert(violet < 0.05);
+
+    y[0] = w[0];
+    for (index_t i = 1; i < N_NOISE; i++) y[i] = y[i - 1] + w[i];
+    ck_assert(stats_noise(y, N_NOISE, 16, INFINITY, scratch) > 2 * stats_noise(y, N_NOISE, 1, INFINITY, scratch));
+
+    /* less than two blocks */
+    ck_assert(stats_noise(y, 15, 8, INFINITY, scratch) < 1e-300);
+}
+DIMMUS_END_TEST
+
+void signal_stats_test(TCase *tc)
+{
+   tcase_add_test(tc, signal_stats_test_reduce);
+   tcase_add_test(tc, signal_stats_test_ties);
+   tcase_add_test(tc, signal_stats_test_noise);
+}
@@ -0,0 +1,63 @@
+#include "test_signal.h"
+#include "signal/ensen_signal.h"
+
+#define N_POINTS 3000
+
+DIMMUS_START_TEST (signal_stream_test_batch)
+{
+    data_t y[N_POINTS + 1], raw[N_POINTS + 1];
+    Peak peak_batch[10], peak_stream[10];
+    Peaks batch = { peak_batch, 0 }, stream = { peak_stream, 0 };
+    Signal_Parameters conf;
+
+    conf.n_points = N_POINTS;
+    conf.smooth.width = 40;
+    conf.smooth.level = 3;
+    conf.search.threshold_amp = 0.35;
+    conf.search.threshold_slope = 0.000001;
+    conf.search.peaks_array_number = 10;
+
+    for (index_t i = 0; i <= N_POINTS; i++)
+    {
+        raw[i] = gaussian(i, 500.3, 60.0) + 0.8 * gaussian(i, 1200.0, 60.0) + 0.6 * gaussian(i, 2100.7, 60.0)
+               + 0.05 * sin(1.3 * i);
+        y[i] = raw[i];
+    }
+
+    for (index_t l = 0; l < conf.smooth.level; l++) smooth(y, N_POINTS, conf.smooth.width);
+    findpeaks(y, &batch, &conf);
+    ck_assert_int_eq(batch.total_number, 3);
+
+    /* the same frame by chunks of different sizes */
+    Peak_Stream *ps = peak_stream_new(&conf);
+    index_t chunks[5] = { 1, 7, 64, 1000, N_POINTS };
+    for (index_t c = 0; c < 5; c++)
+    {
+        stream.total_number = 0;
+        peak_stream_reset(ps);
+        for (index_t offset = 0; offset < N_POINTS; offset += chunks[c])
+        {
+            index_t n = (N_POINTS - offset < chunks[c]) ? N_POINTS - offset : chunks[c];
+            index_t found = peak_stream_push(ps, raw + offset, n, &stream);
+
+            /* peak is reported once its neighbourhood has been pushed */
+            for (index_t j = stream.total_number - found; j < stream.total_number; j++)
+            {
+                ck_assert(stream.peak[j].position + peak_stream_latency(ps) <= offset + n);
+            }
+        }
+
+        ck_assert_int_eq(stream.total_number, batch.total_number);
+        for (index_t j = 0; j < batch.total_number; j++)
+        {
+            ck_assert_double_eq_tol(stream.peak[j].position, batch.peak[j].position, 0.5);
+        }
+    }
+    peak_stream_free(ps);
+}
+DIMMUS_END_TEST
+
+void signal_stream_test(TCase *tc)
+{
+   tcase_add_test(tc, signal_stream_test_batch);
+}
@@ -0,0 +1,91 @@
+#include "test_signal.h"
+#include "signal/ensen_signal.h"
+
+#define N_FRAMES 400
+
+/* Reproducible uniform noise in [-amplitude, amplitude] */
+static data_t
+_signal_noise(uint32_t *state, data_t amplitude)
+{
+    *state = *state * 1664525u + 1013904223u;
+    return amplitude * (2.0 * (*state >> 8) / (1u << 24) - 1.0);
+}
+
+DIMMUS_START_TEST (signal_tracker_test_drift)
+{
+    Tracker t;
+    uint32_t state = 3;
+    data_t err_raw = 0, err_filtered = 0;
+
+    tracker_init(&t, 0.0001, 3.0, 5.0);
+
+    /* slow drift measured with noise: filtered error is lower */
+    for (uint32_t f = 0; f < N_FRAMES; f++)
+    {
+        const data_t truth = 1000.0 + 0.25 * f;
+        const data_t measurement = truth + _signal_noise(&state, 3.0);
+        data_t from, to;
+
+        tracker_predict(&t);
+        tracker_window(&t, &from, &to);
+        ck_assert(from <= truth);
+        ck_assert(to >= truth);
+        ck_assert_int_eq(tracker_update(&t, measurement), 0);
+
+        if (f >= N_FRAMES/2)
+        {
+            err_raw += fabs(measurement - truth);
+            err_filtered += fabs(t.position - truth);
+        }
+    }
+    ck_assert(err_filtered < 0.5 * err_raw);
+    ck_assert_double_eq_tol(t.velocity, 0.25, 0.05);
+
+    /* outlier is rejected, the jump is accepted after TRACKER_MISSES_MAX frames */
+    const data_t position = t.position;
+    tracker_predict(&t);
+    ck_assert_int_eq(tracker_update(&t, position + 500), -1);
+    ck_assert_double_eq_tol(t.position, position + 0.25, 0.05);
+    tracker_predict(&t);
+    ck_assert_int_eq(tracker_update(&t, position + 500), -1);
+    tracker_predict(&t);
+    ck_assert_int_eq(tracker_update(&t, position + 500), 0);
+    ck_assert_double_eq_tol(t.position, position + 500, 1e-9);
+}
+DIMMUS_END_TEST
+
+DIMMUS_START_TEST (signal_tracker_test_peaks)
+{
+    Tracker t[2];
+    Peak peak[4];
+    Peaks p = { peak, 2 };
+    data_t y[200];
+
+    tracker_init(&t[0], 0.01, 1.0, 5.0);
+    tracker_init(&t[1], 0.01, 1.0, 5.0);
+    for (index_t i = 0; i < 200; i++) y[i] = -(i - 60.3) * (i - 60.3);
+
+    peak[0].position = 60;
+    peak[1].position = 150;
+    tracker_peaks(t, 2, &p, y, 200, 5);
+
+    /* sub-sample refinement of the first peak */
+    ck_assert_double_eq_tol(p.peak[0].position, 60.3, 1e-9);
+    ck_assert_double_eq_tol(p.peak[1].position, 150, 1e-9);
+
+    /* spurious peak between sensors is not taken */
+    p.total_number = 3;
+    peak[0].position = 100;
+    peak[1].position = 60;
+    peak[2].position = 151;
+    tracker_peaks(t, 2, &p, y, 200, 0);
+    ck_assert_double_eq_tol(p.peak[0].position, 60.3, 0.5);
+    ck_assert_double_eq_tol(p.peak[1].position, 151, 1.0);
+}
+DIMMUS_END_TEST
+
+void signal_tracker_test(TCase *tc)
+{
+   tcase_add_test(tc, signal_tracker_test_drift);
+   tcase_add_test(tc, signal_tracker_test_peaks);
+}
@@ -0,0 +1,132 @@
+#include "test_signal.h"
+#include "signal/ensen_signal.h"
+#include "math/random/ensen_math_random.h"
+
+#define N_POINTS 200
+
+DIMMUS_START_TEST (signal_view_test_slice)
+{
+    data_t x[N_POINTS];
+    Point p[N_POINTS];
+
+    for (index_t i = 0; i < N_POINTS; i++)
+    {
+        x[i] = 1500.0 + 0.5 * i;
+        p[i].x = x[i];
+        p[i].y = i;
+    }
+
+    View v = view_slice(view_array(x, N_POINTS), 10, 20);
+    ck_assert_int_eq(v.length, 20);
+    ck_assert_ptr_eq(view_ptr(v, 0), &x[10]);
+    ck_assert_int_eq(view_val2ind(v, 1510.2), 10);
+
+    /* clipped by the end of array */
+    ck_assert_int_eq(view_slice(view_array(x, N_POINTS), 190, 20).length, 10);
+
+    /* the window of AoS points refers to the original array */
+    Points_View pv = points_view_window(points_view_aos(&p, N_POINTS), 1550.0, 10.0);
+    ck_assert_int_eq(pv.x.length, 20);
+    ck_assert_ptr_eq(view_ptr(pv.x, 0), &p[90].x);
+    ck_assert_ptr_eq(view_ptr(pv.y, 19), &p[109].y);
+
+    /* the fit is written through the view */
+    ck_assert_int_eq(signal_fit_view(pv, 1), 0);
+    ck_assert_double_eq_tol(p[100].y, 100.0, 1e-9);
+}
+DIMMUS_END_TEST
+
+DIMMUS_START_TEST (signal_view_test_kernels)
+{
+    data_t y[N_POINTS], ys[N_POINTS], dy[N_POINTS];
+    Point p[N_POINTS];
+    data_t out[N_POINTS];
+    Stats s, sv;
+
+    for (index_t i = 0; i < N_POINTS; i++)
+    {
+        y[i] = ys[i] = sin(0.1 * i) + 0.01 * i;
+        p[i].x = i;
+        p[i].y = y[i];
+    }
+    Points_View pv = points_view_aos(&p, N_POINTS);
+
+    /* strided kernels are the same as contiguous ones */
+    smooth(ys, N_POINTS, 10);
+    smooth_view(view_array(out, N_POINTS), pv.y, 10);
+    ck_assert_int_eq(memcmp(out, ys, sizeof(ys)), 0);
+
+    deriv(N_POINTS, y, dy);
+    deriv_view(view_array(out, N_POINTS), pv.y);
+    ck_assert_int_eq(memcmp(out, dy, sizeof(dy)), 0);
+
+    stats_reduce(y + 50, 100, &s);
+    stats_reduce_view(view_slice(pv.y, 50, 100), &sv);
+    ck_assert_int_eq(s.argmax, sv.argmax);
+    ck_assert_int_eq(s.argmin, sv.argmin);
+    ck_assert_double_eq_tol(s.sum, sv.sum, 1e-12);
+    ck_assert_double_eq_tol(s.variance, sv.variance, 1e-12);
+}
+DIMMUS_END_TEST
+
+DIMMUS_START_TEST (signal_view_test_lanes)
+{
+    /* more lanes than a group, so the second group is partial (and odd, for the scalar lane) */
+    enum { n_lanes = SMOOTH_LANES_GROUP + 5 };
+    data_t y[N_POINTS], ys[N_POINTS];
+    data_t in[N_POINTS * n_lanes], out[N_POINTS * n_lanes];
+
+    for (index_t i = 0; i < N_POINTS; i++)
+    {
+        for (index_t l = 0; l < n_lanes; l++) in[i * n_lanes + l] = sin(0.1 * i + l) + 0.01 * l * i;
+    }
+    in[7 * n_lanes + 3] = NAN;
+    in[9 * n_lanes + n_lanes - 1] = NAN;
+
+    smooth_lanes(out, in, N_POINTS, n_lanes, 10);
+    for (index_t l = 0; l < n_lanes; l++)
+    {
+        for (index_t i = 0; i < N_POINTS; i++) y[i] = in[i * n_lanes + l];
+        smooth_view(view_array(ys, N_POINTS), view_array(y, N_POINTS), 10);
+        for (index_t i = 0; i < N_POINTS; i++) ck_assert_double_eq_tol(out[i * n_lanes + l], ys[i], 1e-15);
+    }
+}
+DIMMUS_END_TEST
+
+DIMMUS_START_TEST (signal_view_test_derivative_gain)
+{
+    data_t variance;
+
+    /* central difference of white noise, and of one pass: two spikes of 1 / (2 w) */
+    ck_assert_double_eq_tol(smooth_derivative_gain(10, 0, &variance), sqrt(0.5), 1e-12);
+    ck_assert_double_eq_tol(variance, 0, 1e-12);
+    ck_assert_double_eq_tol(smooth_derivative_gain(1, 3, &variance), sqrt(0.5), 1e-12);
+    ck_assert_double_eq_tol(smooth_derivative_gain(10, 1, &variance), 0.1, 1e-12);
+    ck_assert_double_eq_tol(variance, 99.0 / 12, 1e-12);
+
+    /* the noise of the derivative of smoothed white noise */
+    enum { n = 20000 };
+    static data_t x[n], y[n], dy[n];
+    Random_Stream rs;
+    random_stream_init(&rs, 5, 0);
+    for (index_t i = 0; i < n; i++) x[i] = random_stream_normal(&rs);
+    smooth_view(view_array(y, n), view_array(x, n), 10);
+    smooth_view(view_array(x, n), view_array(y, n), 10);
+    deriv(n, x, dy);
+
+    data_t sq = 0;
+    for (index_t i = 100; i < n - 100; i++) sq += dy[i] * dy[i];
+    const data_t gain = smooth_derivative_gain(10, 2, &variance);
+    ck_assert(gain < 0.1);
+    ck_assert_double_eq_tol(sqrt(sq / (n - 200)), gain, 0.05 * gain);
+    ck_assert_double_eq_tol(variance, 2 * 99.0 / 12, 1e-12);
+}
+DIMMUS_END_TEST
+
+void signal_view_test(TCase *tc)
+{
+   tcase_add_test(tc, signal_view_test_slice);
+   tcase_add_test(tc, signal_view_test_kernels);
+   tcase_add_test(tc, signal_view_test_lanes);
+   tcase_add_test(tc, signal_view_test_derivative_gain);
+}
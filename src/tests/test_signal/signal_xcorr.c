@@ -0,0 +1,64 @@
+#include "test_signal.h"
+#include "signal/ensen_signal.h"
+
+#define N_POINTS 3000
+
+/* Reproducible uniform noise in [-amplitude, amplitude] */
+static data_t
+_signal_noise(uint32_t *state, data_t amplitude)
+{
+    *state = *state * 1664525u + 1013904223u;
+    return amplitude * (2.0 * (*state >> 8) / (1u << 24) - 1.0);
+}
+
+static void
+_signal_frame(data_t *y, const data_t *pos, data_t amp, data_t shift, uint32_t *state)
+{
+    for (index_t i = 0; i < N_POINTS; i++)
+    {
+        y[i] = 0.05 + _signal_noise(state, 0.02);
+        for (index_t j = 0; j < 2; j++) y[i] += amp * gaussian(i, pos[j] + shift, 150.0);
+    }
+}
+
+DIMMUS_START_TEST (signal_xcorr_test_shift)
+{
+    data_t y[N_POINTS];
+    data_t pos[2] = { 800.0, 2000.0 };
+    uint32_t state = 7;
+    Peak peak[2];
+    Peaks peaks = { peak, 2 };
+
+    Xcorr_Tracker *tr = xcorr_tracker_new(512, 256, 2);
+    ck_assert_ptr_nonnull(tr);
+
+    _signal_frame(y, pos, 1.0, 0, &state);
+    peak[0].position = 801;
+    peak[1].position = 1998;
+    ck_assert_int_eq(xcorr_tracker_start(tr, y, N_POINTS, &peaks), 0);
+
+    /* sub-sample shifts, the amplitude change does not matter */
+    data_t shift[3] = { 37.3, 120.6, -55.25 };
+    for (index_t f = 0; f < 3; f++)
+    {
+        _signal_frame(y, pos, 0.7, shift[f], &state);
+        xcorr_track(tr, y, N_POINTS, &peaks);
+
+        ck_assert_int_eq(peaks.total_number, 2);
+        ck_assert_double_eq_tol(xcorr_shift(tr, 0), shift[f], 0.5);
+        ck_assert_double_eq_tol(xcorr_shift(tr, 1), shift[f], 0.5);
+        ck_assert_double_eq_tol(peaks.peak[1].position, 1998 + xcorr_shift(tr, 1), 1e-9);
+    }
+
+    /* not enough peaks for sensors */
+    peaks.total_number = 1;
+    ck_assert_int_eq(xcorr_tracker_start(tr, y, N_POINTS, &peaks), -1);
+
+    xcorr_tracker_free(tr);
+}
+DIMMUS_END_TEST
+
+void signal_xcorr_test(TCase *tc)
+{
+   tcase_add_test(tc, signal_xcorr_test_shift);
+}
@@ -0,0 +1,44 @@
+#include "test_signal.h"
+
+static const Dimmus_Test_Case etc[] = {
+  { "Polynomial fit", signal_polyfit_test },
+  { "Grid", signal_grid_test },
+  { "Statistics", signal_stats_test },
+  { "Peak search", signal_findpeaks_test },
+  { "Online peak search", signal_stream_test },
+  { "Wavelet peak search", signal_cwt_test },
+  { "Cross-correlation tracker", signal_xcorr_test },
+  { "Views", signal_view_test },
+  { "Batch peak search", signal_batch_test },
+  { "Tracker", signal_tracker_test },
+  { "Sensor bank", signal_sensor_test },
+  { "Calibration", signal_calib_test },
+  { "Pipeline", signal_pipeline_test },
+  { "Schedule", signal_schedule_test },
+  { "Realtime", signal_realtime_test },
+  { "Capture", signal_capture_test },
+  { "Publish", signal_publish_test },
+  { "Latency", signal_latency_test },
+  { "Profile", signal_profile_test },
+  { NULL, NULL }
+};
+
+SUITE_INIT(ensen) {
+}
+
+SUITE_SHUTDOWN(ensen) {
+}
+
+int
+main(int argc, char **argv)
+{
+   int failed_count;
+
+   if (!_dimmus_test_option_disp(argc, argv, etc))
+     return 0;
+
+   failed_count = _dimmus_suite_build_and_run(argc - 1, (const char **)argv + 1,
+                                           "Signal", etc, SUITE_INIT_FN(ensen), SUITE_SHUTDOWN_FN(ensen));
+
+   return (failed_count == 0) ? 0 : 255;
+}
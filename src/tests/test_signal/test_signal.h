@@ -0,0 +1,26 @@
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "../check_common.h"
+#include "ensen_private.h"
+
+void signal_polyfit_test(TCase *tc);
+void signal_grid_test(TCase *tc);
+void signal_stats_test(TCase *tc);
+void signal_findpeaks_test(TCase *tc);
+void signal_stream_test(TCase *tc);
+void signal_cwt_test(TCase *tc);
+void signal_xcorr_test(TCase *tc);
+void signal_view_test(TCase *tc);
+void signal_batch_test(TCase *tc);
+void signal_tracker_test(TCase *tc);
+void signal_sensor_test(TCase *tc);
+void signal_calib_test(TCase *tc);
+void signal_pipeline_test(TCase *tc);
+void signal_schedule_test(TCase *tc);
+void signal_realtime_test(TCase *tc);
+void signal_capture_test(TCase *tc);
+void signal_publish_test(TCase *tc);
+void signal_latency_test(TCase *tc);
+void signal_profile_test(TCase *tc);